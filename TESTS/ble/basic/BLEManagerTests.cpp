@@ -66,6 +66,25 @@ void TestBLEManagerAdvertising() {
     TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.deinit(), "BLE deinit failed");
 }
 
+void TestBLEManagerInitTiming() {
+    char k[48], v[128];
+    BLEConfig config("T1MING");
+
+    BLEManager &bleManager = BLEManager::getInstance();
+    printf("timing::BLEManager[%p]\r\n", &bleManager);
+
+    // boot to advertising: init returns when the stack is up and advertising started
+    Timer timer;
+    timer.start();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+    int elapsed = timer.read_us();
+    printf("init::boot-to-advertising %d us\r\n", elapsed);
+
+    greentea_send_kv("discover", config.deviceName);
+    greentea_parse_kv(k, v, sizeof(k), sizeof(v));
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(config.deviceName, v, "BLE device discovery failed");
+    TEST_ASSERT_TRUE_MESSAGE(elapsed < BLE_MANAGER_INIT_TIMEOUT * 1000, "BLE initialization too slow");
+}
 
 void TestBLEManagerOnCallbacks() {
     char k[48], v[128];
@@ -129,6 +148,8 @@ int main() {
                  case_teardown_handler, greentea_failure_handler),
             Case("Test ble-on-callbacks", TestBLEManagerOnCallbacks,
                  case_teardown_handler, greentea_failure_handler),
+            Case("Test ble-init-timing", TestBLEManagerInitTiming,
+                 case_teardown_handler, greentea_failure_handler),
     };
 
     Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
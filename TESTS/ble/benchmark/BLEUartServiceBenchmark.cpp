@@ -0,0 +1,266 @@
+/*!
+ * @file
+ * @brief Throughput and latency benchmark for the BLE UART Service
+ *
+ * The host test connects for every run and writes all results, its own
+ * and the ones reported by the device, to benchmark.csv.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <sdk_common.h>
+#include <mbed_stats.h>
+#include <BLEManager.h>
+#include <services/BLEUartService.h>
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "../testhelper.h"
+
+using namespace utest::v1;
+
+#define DEVICE_NAME "C0NNECTME"
+
+// bytes transferred per throughput run
+#define BENCHMARK_TOTAL (16 * 1024)
+// request/response rounds per latency run
+#define BENCHMARK_ROUNDS 200
+
+static const BLEConfig::ConnectionProfile profiles[] = {
+        BLEConfig::PROFILE_BULK, BLEConfig::PROFILE_LOW_LATENCY, BLEConfig::PROFILE_LOW_POWER
+};
+static const char *const profileNames[] = {"bulk", "lowlatency", "lowpower"};
+static const uint16_t bufferSizes[] = {128, 1024};
+
+static uint8_t message[1024];
+
+class BLEConfigOnConnection : public BLEConfig {
+
+public:
+    bool isConnected;
+
+    explicit BLEConfigOnConnection(const char *name = DEVICE_NAME) : BLEConfig(name), isConnected(false) {
+        dataLength = BLE_MAX_DATA_LENGTH;
+        preferredPhys = ble::phy_set_t(ble::phy_set_t::PHY_SET_1M | ble::phy_set_t::PHY_SET_2M);
+    }
+
+    void onConnection(const Gap::ConnectionCallbackParams_t *params) {
+        isConnected = true;
+    }
+
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params) {
+        isConnected = false;
+    }
+};
+
+/*
+ * Measures the CPU load between start() and stop(), needs MBED_CPU_STATS_ENABLED.
+ */
+class CpuLoad {
+public:
+    void start() {
+#if MBED_CPU_STATS_ENABLED
+        mbed_stats_cpu_get(&begin);
+#endif
+    }
+
+    /** the CPU load in percent since start(), -1 if CPU stats are disabled */
+    float stop() {
+#if MBED_CPU_STATS_ENABLED
+        mbed_stats_cpu_t end;
+        mbed_stats_cpu_get(&end);
+        uint64_t uptime = end.uptime - begin.uptime;
+        uint64_t idle = end.idle_time - begin.idle_time;
+        return uptime ? 100.0f - 100.0f * idle / uptime : 0.0f;
+#else
+        return -1.0f;
+#endif
+    }
+
+private:
+#if MBED_CPU_STATS_ENABLED
+    mbed_stats_cpu_t begin;
+#endif
+};
+
+static void report(const char *name, const char *metric, float value, const char *unit) {
+    char v[128];
+    snprintf(v, sizeof(v), "%s.%s,%.2f,%s", name, metric, value, unit);
+    greentea_send_kv("result", v);
+}
+
+void TestBLEUartServiceBenchmarkSend() {
+    char k[48], v[128], name[64];
+    memset(message, 'x', sizeof(message));
+
+    for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        for (size_t b = 0; b < sizeof(bufferSizes) / sizeof(bufferSizes[0]); b++) {
+            uint16_t size = bufferSizes[b];
+            BLEManager &bleManager = BLEManager::getInstance();
+            BLEConfigOnConnection config = BLEConfigOnConnection();
+            config.connectionProfile = profiles[p];
+
+            TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager init failed");
+            BLEUartService *uartService = new BLEUartService(BLE::Instance(), 128, size);
+
+            // the host connects, subscribes and counts what arrives
+            snprintf(name, sizeof(name), "uart.tx.%s.buf%u", profileNames[p], size);
+            snprintf(v, sizeof(v), "%s,%s,%u", DEVICE_NAME, name, BENCHMARK_TOTAL);
+            greentea_send_kv("receive", v);
+            greentea_parse_kv(k, v, sizeof(k), sizeof(v));
+            TEST_ASSERT_EQUAL_STRING_MESSAGE("subscribed", k, "wrong response key received");
+
+            CpuLoad cpu;
+            Timer timer;
+            cpu.start();
+            timer.start();
+            for (int sent = 0; sent < BENCHMARK_TOTAL; sent += size) {
+                TEST_ASSERT_EQUAL_INT_MESSAGE(size, uartService->send(message, size), "could not send all data");
+            }
+            float load = cpu.stop();
+
+            // the transfer is done when the host has it all
+            greentea_parse_kv(k, v, sizeof(k), sizeof(v));
+            timer.stop();
+            TEST_ASSERT_EQUAL_STRING_MESSAGE("received", k, "wrong response key received");
+
+            report(name, "throughput", BENCHMARK_TOTAL / timer.read() / 1024, "KiB/s");
+            if (load >= 0) report(name, "cpu", load, "%");
+
+            // we need to wait until we are fully disconnected or the host test will stall
+            while (config.isConnected) Thread::wait(100);
+
+            bleManager.deinit();
+            delete uartService;
+        }
+    }
+}
+
+void TestBLEUartServiceBenchmarkReceive() {
+    char k[48], v[128], name[64];
+
+    for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        for (size_t b = 0; b < sizeof(bufferSizes) / sizeof(bufferSizes[0]); b++) {
+            uint16_t size = bufferSizes[b];
+            BLEManager &bleManager = BLEManager::getInstance();
+            BLEConfigOnConnection config = BLEConfigOnConnection();
+            config.connectionProfile = profiles[p];
+
+            TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager init failed");
+            BLEUartService *uartService = new BLEUartService(BLE::Instance(), size, 128);
+
+            // the host connects and writes as fast as the link allows
+            snprintf(name, sizeof(name), "uart.rx.%s.buf%u", profileNames[p], size);
+            snprintf(v, sizeof(v), "%s,%s,%u", DEVICE_NAME, name, BENCHMARK_TOTAL);
+            greentea_send_kv("send", v);
+
+            // measure from the first byte, not the connection setup
+            TEST_ASSERT_TRUE_MESSAGE(uartService->waitReadable(20000), "no data received");
+            CpuLoad cpu;
+            Timer timer;
+            cpu.start();
+            timer.start();
+            int received = 0;
+            while (received < BENCHMARK_TOTAL) {
+                int n = uartService->read(message, sizeof(message), 5000);
+                TEST_ASSERT_TRUE_MESSAGE(n > 0, "service did not receive all data");
+                received += n;
+            }
+            timer.stop();
+            float load = cpu.stop();
+
+            report(name, "throughput", received / timer.read() / 1024, "KiB/s");
+            if (load >= 0) report(name, "cpu", load, "%");
+
+            while (config.isConnected) Thread::wait(100);
+
+            bleManager.deinit();
+            delete uartService;
+        }
+    }
+}
+
+void TestBLEUartServiceBenchmarkRoundTrip() {
+    const uint8_t sizes[] = {1, 20, 128};
+    char v[128];
+
+    for (size_t p = 0; p < sizeof(profiles) / sizeof(profiles[0]); p++) {
+        for (size_t s = 0; s < sizeof(sizes); s++) {
+            BLEManager &bleManager = BLEManager::getInstance();
+            BLEConfigOnConnection config = BLEConfigOnConnection();
+            config.connectionProfile = profiles[p];
+
+            TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager init failed");
+            BLEUartService *uartService = new BLEUartService(BLE::Instance(), 256, 256);
+
+            // the host writes a request and times until the echo arrives, it computes the percentiles
+            snprintf(v, sizeof(v), "%s,uart.rtt.%s.size%u,%u,%u", DEVICE_NAME, profileNames[p], sizes[s],
+                     BENCHMARK_ROUNDS, sizes[s]);
+            greentea_send_kv("echo", v);
+
+            int echoed = 0;
+            while (echoed < BENCHMARK_ROUNDS * sizes[s]) {
+                int n = uartService->read(message, sizeof(message), 20000);
+                TEST_ASSERT_TRUE_MESSAGE(n > 0, "no request received");
+                TEST_ASSERT_EQUAL_INT_MESSAGE(n, uartService->send(message, n), "could not send echo");
+                echoed += n;
+            }
+
+            while (config.isConnected) Thread::wait(100);
+
+            bleManager.deinit();
+            delete uartService;
+        }
+    }
+}
+
+utest::v1::status_t case_teardown_handler(const Case *const source, const size_t passed, const size_t failed,
+                                          const failure_t reason) { // NOLINT
+    printf("BLEManager::getInstance().deinit()\r\n");
+    BLEManager::getInstance().deinit();
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) { // NOLINT
+    return greentea_case_failure_abort_handler(source, reason);
+}
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(600, "BLEUartServiceBenchmark");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+int main() {
+    bleClockInit();
+
+    Case cases[] = {
+            Case("Benchmark ble-uart-send", TestBLEUartServiceBenchmarkSend,
+                 case_teardown_handler, greentea_failure_handler),
+            Case("Benchmark ble-uart-receive", TestBLEUartServiceBenchmarkReceive,
+                 case_teardown_handler, greentea_failure_handler),
+            Case("Benchmark ble-uart-round-trip", TestBLEUartServiceBenchmarkRoundTrip,
+                 case_teardown_handler, greentea_failure_handler),
+    };
+
+    Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+    return !Harness::run(specification);
+}
@@ -0,0 +1,117 @@
+/*!
+ * @file
+ * @brief Test for the heap-free GATT service templates on the device stack.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <sdk_common.h>
+#include <BLEManager.h>
+#include <BLEStaticService.h>
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "../testhelper.h"
+
+using namespace utest::v1;
+
+// a battery service, declared completely at compile time
+static BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
+                               GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY, 1> batteryLevel(0x2A19, 1);
+static BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
+                               GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE, 8> batteryLabel(0x2A1A);
+static BLEStaticService<2> batteryService(0x180F);
+
+void TestBLEStaticServiceAdd() {
+    uint8_t value[8];
+    uint16_t length = sizeof(value);
+    BLE &ble = BLE::Instance();
+
+    BLEConfig config("STATIC");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config),
+                                  "BLE manager initialization failed");
+
+    batteryLevel.value[0] = 42;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, batteryService.add(batteryLevel).add(batteryLabel).addTo(ble),
+                                  "service not added");
+    TEST_ASSERT_TRUE_MESSAGE(batteryLevel.getValueHandle() != GattAttribute::INVALID_HANDLE, "level handle not set");
+    TEST_ASSERT_TRUE_MESSAGE(batteryLabel.getValueHandle() != GattAttribute::INVALID_HANDLE, "label handle not set");
+
+    // the initial value is taken from the characteristic
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, ble.gattServer().read(batteryLevel.getValueHandle(), value, &length),
+                                  "level not readable");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, length, "wrong level length");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(42, value[0], "wrong initial level");
+
+    // the value can grow up to the size of the buffer
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, ble.gattServer().write(
+            batteryLabel.getValueHandle(), reinterpret_cast<const uint8_t *>("internal"), 8), "label not writable");
+    length = sizeof(value);
+    ble.gattServer().read(batteryLabel.getValueHandle(), value, &length);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, length, "wrong label length");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE("internal", value, 8, "wrong label");
+}
+
+void TestBLEStaticServiceIncomplete() {
+    BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ, 4> counter(0x2A1B);
+    BLEStaticService<2> service(0x181F);
+
+    BLEConfig config("STATIC");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config),
+                                  "BLE manager initialization failed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_STATE, service.add(counter).addTo(BLE::Instance()),
+                                  "incomplete service added");
+    TEST_ASSERT_TRUE_MESSAGE(counter.getValueHandle() == GattAttribute::INVALID_HANDLE,
+                             "incomplete service registered");
+}
+
+utest::v1::status_t case_teardown_handler(const Case *const source, const size_t passed, const size_t failed,
+                                          const failure_t reason) {
+    printf("BLEManager::getInstance().deinit()\r\n");
+    BLEManager::getInstance().deinit();
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(60, "default_auto");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+int main() {
+    bleClockInit();
+
+    Case cases[] = {
+            Case("Test ble-static-service-add", TestBLEStaticServiceAdd,
+                 case_teardown_handler, greentea_failure_handler),
+            Case("Test ble-static-service-incomplete", TestBLEStaticServiceIncomplete,
+                 case_teardown_handler, greentea_failure_handler),
+    };
+
+    Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+    return !Harness::run(specification);
+}
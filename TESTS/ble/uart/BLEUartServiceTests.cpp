@@ -91,7 +91,7 @@ void TestBLEUartServiceReceiveData() {
     TEST_ASSERT_EQUAL_STRING_MESSAGE("expect", k, "wrong response key received");
 
     // wait for data to come in
-    while (!uartService->isReadable()) /* wait */;
+    TEST_ASSERT_TRUE_MESSAGE(uartService->waitReadable(10000), "no data received");
 
     // now read all the data and send it back
     int i = 0;
@@ -0,0 +1,169 @@
+#! /usr/bin/env python
+"""
+Footprint regression check
+
+Collects the footprint of the tests-footprint-* apps and compares it with
+the committed baseline (baseline.csv, suite,metric,value,tolerance). A
+metric fails if it grew by more than its tolerance in bytes, if it is not
+in the baseline (NEW) or if it was not measured (MISSING). Without any
+baseline the check is skipped.
+
+- flash and static RAM from the ELF files of the build (arm-none-eabi-size)
+- heap and stack high-water from the mbedgt memory metrics (testmem.csv),
+  the apps are built with MBED_HEAP_STATS_ENABLED and MBED_STACK_STATS_ENABLED
+
+Run with --update to write the measured values as the new baseline, e.g.
+after an intended change or for a new app, and commit the file.
+"""
+from __future__ import print_function
+
+import argparse
+import csv
+import json
+import os
+import subprocess
+import sys
+
+BASELINE = os.path.join(os.path.dirname(os.path.abspath(__file__)), "baseline.csv")
+
+# metrics taken from testmem.csv, the column names end with them
+MEMORY_METRICS = {
+    "max_heap_usage": "heap",
+    "max_stack_usage": "stack_thread_max",
+    "max_stack_usage_total": "stack_total",
+}
+
+# the default growth allowed, in bytes
+TOLERANCE = {
+    "flash": 256,
+    "static_ram": 32,
+    "heap": 64,
+    "stack_thread_max": 64,
+    "stack_total": 128,
+}
+
+
+def read_memory_metrics(path, prefix):
+    """
+    Parse the single row CSV of mbedgt, the columns are named
+    <target>_<suite>_<metric>.
+    """
+    results = {}
+    with open(path) as f:
+        rows = list(csv.reader(f))
+    if len(rows) < 2:
+        return results
+    for column, value in zip(rows[0], rows[1]):
+        for metric in sorted(MEMORY_METRICS, key=len, reverse=True):
+            if not column.endswith("_" + metric):
+                continue
+            start = column.find("_" + prefix)
+            if start < 0:
+                break
+            suite = column[start + 1:-len(metric) - 1]
+            results[(suite, MEMORY_METRICS[metric])] = int(value)
+            break
+    return results
+
+
+def read_elf_sizes(spec, prefix, size_tool):
+    """
+    Find the ELF of every app through the test_spec.json of the build and
+    read its sections, flash is text + data, static RAM is data + bss.
+    """
+    results = {}
+    with open(spec) as f:
+        builds = json.load(f)["builds"]
+    for build in builds.values():
+        for suite, test in build["tests"].items():
+            if not suite.startswith(prefix):
+                continue
+            for binary in test["binaries"]:
+                elf = os.path.splitext(binary["path"])[0] + ".elf"
+                if not os.path.exists(elf):
+                    continue
+                output = subprocess.check_output([size_tool, elf]).decode("ascii")
+                text, data, bss = [int(x) for x in output.splitlines()[1].split()[:3]]
+                results[(suite, "flash")] = text + data
+                results[(suite, "static_ram")] = data + bss
+    return results
+
+
+def read_baseline(path):
+    baseline = {}
+    if os.path.exists(path):
+        with open(path) as f:
+            for row in csv.DictReader(f):
+                baseline[(row["suite"], row["metric"])] = (int(row["value"]), int(row["tolerance"]))
+    return baseline
+
+
+def write_baseline(path, measured, baseline):
+    with open(path, "w") as f:
+        writer = csv.writer(f, lineterminator="\n")
+        writer.writerow(["suite", "metric", "value", "tolerance"])
+        for key in sorted(measured):
+            # keep tolerances adjusted by hand
+            tolerance = baseline[key][1] if key in baseline else TOLERANCE[key[1]]
+            writer.writerow([key[0], key[1], measured[key], tolerance])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare the footprint of the apps with the baseline")
+    parser.add_argument("--metrics", default="testmem.csv", help="memory metrics CSV of mbedgt")
+    parser.add_argument("--spec", default="BUILD/tests/NRF52_DK/GCC_ARM/test_spec.json",
+                        help="test_spec.json of the test build")
+    parser.add_argument("--baseline", default=BASELINE, help="the baseline CSV")
+    parser.add_argument("--prefix", default="tests-footprint", help="the test suites to check")
+    parser.add_argument("--size", default="arm-none-eabi-size", help="the size tool of the toolchain")
+    parser.add_argument("--update", action="store_true", help="write the measured values as the baseline")
+    args = parser.parse_args()
+
+    measured = {}
+    if os.path.exists(args.spec):
+        measured.update(read_elf_sizes(args.spec, args.prefix, args.size))
+    if os.path.exists(args.metrics):
+        measured.update(read_memory_metrics(args.metrics, args.prefix))
+    if not measured:
+        print("no footprint measured, run the %s tests first" % args.prefix)
+        return 1
+
+    baseline = read_baseline(args.baseline)
+    if not baseline and not args.update:
+        # nothing to compare with is not a regression, the check starts once a baseline is committed
+        print("skipped: no baseline recorded in %s, record it with --update" % args.baseline)
+        return 0
+    if args.update:
+        write_baseline(args.baseline, measured, baseline)
+        print("baseline updated: %s" % args.baseline)
+        return 0
+
+    failed = 0
+    print("%-28s %-18s %10s %10s %8s  %s" % ("suite", "metric", "value", "baseline", "delta", "result"))
+    for key in sorted(set(measured) | set(baseline)):
+        value = measured.get(key)
+        if value is None:
+            print("%-28s %-18s %10s %10d %8s  MISSING, update the baseline" %
+                  (key[0], key[1], "-", baseline[key][0], "-"))
+            failed += 1
+            continue
+        if key not in baseline:
+            print("%-28s %-18s %10d %10s %8s  NEW, update the baseline" % (key[0], key[1], value, "-", "-"))
+            failed += 1
+            continue
+        reference, tolerance = baseline[key]
+        delta = value - reference
+        if delta > tolerance:
+            result = "FAIL (> +%d)" % tolerance
+            failed += 1
+        elif delta < -tolerance:
+            result = "OK, smaller, update the baseline"
+        else:
+            result = "OK"
+        print("%-28s %-18s %10d %10d %+8d  %s" % (key[0], key[1], value, reference, delta, result))
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
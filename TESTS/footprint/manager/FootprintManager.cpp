@@ -0,0 +1,41 @@
+/*!
+ * @file
+ * @brief Footprint app: BLE manager only, advertising
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <sdk_common.h>
+#include <BLEManager.h>
+
+#include "greentea-client/test_env.h"
+#include "../../ble/testhelper.h"
+
+int main() {
+    GREENTEA_SETUP(60, "default_auto");
+    bleClockInit();
+
+    bool initialized = BLEManager::getInstance().init("F00TPRINT") == BLE_ERROR_NONE;
+    // let the event thread handle the advertising events before the stacks are measured
+    Thread::wait(1000);
+
+    GREENTEA_TESTSUITE_RESULT(initialized);
+}
@@ -0,0 +1,55 @@
+/*!
+ * @file
+ * @brief Footprint app: BLE manager with the security manager
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <sdk_common.h>
+#include <SecurityManager.h>
+#include <BLEManager.h>
+
+#include "greentea-client/test_env.h"
+#include "../../ble/testhelper.h"
+
+class BLEConfigSecured : public BLEConfig {
+public:
+    explicit BLEConfigSecured(const char *name) : BLEConfig(name) {}
+
+    ble_error_t onInit(BLE &ble) {
+        SecurityManager::Passkey_t passkey = {'0', '1', '0', '1', '0', '1'};
+        ble_error_t error = ble.securityManager().init(true, true, SecurityManager::IO_CAPS_DISPLAY_ONLY, passkey);
+        if (error != BLE_ERROR_NONE) return error;
+
+        return BLEConfig::onInit(ble);
+    }
+};
+
+int main() {
+    GREENTEA_SETUP(60, "default_auto");
+    bleClockInit();
+
+    static BLEConfigSecured config("F00TPRINT");
+    bool initialized = BLEManager::getInstance().init(&config) == BLE_ERROR_NONE;
+    Thread::wait(1000);
+
+    GREENTEA_TESTSUITE_RESULT(initialized);
+}
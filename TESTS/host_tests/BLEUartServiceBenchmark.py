@@ -0,0 +1,172 @@
+import csv
+import time
+
+from mbed_host_tests import BaseHostTest, event_callback
+from pyble import CentralManager
+from pyble.handlers import PeripheralHandler, DefaultProfileHandler
+
+RESULTS = "benchmark.csv"
+
+# bytes notified on the UART RX characteristic, counted by the profile handler
+notified = {"bytes": 0, "first": None, "last": None}
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p / 100.0))]
+
+
+class BLEUartServiceBenchmark(BaseHostTest):
+    """
+    BLE UART Service Benchmark
+
+    Measure throughput in both directions and the request/response
+    round trip time. The results of the host and the device go to
+    benchmark.csv as name,value,unit.
+    """
+
+    def __init__(self):
+        self.log("** " + str(self))
+        self.cm = CentralManager()
+        BaseHostTest.__init__(self)
+
+    def setup(self):
+        self.results = open(RESULTS, "wb")
+        self.writer = csv.writer(self.results)
+        self.writer.writerow(["name", "value", "unit"])
+
+    def teardown(self):
+        self.results.close()
+
+    def report(self, name, value, unit):
+        self.log("** [B] %s %.2f %s" % (name, value, unit))
+        self.writer.writerow([name, "%.2f" % value, unit])
+        self.results.flush()
+
+    def discoverDevice(self, name):
+        self.log("** [U] discoverDevice(" + name + ")")
+        if not self.cm.ready:
+            return
+        self.cm.startScan(timeout=20)
+        for target in self.cm.scanedList:
+            if target and target.name == name:
+                return target
+        raise Exception("NO DEVICE FOUND")
+
+    def connect(self, name):
+        self.device = self.discoverDevice(name)
+        self.device.delegate = Peripheral
+        return self.cm.connectPeripheral(self.device)
+
+    @event_callback("result")
+    def __result(self, key, value, timestamp):
+        name, value, unit = value.split(",")
+        self.report(name, float(value), unit)
+
+    @event_callback("receive")
+    def __receive(self, key, value, timestamp):
+        name, benchmark, total = value.split(",")
+        total = int(total)
+        self.log("** [U] " + key + "(" + name + ")")
+
+        peripheral = self.connect(name)
+        notified.update(bytes=0, first=None, last=None)
+        c = peripheral["UART Profile"]["UART RX"]
+        c.notify = True
+        self.send_kv("subscribed", benchmark)
+
+        deadline = time.time() + 120
+        while notified["bytes"] < total and time.time() < deadline:
+            self.cm.loop(0.1)
+        self.send_kv("received", notified["bytes"])
+
+        # from the first to the last notification, without the connection setup
+        if notified["bytes"] >= total and notified["last"] > notified["first"]:
+            self.report(benchmark + ".link_throughput",
+                        notified["bytes"] / (notified["last"] - notified["first"]) / 1024, "KiB/s")
+
+        self.cm.disconnectPeripheral(self.device)
+
+    @event_callback("send")
+    def __send(self, key, value, timestamp):
+        name, benchmark, total = value.split(",")
+        total = int(total)
+        self.log("** [U] " + key + "(" + name + ")")
+
+        peripheral = self.connect(name)
+        c = peripheral["UART Profile"]["UART TX"]
+
+        # a single ATT write carries at most 20 bytes with the default MTU
+        chunk = bytearray("x" * 20)
+        start = time.time()
+        for written in range(0, total, len(chunk)):
+            c.value = chunk
+        elapsed = time.time() - start
+        self.report(benchmark + ".host_throughput", total / elapsed / 1024, "KiB/s")
+
+        self.cm.disconnectPeripheral(self.device)
+
+    @event_callback("echo")
+    def __echo(self, key, value, timestamp):
+        name, benchmark, rounds, size = value.split(",")
+        rounds, size = int(rounds), int(size)
+        self.log("** [U] " + key + "(" + name + ")")
+
+        peripheral = self.connect(name)
+        rx = peripheral["UART Profile"]["UART RX"]
+        rx.notify = True
+        tx = peripheral["UART Profile"]["UART TX"]
+
+        request = bytearray("r" * size)
+        rtt = []
+        for i in range(rounds):
+            expected = notified["bytes"] + size
+            start = time.time()
+            tx.value = request
+            deadline = start + 10
+            while notified["bytes"] < expected and time.time() < deadline:
+                self.cm.loop(0.001)
+            if notified["bytes"] < expected:
+                break
+            rtt.append((time.time() - start) * 1000)
+
+        if rtt:
+            for p in (50, 90, 99):
+                self.report("%s.p%d" % (benchmark, p), percentile(rtt, p), "ms")
+            self.report(benchmark + ".max", max(rtt), "ms")
+
+        self.cm.disconnectPeripheral(self.device)
+
+
+class GenericProfileHandler(DefaultProfileHandler):
+    UUID = "6E400001-B5A3-F393-E0A9-E50E24DCCA9E"
+    _AUTOLOAD = True
+    names = {
+        "6E400001-B5A3-F393-E0A9-E50E24DCCA9E": "UART Profile",
+        "6E400002-B5A3-F393-E0A9-E50E24DCCA9E": "UART TX",
+        "6E400003-B5A3-F393-E0A9-E50E24DCCA9E": "UART RX"
+    }
+
+    def initialize(self):
+        pass
+
+    def on_notify(self, characteristic, data):
+        now = time.time()
+        if notified["first"] is None:
+            notified["first"] = now
+        notified["last"] = now
+        notified["bytes"] += len(data)
+
+
+class Peripheral(PeripheralHandler):
+    def initialize(self):
+        self.addProfileHandler(GenericProfileHandler)
+        pass
+
+    def on_connect(self):
+        print "** connect(", self.peripheral, ")"
+        pass
+
+    def on_disconnect(self):
+        print "** disconnect(", self.peripheral, ")"
+        pass
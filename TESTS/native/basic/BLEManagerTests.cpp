@@ -0,0 +1,565 @@
+/*!
+ * @file
+ * @brief Native test for the BLE manager using the simulated stack
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <BLEManager.h>
+#include <BLESim.h>
+#include <services/BLEStatsService.h>
+
+#include "nativetest.h"
+
+void TestBLEManagerSingleton() {
+    BLEManager &i1 = BLEManager::getInstance();
+    BLEManager &i2 = BLEManager::getInstance();
+    printf("singleton::BLEManager[%p] == BLEManager[%p]\r\n", &i1, &i2);
+
+    TEST_ASSERT_EQUAL_PTR_MESSAGE(&i1, &i2, "singleton instances are not the same");
+}
+
+void TestBLEManagerInit() {
+    BLEConfig config;
+    BLEManager &bleManager = BLEManager::getInstance();
+    printf("init::BLEManager[%p]\r\n", &bleManager);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isInitialized(), "BLE manager not initialized");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.deinit(), "BLE deinit failed");
+    TEST_ASSERT_FALSE_MESSAGE(bleManager.isInitialized(), "BLE manager still initialized");
+}
+
+void TestBLEManagerAdvertising() {
+    BLEConfig config("0123456789ABCDEF");
+
+    BLEManager &bleManager = BLEManager::getInstance();
+    printf("advertising::BLEManager[%p]\r\n", &bleManager);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+    TEST_ASSERT_TRUE_MESSAGE(BLESim::getInstance().discover(config.deviceName), "BLE device discovery failed");
+    TEST_ASSERT_FALSE_MESSAGE(BLESim::getInstance().discover("UNKNOWN"), "BLE device discovered with wrong name");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.deinit(), "BLE deinit failed");
+    TEST_ASSERT_FALSE_MESSAGE(BLESim::getInstance().discover(config.deviceName), "BLE device still advertising");
+}
+
+void TestBLEManagerOnCallbacks() {
+    class BLEConfigOnConnection : public BLEConfig {
+    public:
+        volatile int connections;
+        volatile int disconnections;
+
+        explicit BLEConfigOnConnection(const char *name)
+                : BLEConfig(name), connections(0), disconnections(0) {};
+
+        void onConnection(const Gap::ConnectionCallbackParams_t *params) {
+            connections++;
+        }
+
+        void onDisconnection(const Gap::DisconnectionCallbackParams_t *params) {
+            disconnections++;
+            BLEConfig::onDisconnection(params);
+        }
+    };
+    BLEConfigOnConnection config("C0NNECTME");
+    BLESim &sim = BLESim::getInstance();
+
+    BLEManager &bleManager = BLEManager::getInstance();
+    printf("onConnection::BLEManager[%p]\r\n", &bleManager);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection event not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, config.connections, "connection callback not called");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isConnected(), "manager not connected");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.disconnect(connection), "disconnect failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "disconnection event not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, config.disconnections, "disconnection callback not called");
+    TEST_ASSERT_FALSE_MESSAGE(bleManager.isConnected(), "manager still connected");
+
+    // the default configuration restarts advertising after a disconnect
+    TEST_ASSERT_TRUE_MESSAGE(sim.discover(config.deviceName), "not advertising after disconnect");
+}
+
+static volatile int initCalls = 0;
+static volatile ble_error_t initResult = BLE_ERROR_UNSPECIFIED;
+
+static void onInitDone(ble_error_t error) {
+    initResult = error;
+    initCalls++;
+}
+
+void TestBLEManagerInitAsync() {
+    BLEConfig config("ASYNCINIT");
+    BLEManager &bleManager = BLEManager::getInstance();
+    printf("initAsync::BLEManager[%p]\r\n", &bleManager);
+
+    initCalls = 0;
+    initResult = BLE_ERROR_UNSPECIFIED;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.initAsync(&config, onInitDone), "BLE init not started");
+    for (int i = 0; i < 100 && !initCalls; i++) Thread::wait(10);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, initCalls, "init callback not called");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, initResult, "BLE manager initialization failed");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isInitialized(), "BLE manager not initialized");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_ALREADY_INITIALIZED, bleManager.initAsync(&config, onInitDone),
+                                  "BLE initialized twice");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_ALREADY_INITIALIZED, bleManager.init(&config), "BLE initialized twice");
+}
+
+void TestBLEManagerInitTimeout() {
+    BLESim &sim = BLESim::getInstance();
+    BLEConfig config("T1MEOUT");
+    BLEManager &bleManager = BLEManager::getInstance();
+    printf("initTimeout::BLEManager[%p]\r\n", &bleManager);
+
+    // the stack does not come up in time
+    sim.setInitDeferred(true);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INTERNAL_STACK_FAILURE, bleManager.init(&config, 100),
+                                  "BLE init did not time out");
+    TEST_ASSERT_FALSE_MESSAGE(bleManager.isInitialized(), "BLE manager initialized after timeout");
+
+    // the late completion must not bring up the abandoned initialization
+    TEST_ASSERT_TRUE_MESSAGE(sim.completeInit(), "no init completion held back");
+    TEST_ASSERT_FALSE_MESSAGE(bleManager.isInitialized(), "BLE manager initialized by late completion");
+    TEST_ASSERT_FALSE_MESSAGE(sim.discover(config.deviceName), "BLE device advertising after timeout");
+
+    // and the next attempt works
+    sim.setInitDeferred(false);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE init after timeout failed");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isInitialized(), "BLE manager not initialized");
+    TEST_ASSERT_TRUE_MESSAGE(sim.discover(config.deviceName), "BLE device not advertising");
+}
+
+void TestBLEManagerInitTiming() {
+    BLEConfig config("TIMING");
+    BLEManager &bleManager = BLEManager::getInstance();
+
+    // boot to advertising: from calling init until a scanner can discover the device
+    Timer timer;
+    timer.start();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+    while (!BLESim::getInstance().discover(config.deviceName) && timer.read_ms() < 1000) Thread::yield();
+    int elapsed = timer.read_us();
+
+    printf("init::boot-to-advertising %d us\r\n", elapsed);
+    TEST_ASSERT_TRUE_MESSAGE(BLESim::getInstance().discover(config.deviceName), "device not advertising");
+}
+
+void TestBLEManagerMultipleConnections() {
+    BLEConfig config("MULTI", 10, 0, 3);
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+    Gap::Handle_t connections[3], handles[4];
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+
+    // advertising continues until the configured number of peers is connected
+    Gap::ConnectionParams_t params = {12, 24, 2, 400};
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(sim.discover(config.deviceName), "not advertising");
+        connections[i] = sim.connect(i == 1 ? &params : NULL);
+        TEST_ASSERT_TRUE_MESSAGE(connections[i] != BLESim::INVALID_CONNECTION, "connection failed");
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection event not processed");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(i + 1, bleManager.getConnectionCount(), "connection not tracked");
+    }
+    TEST_ASSERT_FALSE_MESSAGE(sim.discover(config.deviceName), "still advertising with all peers connected");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, bleManager.getConnections(handles, 4), "wrong number of connections");
+
+    BLEManager::ConnectionInfo info;
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.getConnection(connections[1], &info), "connection unknown");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(connections[1], info.handle, "wrong connection handle");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(12, info.params.minConnectionInterval, "connection parameters not tracked");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, info.params.slaveLatency, "connection parameters not tracked");
+
+    // each connection has its own ATT MTU
+    sim.exchangeMtu(connections[2], 185);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "MTU exchange not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(185, bleManager.getAttMtu(connections[2]), "MTU not tracked");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_DEFAULT_ATT_MTU, bleManager.getAttMtu(connections[0]), "MTU changed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.disconnect(connections[0]), "disconnect failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "disconnection event not processed");
+    TEST_ASSERT_FALSE_MESSAGE(bleManager.isConnected(connections[0]), "connection still tracked");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isConnected(connections[1]), "other connection lost");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isConnected(), "manager not connected");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, bleManager.getConnectionCount(), "wrong number of connections");
+    TEST_ASSERT_TRUE_MESSAGE(sim.discover(config.deviceName), "not advertising after disconnect");
+}
+
+// mean discovery latency of a number of simulated scans in ms
+static double scanLatency(const char *name, uint16_t scanInterval, uint16_t scanWindow) {
+    uint32_t sum = 0;
+    for (int i = 0; i < 500; i++) {
+        uint32_t latency = BLESim::getInstance().scan(name, scanInterval, scanWindow);
+        TEST_ASSERT_TRUE_MESSAGE(latency != BLESim::NOT_FOUND, "device not found");
+        sum += latency;
+    }
+    return sum / 500.0;
+}
+
+void TestBLEManagerAdvertisingPhases() {
+    BLEConfig config("PHASES", 1000);
+    config.fastAdvertisingInterval = 30;
+    config.fastAdvertisingTimeout = 30;
+    config.nameInScanResponse = true;
+    BLESim &sim = BLESim::getInstance();
+    Gap &gap = BLE::Instance().gap();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+
+    // the name is only in the scan response
+    TEST_ASSERT_TRUE_MESSAGE(gap.getAdvertisingPayload().findField(GapAdvertisingData::COMPLETE_LOCAL_NAME) == NULL,
+                             "name in advertising packet");
+    TEST_ASSERT_TRUE_MESSAGE(sim.discover(config.deviceName), "name not in scan response");
+
+    // fast after boot, until the fast phase times out
+    TEST_ASSERT_EQUAL_INT_MESSAGE(30, gap.getAdvertisingParams().getInterval(), "not advertising fast");
+    double fast = scanLatency(config.deviceName, 100, 100);
+    double fastDutyCycled = scanLatency(config.deviceName, 300, 30);
+    sim.elapse(29000);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "events not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(30, gap.getAdvertisingParams().getInterval(), "fast phase ended early");
+    sim.elapse(1000);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "timeout not processed");
+
+    // slow afterwards, without timeout
+    TEST_ASSERT_TRUE_MESSAGE(sim.discover(config.deviceName), "not advertising after the fast phase");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1000, gap.getAdvertisingParams().getInterval(), "not advertising slowly");
+    double slow = scanLatency(config.deviceName, 100, 100);
+    double slowDutyCycled = scanLatency(config.deviceName, 300, 30);
+    sim.elapse(3600000);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "events not processed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.discover(config.deviceName), "slow phase timed out");
+
+    printf("discovery latency (continuous scan):  fast %.1fms, slow %.1fms\r\n", fast, slow);
+    printf("discovery latency (10%% duty cycle):   fast %.1fms, slow %.1fms\r\n", fastDutyCycled, slowDutyCycled);
+    // on average half an interval plus half the advertising delay
+    TEST_ASSERT_TRUE_MESSAGE(fast > 10 && fast < 30, "unexpected fast discovery latency");
+    TEST_ASSERT_TRUE_MESSAGE(slow > 400 && slow < 600, "unexpected slow discovery latency");
+    TEST_ASSERT_TRUE_MESSAGE(fastDutyCycled < slowDutyCycled, "fast advertising not found faster");
+
+    // a connection stops advertising, a disconnect restarts the fast phase
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLESim::NOT_FOUND, sim.scan(config.deviceName), "advertising while connected");
+    sim.disconnect(connection);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "disconnection not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(30, gap.getAdvertisingParams().getInterval(), "not advertising fast again");
+}
+
+void TestBLEManagerConnectionProfiles() {
+    BLEConfig config("PROFILES", 10, 0, 2);
+    config.connectionProfile = BLEConfig::PROFILE_LOW_POWER;
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+    BLEManager::ConnectionInfo info;
+    Gap::ConnectionParams_t params;
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_STATE, bleManager.setConnectionProfile(BLEConfig::PROFILE_BULK),
+                                  "profile set without initialization");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+    BLE::Instance().gap().getPreferredConnectionParams(&params);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(80, params.minConnectionInterval, "preferred parameters not set");
+
+    // the configured profile is requested when a peer connects
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection not processed");
+    params = sim.getConnectionParams(connection);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(80, params.minConnectionInterval, "low power interval not applied");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(4, params.slaveLatency, "low power latency not applied");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(600, params.connectionSupervisionTimeout, "low power timeout not applied");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.getConnection(connection, &info), "connection unknown");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLEConfig::PROFILE_LOW_POWER, info.profile, "wrong profile");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(24, info.params.minConnectionInterval, "central parameters not kept");
+
+    // switch to bulk for a transfer and back
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setConnectionProfile(connection, BLEConfig::PROFILE_BULK),
+                                  "bulk profile not requested");
+    params = sim.getConnectionParams(connection);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(12, params.minConnectionInterval, "bulk interval not applied");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, params.slaveLatency, "bulk latency not applied");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setConnectionProfile(BLEConfig::PROFILE_CENTRAL),
+                                  "central parameters not requested");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(24, sim.getConnectionParams(connection).minConnectionInterval,
+                                  "central parameters not restored");
+
+    // a central that can not go as fast ignores the request
+    sim.setCentralMinInterval(24);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE,
+                                  bleManager.setConnectionProfile(connection, BLEConfig::PROFILE_LOW_LATENCY),
+                                  "low latency profile not requested");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(24, sim.getConnectionParams(connection).minConnectionInterval,
+                                  "unsupported interval applied");
+
+    // the last profile set for all connections applies to new peers
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setConnectionProfile(BLEConfig::PROFILE_BULK),
+                                  "bulk profile not requested");
+    Gap::Handle_t second = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection not processed");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.getConnection(second, &info), "connection unknown");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLEConfig::PROFILE_BULK, info.profile, "wrong profile for new peer");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(24, sim.getConnectionParams(second).minConnectionInterval, "bulk not applied");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_PARAM,
+                                  bleManager.setConnectionProfile(0x77, BLEConfig::PROFILE_BULK),
+                                  "unknown connection accepted");
+}
+
+void TestBLEManagerLinkUpdate() {
+    BLEConfig config("LINKUPDATE", 10, 0, 2);
+    config.dataLength = 251;
+    config.preferredPhys = ble::phy_set_t(true, true, false);
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+    BLEManager::ConnectionInfo info;
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+
+    // a central supporting both gets the extension and 2M right after connecting
+    Gap::Handle_t connection = sim.connect();
+    sim.exchangeMtu(connection, BLESim::MAX_ATT_MTU);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(251, sim.getDataLength(connection), "data length not requested");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ble::phy_t::LE_2M, sim.getPhy(connection).value(), "2M PHY not requested");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.getConnection(connection, &info), "connection unknown");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(251, info.dataLength, "data length not tracked");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ble::phy_t::LE_2M, info.phy, "PHY not tracked");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(244, bleManager.getMaxPayload(connection), "payload does not use the MTU");
+
+    // a central supporting neither refuses, the link stays at 27 octets on 1M
+    sim.setCentralLinkFeatures(27, false);
+    Gap::Handle_t legacy = sim.connect();
+    sim.exchangeMtu(legacy, BLESim::MAX_ATT_MTU);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ble::phy_t::LE_1M, sim.getPhy(legacy).value(), "PHY changed");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.getConnection(legacy, &info), "connection unknown");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(27, info.dataLength, "data length changed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(ble::phy_t::LE_1M, info.phy, "refused PHY tracked");
+
+    // 244 bytes would need 10 link layer packets, the last one nearly empty, 236 fill 9 of them
+    TEST_ASSERT_EQUAL_INT_MESSAGE(236, bleManager.getMaxPayload(legacy), "payload does not fill the packets");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(236, bleManager.getMaxPayload(), "shared payload not the smallest");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(20, bleManager.getMaxPayload(0x77), "payload of unknown connection");
+}
+
+void TestBLEManagerEventQueueStats() {
+    class BLEConfigSlowConnection : public BLEConfig {
+    public:
+        explicit BLEConfigSlowConnection(const char *name) : BLEConfig(name) {};
+
+        void onConnection(const Gap::ConnectionCallbackParams_t *params) {
+            // keep the event thread busy, so processing requests pile up in the queue
+            Thread::wait(100);
+        }
+    };
+    BLEConfigSlowConnection config("EVENTQUEUE");
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "events not processed");
+    bleManager.resetEventQueueStats();
+
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+    Thread::wait(10);
+    for (uint16_t mtu = 100; mtu < 100 + 4 * BLE_MANAGER_EVENT_QUEUE_DEPTH; mtu++) sim.exchangeMtu(connection, mtu);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "events not processed");
+
+    BLEManager::EventQueueStats stats = bleManager.getEventQueueStats();
+    printf("event-queue::posted=%u failed=%u dispatched=%u high-water=%u latency max=%uus avg=%uus\r\n",
+           (unsigned) stats.posted, (unsigned) stats.failed, (unsigned) stats.dispatched,
+           (unsigned) stats.highWater, (unsigned) stats.maxLatencyUs,
+           (unsigned) (stats.dispatched ? stats.totalLatencyUs / stats.dispatched : 0));
+
+    TEST_ASSERT_TRUE_MESSAGE(stats.failed > 0, "no failed posts counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_MANAGER_EVENT_QUEUE_DEPTH, stats.highWater, "queue high-water mark wrong");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(stats.posted, stats.dispatched, "posted requests not dispatched");
+    TEST_ASSERT_TRUE_MESSAGE(stats.maxLatencyUs >= 50000, "blocked dispatch latency not measured");
+    // the requests still waiting process all events, nothing is lost
+    TEST_ASSERT_EQUAL_INT_MESSAGE(100 + 4 * BLE_MANAGER_EVENT_QUEUE_DEPTH - 1, bleManager.getAttMtu(connection),
+                                  "ATT MTU change lost");
+}
+
+static uint32_t counter(const uint8_t *value, int index) {
+    const uint8_t *p = value + 1 + index * 4;
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void TestBLEManagerStats() {
+    BLEConfig config("STATS");
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+    BLEStatsService *statsService = new BLEStatsService(BLE::Instance());
+    bleManager.resetStats();
+
+    // the link is lost and the same peer comes back
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.disconnect(connection, Gap::CONNECTION_TIMEOUT),
+                                  "disconnect failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "disconnection not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(connection, sim.connect(), "peer not connected again");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection not processed");
+
+    BLEStats stats = bleManager.getStats();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, stats.connections, "connections not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.reconnects, "reconnect not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.disconnections, "disconnection not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.linkLosses, "link loss not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.advertisingRestarts, "advertising restart not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stats.initFailures, "init failure counted");
+
+    // a maintenance app reads the counters in a long read at the default MTU
+    uint8_t value[BLEStatsService::VALUE_SIZE + 8];
+    uint16_t length = sizeof(value);
+    GattAttribute::Handle_t statsHandle = sim.findCharacteristic(UUID(BLEStatsCharacteristicUUID));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.read(connection, statsHandle, value, &length), "read failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLEStatsService::VALUE_SIZE, length, "wrong value length");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLEStatsService::VERSION, value[0], "wrong version");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, counter(value, 5), "wrong connections");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, counter(value, 6), "wrong reconnects");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, counter(value, 8), "wrong link losses");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_OPERATION_NOT_PERMITTED,
+                                  sim.write(connection, statsHandle, value, 4), "counters writable");
+
+    bleManager.resetStats();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, bleManager.getStats().connections, "counters not reset");
+    delete statsService;
+
+    // without a config the initialization fails
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.deinit(), "BLE deinit failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_STATE, bleManager.init(static_cast<BLEConfig *>(NULL)),
+                                  "init without config succeeded");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, bleManager.getStats().initFailures, "init failure not counted");
+    BLE::Instance().shutdown();
+}
+
+void TestBLEManagerAppEventQueue() {
+    BLEConfig config("APPQUEUE");
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+    EventQueue queue;
+
+    // this thread dispatches the queue, so only the asynchronous initialization works
+    initCalls = 0;
+    initResult = BLE_ERROR_UNSPECIFIED;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setEventQueue(&queue), "event queue not accepted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.initAsync(&config, onInitDone), "BLE init not started");
+    for (int i = 0; i < 100 && !initCalls; i++) queue.dispatch(10);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, initCalls, "init callback not called");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, initResult, "BLE manager initialization failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_STATE, bleManager.setEventQueue(NULL),
+                                  "event queue changed while initialized");
+
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+    TEST_ASSERT_FALSE_MESSAGE(sim.flush(50), "events processed without dispatching the queue");
+    queue.dispatch(0);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection event not processed");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isConnected(), "manager not connected");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.deinit(), "BLE deinit failed");
+    queue.dispatch(0);
+}
+
+void TestBLEManagerEventQueueFull() {
+    BLEConfig config("FULLQUEUE");
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+    // room for a single processing request
+    EventQueue queue(EVENTS_EVENT_SIZE);
+
+    initCalls = 0;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setEventQueue(&queue), "event queue not accepted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.initAsync(&config, onInitDone), "BLE init not started");
+    for (int i = 0; i < 100 && !initCalls; i++) queue.dispatch(10);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, initResult, "BLE manager initialization failed");
+    bleManager.resetEventQueueStats();
+
+    // the second event finds the queue full
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.disconnect(connection), "disconnect failed");
+    BLEManager::EventQueueStats stats = bleManager.getEventQueueStats();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.posted, "processing not requested");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.failed, "full queue not counted");
+
+    // the waiting request processes the events of the lost one as well
+    queue.dispatch(0);
+    stats = bleManager.getEventQueueStats();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.dispatched, "processing request not dispatched");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "events not processed");
+    TEST_ASSERT_FALSE_MESSAGE(bleManager.isConnected(), "disconnection not processed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.deinit(), "BLE deinit failed");
+    queue.dispatch(0);
+}
+
+void TestBLEManagerSharedEventQueue() {
+    BLEConfig config("SHAREDQUEUE");
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setEventQueue(mbed_event_queue()),
+                                  "event queue not accepted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager initialization failed");
+
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection event not processed");
+    TEST_ASSERT_TRUE_MESSAGE(bleManager.isConnected(), "manager not connected");
+}
+
+void case_teardown_handler() {
+    printf("BLEManager::getInstance().deinit()\r\n");
+    BLEManager::getInstance().deinit();
+    BLEManager::getInstance().setEventQueue(NULL);
+    BLESim::getInstance().reset();
+}
+
+int main() {
+    nativetest::Case cases[] = {
+            {"Test ble-singleton", TestBLEManagerSingleton},
+            {"Test ble-init", TestBLEManagerInit},
+            {"Test ble-advertise", TestBLEManagerAdvertising},
+            {"Test ble-on-callbacks", TestBLEManagerOnCallbacks},
+            {"Test ble-init-async", TestBLEManagerInitAsync},
+            {"Test ble-init-timeout", TestBLEManagerInitTimeout},
+            {"Test ble-init-timing", TestBLEManagerInitTiming},
+            {"Test ble-multiple-connections", TestBLEManagerMultipleConnections},
+            {"Test ble-advertising-phases", TestBLEManagerAdvertisingPhases},
+            {"Test ble-connection-profiles", TestBLEManagerConnectionProfiles},
+            {"Test ble-link-update", TestBLEManagerLinkUpdate},
+            {"Test ble-event-queue-stats", TestBLEManagerEventQueueStats},
+            {"Test ble-stats", TestBLEManagerStats},
+            {"Test ble-app-event-queue", TestBLEManagerAppEventQueue},
+            {"Test ble-event-queue-full", TestBLEManagerEventQueueFull},
+            {"Test ble-shared-event-queue", TestBLEManagerSharedEventQueue},
+    };
+
+    return nativetest::run(cases, sizeof(cases) / sizeof(cases[0]), case_teardown_handler);
+}
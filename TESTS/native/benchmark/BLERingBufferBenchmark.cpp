@@ -0,0 +1,83 @@
+/*!
+ * @file
+ * @brief Native benchmark for the lock-free ring buffer
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <mbed.h>
+#include <BLERingBuffer.h>
+
+#include "nativetest.h"
+#include "nativebench.h"
+
+#define TRANSFER_BYTES (64 * 1024 * 1024)
+
+static uint8_t storage[4096];
+static BLERingBuffer<uint8_t> ring;
+static uint32_t chunkSize;
+
+static void produce() {
+    uint8_t chunk[512];
+    memset(chunk, 0x55, sizeof(chunk));
+    uint32_t written = 0;
+    while (written < TRANSFER_BYTES) {
+        uint32_t n = ring.write(chunk, TRANSFER_BYTES - written < chunkSize ? TRANSFER_BYTES - written : chunkSize);
+        if (!n) Thread::yield();
+        written += n;
+    }
+}
+
+void BenchmarkBLERingBufferThroughput() {
+    const uint32_t sizes[] = {1, 20, 244, 512};
+    uint8_t chunk[512];
+    char name[64];
+
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        chunkSize = sizes[s];
+        ring.init(storage, sizeof(storage));
+
+        uint64_t start = nativebench::now();
+        Thread producer;
+        producer.start(callback(produce));
+
+        uint32_t read = 0;
+        while (read < TRANSFER_BYTES) {
+            uint32_t n = ring.read(chunk, TRANSFER_BYTES - read < chunkSize ? TRANSFER_BYTES - read : chunkSize);
+            if (!n) Thread::yield();
+            read += n;
+        }
+        producer.join();
+        uint64_t elapsed = nativebench::now() - start;
+
+        snprintf(name, sizeof(name), "ring.spsc.chunk%u.throughput", static_cast<unsigned>(chunkSize));
+        nativebench::report(name, TRANSFER_BYTES / (elapsed / 1e9) / (1024 * 1024), "MiB/s");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(TRANSFER_BYTES, read, "data lost");
+    }
+}
+
+int main() {
+    nativetest::Case cases[] = {
+            {"Benchmark ring-throughput", BenchmarkBLERingBufferThroughput},
+    };
+
+    return nativetest::run(cases, sizeof(cases) / sizeof(cases[0]));
+}
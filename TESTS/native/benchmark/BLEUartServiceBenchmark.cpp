@@ -0,0 +1,547 @@
+/*!
+ * @file
+ * @brief Native benchmark for the BLE UART Service send path
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <algorithm>
+#include <BLEManager.h>
+#include <BLESim.h>
+#include <UARTService.h>
+#include <services/BLEUartService.h>
+
+#include "nativetest.h"
+#include "nativebench.h"
+
+#define DEVICE_NAME "BENCHMARK"
+#define PACKETS 20000
+
+void BenchmarkBLEUartServiceSendAllocations() {
+    const uint8_t message[] = "0123456789ABCDEFGHIJ";
+    const int len = sizeof(message) - 1;
+    uint8_t received[BLESim::PEER_BUFFER_SIZE];
+    BLESim &sim = BLESim::getInstance();
+
+    BLEManager &bleManager = BLEManager::getInstance();
+    BLEConfig config(DEVICE_NAME);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager init failed");
+    BLEUartService *uartService = new BLEUartService(BLE::Instance(), 128, 128);
+
+    Gap::Handle_t connection = sim.connect();
+    GattAttribute::Handle_t rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, rxHandle), "subscribe failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+
+    // warm up, the first packets may initialize lazy state in the stack and stdio
+    for (int i = 0; i < 100; i++) uartService->send(message, len);
+    sim.flush();
+    sim.receive(connection, received, sizeof(received));
+
+    uint32_t allocations = nativebench::allocations();
+    uint64_t start = nativebench::now();
+    uint32_t bytes = 0;
+    for (int i = 0; i < PACKETS; i++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(len, uartService->send(message, len), "could not send all data");
+        if (i % 256 == 0) bytes += sim.receive(connection, received, sizeof(received));
+    }
+    sim.flush();
+    uint64_t elapsed = nativebench::now() - start;
+    allocations = nativebench::allocations() - allocations;
+    bytes += sim.receive(connection, received, sizeof(received));
+
+    nativebench::report("uart.send.packets", PACKETS, "packets");
+    nativebench::report("uart.send.time_per_packet", static_cast<double>(elapsed) / PACKETS, "ns");
+    nativebench::report("uart.send.allocations_per_packet", static_cast<double>(allocations) / PACKETS, "allocs");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(PACKETS * len, bytes, "peer did not receive all data");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, allocations, "send path allocated heap memory");
+
+    delete uartService;
+}
+
+void BenchmarkBLEUartServiceHeap() {
+    BLEConfig config(DEVICE_NAME);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE manager init failed");
+
+    // the service object itself, its buffers and what the simulated stack keeps for the GATT table
+    uint32_t allocations = nativebench::allocations();
+    uint32_t bytes = nativebench::allocatedBytes();
+    BLEUartService *uartService = new BLEUartService(BLE::Instance(), 20, 20);
+    allocations = nativebench::allocations() - allocations;
+    bytes = nativebench::allocatedBytes() - bytes;
+
+    nativebench::report("uart.service.object_size", sizeof(BLEUartService), "bytes");
+    nativebench::report("uart.service.heap_allocations", allocations, "allocs");
+    nativebench::report("uart.service.heap_bytes", bytes, "bytes");
+
+    delete uartService;
+}
+
+void BenchmarkBLEUartServiceSendMtu() {
+    const uint16_t mtus[] = {BLESim::DEFAULT_ATT_MTU, 185, BLESim::MAX_ATT_MTU};
+    const uint32_t total = 256 * 1024;
+    uint8_t message[2048], received[BLESim::PEER_BUFFER_SIZE];
+    uint32_t notifications[3];
+    char name[64];
+    BLESim &sim = BLESim::getInstance();
+    memset(message, 'x', sizeof(message));
+
+    for (int m = 0; m < 3; m++) {
+        BLEConfig config(DEVICE_NAME);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+        BLEUartService *uartService = new BLEUartService(BLE::Instance(), 128, sizeof(message));
+
+        Gap::Handle_t connection = sim.connect();
+        GattAttribute::Handle_t rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+        TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, rxHandle), "subscribe failed");
+        sim.exchangeMtu(connection, mtus[m]);
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+
+        uint32_t bytes = 0;
+        uint64_t start = nativebench::now();
+        for (uint32_t sent = 0; sent < total; sent += sizeof(message)) {
+            uartService->send(message, sizeof(message));
+            bytes += sim.receive(connection, received, sizeof(received));
+        }
+        sim.flush();
+        uint64_t elapsed = nativebench::now() - start;
+        bytes += sim.receive(connection, received, sizeof(received));
+        notifications[m] = sim.stats(connection).notifications;
+
+        snprintf(name, sizeof(name), "uart.send.mtu%u.notifications", mtus[m]);
+        nativebench::report(name, notifications[m], "packets");
+        snprintf(name, sizeof(name), "uart.send.mtu%u.bytes_per_notification", mtus[m]);
+        nativebench::report(name, static_cast<double>(bytes) / notifications[m], "bytes");
+        snprintf(name, sizeof(name), "uart.send.mtu%u.host_throughput", mtus[m]);
+        nativebench::report(name, bytes / (elapsed / 1e9) / 1024, "KiB/s");
+
+        TEST_ASSERT_EQUAL_INT_MESSAGE(total, bytes, "peer did not receive all data");
+        BLEManager::getInstance().deinit();
+        delete uartService;
+        sim.reset();
+    }
+
+    // the same data needs close to (247 - 3) / (23 - 3) times less notifications (and connection event slots)
+    TEST_ASSERT_TRUE_MESSAGE(notifications[2] * 10 < notifications[0], "no gain from larger MTU");
+}
+
+void BenchmarkBLEUartServiceSendLink() {
+    const uint16_t dataLengths[] = {BLE_DEFAULT_DATA_LENGTH, BLE_MAX_DATA_LENGTH};
+    const uint8_t phys[] = {ble::phy_set_t::PHY_SET_1M, ble::phy_set_t::PHY_SET_2M};
+    const uint32_t total = 64 * 1024;
+    uint8_t message[2048], received[BLESim::PEER_BUFFER_SIZE];
+    double linkRate[2][2];
+    char name[64];
+    BLESim &sim = BLESim::getInstance();
+    memset(message, 'x', sizeof(message));
+
+    for (int p = 0; p < 2; p++) {
+        for (int d = 0; d < 2; d++) {
+            BLEConfig config(DEVICE_NAME);
+            config.dataLength = dataLengths[d];
+            config.preferredPhys = ble::phy_set_t(phys[p]);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+            BLEUartService *uartService = new BLEUartService(BLE::Instance(), 128, sizeof(message));
+
+            Gap::Handle_t connection = sim.connect();
+            GattAttribute::Handle_t rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+            TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, rxHandle), "subscribe failed");
+            sim.exchangeMtu(connection, BLESim::MAX_ATT_MTU);
+            TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+
+            uint32_t bytes = 0;
+            for (uint32_t sent = 0; sent < total; sent += sizeof(message)) {
+                uartService->send(message, sizeof(message));
+                bytes += sim.receive(connection, received, sizeof(received));
+            }
+            sim.flush();
+            bytes += sim.receive(connection, received, sizeof(received));
+            BLESim::PeerStats stats = sim.stats(connection);
+            // what the radio achieves if every connection event is filled with packets
+            linkRate[p][d] = stats.bytes * 8.0 / stats.airTimeUs * 1000;
+
+            snprintf(name, sizeof(name), "uart.send.%s.dle%u.link_packets", p ? "2m" : "1m", dataLengths[d]);
+            nativebench::report(name, stats.packets, "packets");
+            snprintf(name, sizeof(name), "uart.send.%s.dle%u.bytes_per_notification", p ? "2m" : "1m",
+                     dataLengths[d]);
+            nativebench::report(name, static_cast<double>(stats.bytes) / stats.notifications, "bytes");
+            snprintf(name, sizeof(name), "uart.send.%s.dle%u.link_throughput", p ? "2m" : "1m", dataLengths[d]);
+            nativebench::report(name, linkRate[p][d], "kbit/s");
+
+            TEST_ASSERT_EQUAL_INT_MESSAGE(total, bytes, "peer did not receive all data");
+            BLEManager::getInstance().deinit();
+            delete uartService;
+            sim.reset();
+        }
+    }
+
+    // 2M alone halves the time on air of the payload, the extension saves the per packet overhead
+    TEST_ASSERT_TRUE_MESSAGE(linkRate[0][1] > linkRate[0][0] * 1.5, "no gain from the data length extension");
+    TEST_ASSERT_TRUE_MESSAGE(linkRate[1][1] > linkRate[0][0] * 3, "no gain from 2M PHY and data length extension");
+}
+
+struct RxReader {
+    BLEUartService *service;
+    uint32_t total;
+    volatile uint32_t received;
+
+    void run() {
+        uint8_t buffer[256];
+        while (received < total) {
+            int n = service->read(buffer, sizeof(buffer), 1000);
+            if (!n) break;
+            __atomic_add_fetch(&received, n, __ATOMIC_RELEASE);
+        }
+    }
+};
+
+void BenchmarkBLEUartServiceThroughput() {
+    const uint16_t bufferSizes[] = {64, 512, 2048};
+    const uint16_t mtus[] = {BLESim::DEFAULT_ATT_MTU, 185, BLESim::MAX_ATT_MTU};
+    // 7.5ms, 30ms and 100ms
+    const uint16_t intervals[] = {6, 24, 80};
+    const uint32_t total = 64 * 1024;
+    uint8_t message[2048], received[BLESim::PEER_BUFFER_SIZE];
+    char name[64];
+    BLESim &sim = BLESim::getInstance();
+    memset(message, 'x', sizeof(message));
+
+    for (int b = 0; b < 3; b++) {
+        for (int m = 0; m < 3; m++) {
+            for (int i = 0; i < 3; i++) {
+                uint16_t size = bufferSizes[b];
+                BLEConfig config(DEVICE_NAME);
+                TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config),
+                                              "BLE init failed");
+                BLEUartService *uartService = new BLEUartService(BLE::Instance(), size, size);
+
+                Gap::ConnectionParams_t params = {intervals[i], intervals[i], 0, 400};
+                Gap::Handle_t connection = sim.connect(&params);
+                GattAttribute::Handle_t txHandle = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID));
+                GattAttribute::Handle_t rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+                TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, rxHandle), "subscribe failed");
+                sim.exchangeMtu(connection, mtus[m]);
+                TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+
+                // TX: the application sends as fast as it can, the central takes everything
+                uint32_t bytes = 0;
+                uint64_t cpu = nativebench::cpuTime();
+                uint64_t start = nativebench::now();
+                for (uint32_t sent = 0; sent < total; sent += size) {
+                    uartService->send(message, size);
+                    bytes += sim.receive(connection, received, sizeof(received));
+                }
+                sim.flush();
+                uint64_t elapsed = nativebench::now() - start;
+                cpu = nativebench::cpuTime() - cpu;
+                bytes += sim.receive(connection, received, sizeof(received));
+                TEST_ASSERT_EQUAL_INT_MESSAGE(total, bytes, "peer did not receive all data");
+
+                snprintf(name, sizeof(name), "uart.tx.buf%u.mtu%u.ci%u.link_throughput", size, mtus[m],
+                         intervals[i] * 125 / 100);
+                nativebench::report(name, sim.linkThroughput(connection) / 1024.0, "KiB/s");
+
+                // the host path does not depend on the connection interval
+                if (i == 0) {
+                    snprintf(name, sizeof(name), "uart.tx.buf%u.mtu%u.host_throughput", size, mtus[m]);
+                    nativebench::report(name, bytes / (elapsed / 1e9) / 1024, "KiB/s");
+                    snprintf(name, sizeof(name), "uart.tx.buf%u.mtu%u.cpu", size, mtus[m]);
+                    nativebench::report(name, 100.0 * cpu / elapsed, "%");
+
+                    // RX: the central writes as fast as the reader makes space, nothing is dropped
+                    RxReader reader = {uartService, total, 0};
+                    uint16_t chunk = static_cast<uint16_t>(mtus[m] - 3 < size ? mtus[m] - 3 : size);
+                    Thread thread;
+                    cpu = nativebench::cpuTime();
+                    start = nativebench::now();
+                    thread.start(callback(&reader, &RxReader::run));
+                    for (uint32_t written = 0; written < total; written += chunk) {
+                        while (written + chunk - __atomic_load_n(&reader.received, __ATOMIC_ACQUIRE) > size)
+                            Thread::yield();
+                        sim.write(connection, txHandle, message, chunk);
+                    }
+                    thread.join();
+                    elapsed = nativebench::now() - start;
+                    cpu = nativebench::cpuTime() - cpu;
+                    TEST_ASSERT_TRUE_MESSAGE(reader.received >= total, "service did not receive all data");
+
+                    snprintf(name, sizeof(name), "uart.rx.buf%u.mtu%u.host_throughput", size, mtus[m]);
+                    nativebench::report(name, reader.received / (elapsed / 1e9) / 1024, "KiB/s");
+                    snprintf(name, sizeof(name), "uart.rx.buf%u.mtu%u.cpu", size, mtus[m]);
+                    nativebench::report(name, 100.0 * cpu / elapsed, "%");
+                }
+
+                BLEManager::getInstance().deinit();
+                delete uartService;
+                sim.reset();
+            }
+        }
+    }
+}
+
+struct Echo {
+    BLEUartService *service;
+    volatile bool stop;
+
+    void run() {
+        uint8_t buffer[256];
+        while (!stop) {
+            int n = service->read(buffer, sizeof(buffer), 10);
+            if (n > 0) service->send(buffer, n);
+        }
+    }
+};
+
+void BenchmarkBLEUartServiceRoundTrip() {
+    const uint16_t sizes[] = {1, 20, 244};
+    const int rounds = 2000;
+    static uint32_t rtt[rounds];
+    uint8_t message[244], received[244];
+    char name[64];
+    BLESim &sim = BLESim::getInstance();
+    for (size_t i = 0; i < sizeof(message); i++) message[i] = static_cast<uint8_t>(i);
+
+    BLEConfig config(DEVICE_NAME);
+    config.dataLength = BLE_MAX_DATA_LENGTH;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+    BLEUartService *uartService = new BLEUartService(BLE::Instance(), 256, 256);
+    Gap::Handle_t connection = sim.connect();
+    GattAttribute::Handle_t txHandle = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID));
+    GattAttribute::Handle_t rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, rxHandle), "subscribe failed");
+    sim.exchangeMtu(connection, BLESim::MAX_ATT_MTU);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+
+    // the application echoes everything it reads, like a request/response protocol
+    Echo echo = {uartService, false};
+    Thread thread;
+    thread.start(callback(&echo, &Echo::run));
+
+    for (int s = 0; s < 3; s++) {
+        for (int r = 0; r < rounds; r++) {
+            uint64_t start = nativebench::now();
+            sim.write(connection, txHandle, message, sizes[s]);
+            while (sim.available(connection) < sizes[s]) {
+                if (nativebench::now() - start > 1000000000ULL) TEST_FAIL_MESSAGE("no echo received");
+                Thread::yield();
+            }
+            rtt[r] = static_cast<uint32_t>((nativebench::now() - start) / 1000);
+            TEST_ASSERT_EQUAL_INT_MESSAGE(sizes[s], sim.receive(connection, received, sizes[s]), "echo missing");
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE(message, received, sizes[s], "wrong echo received");
+        }
+
+        std::sort(rtt, rtt + rounds);
+        snprintf(name, sizeof(name), "uart.rtt.size%u.p50", sizes[s]);
+        nativebench::report(name, rtt[rounds / 2], "us");
+        snprintf(name, sizeof(name), "uart.rtt.size%u.p90", sizes[s]);
+        nativebench::report(name, rtt[rounds * 90 / 100], "us");
+        snprintf(name, sizeof(name), "uart.rtt.size%u.p99", sizes[s]);
+        nativebench::report(name, rtt[rounds * 99 / 100], "us");
+        snprintf(name, sizeof(name), "uart.rtt.size%u.max", sizes[s]);
+        nativebench::report(name, rtt[rounds - 1], "us");
+    }
+
+    echo.stop = true;
+    thread.join();
+    delete uartService;
+}
+
+// fill the receive buffer with packets of the given size, like a central writing quickly
+static uint32_t fillReceiveBuffer(Gap::Handle_t connection, GattAttribute::Handle_t txHandle,
+                                  const uint8_t *packet, uint16_t size, uint32_t capacity) {
+    BLESim &sim = BLESim::getInstance();
+    uint32_t filled = 0;
+    for (; filled + size <= capacity; filled += size) sim.write(connection, txHandle, packet, size);
+    sim.flush();
+    return filled;
+}
+
+void BenchmarkBLEUartServiceDrain() {
+    const uint16_t sizes[] = {20, 100, 244};
+    const uint32_t capacity = 4096, rounds = 200;
+    uint8_t packet[244], buffer[244];
+    char name[64];
+    BLESim &sim = BLESim::getInstance();
+    for (size_t i = 0; i < sizeof(packet); i++) packet[i] = static_cast<uint8_t>(i);
+
+    BLEConfig config(DEVICE_NAME);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+    BLEUartService *uartService = new BLEUartService(BLE::Instance(), capacity, 128);
+    Gap::Handle_t connection = sim.connect();
+    GattAttribute::Handle_t txHandle = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID));
+    sim.exchangeMtu(connection, BLESim::MAX_ATT_MTU);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+
+    // every variant sums the bytes, like a parser looking at each one
+    for (unsigned s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint64_t getcTime = 0, readTime = 0, spanTime = 0;
+        uint32_t getcSum = 0, readSum = 0, spanSum = 0, bytes = 0;
+
+        for (uint32_t r = 0; r < rounds; r++) {
+            bytes += fillReceiveBuffer(connection, txHandle, packet, sizes[s], capacity);
+            uint64_t start = nativebench::now();
+            int c;
+            while ((c = uartService->getc()) != EOF) getcSum += c;
+            getcTime += nativebench::now() - start;
+
+            fillReceiveBuffer(connection, txHandle, packet, sizes[s], capacity);
+            start = nativebench::now();
+            int n;
+            while ((n = uartService->read(buffer, sizes[s])) > 0) {
+                for (int i = 0; i < n; i++) readSum += buffer[i];
+            }
+            readTime += nativebench::now() - start;
+
+            fillReceiveBuffer(connection, txHandle, packet, sizes[s], capacity);
+            start = nativebench::now();
+            BLEUartService::Span spans[2];
+            while ((n = uartService->peek(spans)) > 0) {
+                for (int p = 0; p < 2; p++) {
+                    for (uint32_t i = 0; i < spans[p].length; i++) spanSum += spans[p].data[i];
+                }
+                uartService->consume(n);
+            }
+            spanTime += nativebench::now() - start;
+        }
+
+        snprintf(name, sizeof(name), "uart.drain.packet%u.getc", sizes[s]);
+        nativebench::report(name, static_cast<double>(getcTime) / bytes, "ns/byte");
+        snprintf(name, sizeof(name), "uart.drain.packet%u.read", sizes[s]);
+        nativebench::report(name, static_cast<double>(readTime) / bytes, "ns/byte");
+        snprintf(name, sizeof(name), "uart.drain.packet%u.span", sizes[s]);
+        nativebench::report(name, static_cast<double>(spanTime) / bytes, "ns/byte");
+
+        TEST_ASSERT_EQUAL_INT_MESSAGE(rounds * (capacity / sizes[s]) * sizes[s], bytes, "receive buffer not filled");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(getcSum, readSum, "read drained different data");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(getcSum, spanSum, "span drained different data");
+    }
+
+    delete uartService;
+}
+
+#define MAX_PEERS 4
+
+static uint32_t peerBytes[BLESim::MAX_CONNECTIONS];
+
+static void countNotification(const BLESim::Notification *notification) {
+    peerBytes[notification->connection] += notification->len;
+}
+
+struct PeerSender {
+    BLEUartService *service;
+    Gap::Handle_t connection;
+    const uint8_t *message;
+    int length;
+    uint32_t total;
+
+    void run() {
+        for (uint32_t sent = 0; sent < total; sent += length) service->send(connection, message, length);
+    }
+};
+
+void BenchmarkBLEUartServiceSendConnections() {
+    const int peerCounts[] = {1, 2, MAX_PEERS};
+    const uint32_t total = 256 * 1024;
+    uint8_t message[1024];
+    double throughput[3];
+    char name[64];
+    BLESim &sim = BLESim::getInstance();
+    memset(message, 'x', sizeof(message));
+
+    for (int n = 0; n < 3; n++) {
+        int peers = peerCounts[n];
+        BLEConfig config(DEVICE_NAME, 10, 0, MAX_PEERS);
+        TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+        BLEUartService *uartService = new BLEUartService(BLE::Instance(), 128, sizeof(message), true);
+
+        GattAttribute::Handle_t rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+        PeerSender senders[MAX_PEERS];
+        for (int i = 0; i < peers; i++) {
+            Gap::Handle_t connection = sim.connect();
+            TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+            TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, rxHandle), "subscribe failed");
+            sim.exchangeMtu(connection, BLESim::MAX_ATT_MTU);
+            // the next central can only connect once the peripheral advertises again
+            TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+            senders[i].service = uartService;
+            senders[i].connection = connection;
+            senders[i].message = message;
+            senders[i].length = sizeof(message);
+            senders[i].total = total;
+            peerBytes[connection] = 0;
+        }
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+        sim.onNotification(countNotification);
+
+        // every peer is served by its own sending thread
+        Thread *threads[MAX_PEERS];
+        uint64_t start = nativebench::now();
+        for (int i = 0; i < peers; i++) {
+            threads[i] = new Thread();
+            threads[i]->start(callback(&senders[i], &PeerSender::run));
+        }
+        for (int i = 0; i < peers; i++) {
+            threads[i]->join();
+            delete threads[i];
+        }
+        sim.flush();
+        uint64_t elapsed = nativebench::now() - start;
+        sim.onNotification(NULL);
+
+        uint32_t bytes = 0;
+        for (int i = 0; i < peers; i++) {
+            TEST_ASSERT_EQUAL_INT_MESSAGE(total, peerBytes[senders[i].connection], "peer did not receive all data");
+            bytes += peerBytes[senders[i].connection];
+        }
+        throughput[n] = bytes / (elapsed / 1e9) / 1024;
+
+        snprintf(name, sizeof(name), "uart.send.peers%d.aggregate_host_throughput", peers);
+        nativebench::report(name, throughput[n], "KiB/s");
+        snprintf(name, sizeof(name), "uart.send.peers%d.per_peer_host_throughput", peers);
+        nativebench::report(name, throughput[n] / peers, "KiB/s");
+
+        BLEManager::getInstance().deinit();
+        delete uartService;
+        sim.reset();
+    }
+}
+
+void case_teardown_handler() {
+    BLEManager::getInstance().deinit();
+    BLESim::getInstance().reset();
+}
+
+int main() {
+    nativetest::Case cases[] = {
+            {"Benchmark ble-uart-send-allocations", BenchmarkBLEUartServiceSendAllocations},
+            {"Benchmark ble-uart-heap", BenchmarkBLEUartServiceHeap},
+            {"Benchmark ble-uart-send-mtu", BenchmarkBLEUartServiceSendMtu},
+            {"Benchmark ble-uart-send-link", BenchmarkBLEUartServiceSendLink},
+            {"Benchmark ble-uart-send-connections", BenchmarkBLEUartServiceSendConnections},
+            {"Benchmark ble-uart-drain", BenchmarkBLEUartServiceDrain},
+            {"Benchmark ble-uart-throughput", BenchmarkBLEUartServiceThroughput},
+            {"Benchmark ble-uart-round-trip", BenchmarkBLEUartServiceRoundTrip},
+    };
+
+    return nativetest::run(cases, sizeof(cases) / sizeof(cases[0]), case_teardown_handler);
+}
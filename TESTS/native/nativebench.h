@@ -0,0 +1,114 @@
+/*!
+ * @file
+ * @brief Benchmark helpers for the native (host) tests.
+ *
+ * Replaces the global allocation functions to count heap use, so this
+ * header must only be included by a single translation unit (the benchmark).
+ * Results are printed and, if the environment variable BLE_BENCHMARK_CSV
+ * names a file, also written to it as CSV (name,value,unit).
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_NATIVEBENCH_H
+#define UBIRCH_MBED_BLE_NATIVEBENCH_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <new>
+#include <stdint.h>
+
+namespace nativebench {
+
+static uint32_t allocationCount = 0;
+static uint32_t allocationBytes = 0;
+static FILE *csv = NULL;
+
+/**
+ * @return the number of heap allocations (all threads) since program start
+ */
+inline uint32_t allocations() {
+    return __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+}
+
+/**
+ * @return the number of bytes requested from the heap (all threads) since program start
+ */
+inline uint32_t allocatedBytes() {
+    return __atomic_load_n(&allocationBytes, __ATOMIC_RELAXED);
+}
+
+/**
+ * @return a monotonic timestamp in nanoseconds
+ */
+inline uint64_t now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @return the CPU time used by all threads of the process in nanoseconds
+ */
+inline uint64_t cpuTime() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * Print a single benchmark result line.
+ */
+inline void report(const char *name, double value, const char *unit) {
+    printf("%-48s %14.2f %s\r\n", name, value, unit);
+
+    // the file is written from scratch by every run
+    const char *path = getenv("BLE_BENCHMARK_CSV");
+    if (!csv && path && *path && (csv = fopen(path, "w"))) fprintf(csv, "name,value,unit\n");
+    if (csv) {
+        fprintf(csv, "%s,%.2f,%s\n", name, value, unit);
+        fflush(csv);
+    }
+}
+
+}
+
+void *operator new(size_t size) throw(std::bad_alloc) {
+    __atomic_add_fetch(&nativebench::allocationCount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&nativebench::allocationBytes, static_cast<uint32_t>(size), __ATOMIC_RELAXED);
+    void *p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc) {
+    return operator new(size);
+}
+
+void operator delete(void *p) throw() {
+    free(p);
+}
+
+void operator delete[](void *p) throw() {
+    free(p);
+}
+
+#endif //UBIRCH_MBED_BLE_NATIVEBENCH_H
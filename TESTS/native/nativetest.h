@@ -0,0 +1,110 @@
+/*!
+ * @file
+ * @brief Minimal test harness for the native (host) tests.
+ *
+ * Mirrors the subset of utest/unity used in the greentea tests so test
+ * cases read the same on the host. A failed assertion aborts the case,
+ * the teardown handler is still run.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_NATIVETEST_H
+#define UBIRCH_MBED_BLE_NATIVETEST_H
+
+#include <cstdio>
+#include <cstring>
+
+namespace nativetest {
+
+struct Failure {
+    const char *file;
+    int line;
+    char message[256];
+};
+
+inline void fail(const char *file, int line, const char *message) {
+    Failure failure;
+    failure.file = file;
+    failure.line = line;
+    snprintf(failure.message, sizeof(failure.message), "%s", message);
+    throw failure;
+}
+
+inline void assertInt(long long expected, long long actual, const char *message, const char *file, int line) {
+    if (expected != actual) {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "expected %lld was %lld: %s", expected, actual, message);
+        fail(file, line, buffer);
+    }
+}
+
+inline void assertString(const char *expected, const char *actual, const char *message, const char *file, int line) {
+    if (strcmp(expected, actual) != 0) {
+        char buffer[256];
+        snprintf(buffer, sizeof(buffer), "expected '%s' was '%s': %s", expected, actual, message);
+        fail(file, line, buffer);
+    }
+}
+
+struct Case {
+    const char *description;
+    void (*handler)();
+};
+
+/**
+ * Run all test cases and report the results.
+ * @param cases the test case table
+ * @param count the number of test cases
+ * @param teardown called after each case, even if it failed
+ * @return 0 if all cases passed
+ */
+inline int run(const Case *cases, size_t count, void (*teardown)() = NULL) {
+    size_t failed = 0;
+    for (size_t i = 0; i < count; i++) {
+        printf(">>> Running case #%u: '%s'...\r\n", static_cast<unsigned>(i + 1), cases[i].description);
+        bool passed = true;
+        try {
+            cases[i].handler();
+        } catch (const Failure &failure) {
+            printf("%s:%d: FAIL: %s\r\n", failure.file, failure.line, failure.message);
+            passed = false;
+        }
+        if (teardown) teardown();
+        if (!passed) failed++;
+        printf(">>> '%s': %s\r\n", cases[i].description, passed ? "PASS" : "FAIL");
+    }
+    printf(">>> Test cases: %u passed, %u failed\r\n",
+           static_cast<unsigned>(count - failed), static_cast<unsigned>(failed));
+    return failed ? 1 : 0;
+}
+
+}
+
+#define TEST_FAIL_MESSAGE(m) nativetest::fail(__FILE__, __LINE__, m)
+#define TEST_ASSERT_TRUE_MESSAGE(c, m) do { if (!(c)) nativetest::fail(__FILE__, __LINE__, m); } while (0)
+#define TEST_ASSERT_FALSE_MESSAGE(c, m) TEST_ASSERT_TRUE_MESSAGE(!(c), m)
+#define TEST_ASSERT_EQUAL_INT_MESSAGE(e, a, m) \
+    nativetest::assertInt((long long) (e), (long long) (a), m, __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_PTR_MESSAGE(e, a, m) TEST_ASSERT_TRUE_MESSAGE((const void *) (e) == (const void *) (a), m)
+#define TEST_ASSERT_EQUAL_STRING_MESSAGE(e, a, m) nativetest::assertString(e, a, m, __FILE__, __LINE__)
+#define TEST_ASSERT_EQUAL_MEMORY_MESSAGE(e, a, n, m) TEST_ASSERT_TRUE_MESSAGE(!memcmp(e, a, n), m)
+
+#endif //UBIRCH_MBED_BLE_NATIVETEST_H
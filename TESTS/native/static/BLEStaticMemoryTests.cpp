@@ -0,0 +1,185 @@
+/*!
+ * @file
+ * @brief Native test for the heap-free build (BLE_STATIC_MEMORY)
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <BLEManager.h>
+#include <BLESim.h>
+#include <UARTService.h>
+#include <services/BLEUartService.h>
+
+#include "nativetest.h"
+#include "nativebench.h"
+
+#define DEVICE_NAME "C0NNECTME"
+
+#if !BLE_STATIC_MEMORY
+#error "the static memory tests must be built with BLE_STATIC_MEMORY=1"
+#endif
+
+#if !BLE_MANAGER_OWN_EVENT_THREAD
+// built without the manager's event thread, the application dispatches the BLE events
+static EventQueue appQueue(BLE_MANAGER_EVENT_QUEUE_DEPTH * EVENTS_EVENT_SIZE);
+#endif
+
+static Gap::Handle_t connectAndSubscribe(GattAttribute::Handle_t *txHandle, GattAttribute::Handle_t *rxHandle) {
+    BLESim &sim = BLESim::getInstance();
+
+    TEST_ASSERT_TRUE_MESSAGE(sim.discover(DEVICE_NAME), "device not advertising");
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+
+    *txHandle = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID));
+    *rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+    TEST_ASSERT_TRUE_MESSAGE(*txHandle != GattAttribute::INVALID_HANDLE, "TX characteristic not found");
+    TEST_ASSERT_TRUE_MESSAGE(*rxHandle != GattAttribute::INVALID_HANDLE, "RX characteristic not found");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, *rxHandle), "subscribe failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+    return connection;
+}
+
+void TestBLEStaticMemoryInit() {
+    uint32_t before = nativebench::allocations();
+
+    // the name variant keeps its config in static memory too
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(DEVICE_NAME), "BLE manager init failed");
+    TEST_ASSERT_TRUE_MESSAGE(BLESim::getInstance().discover(DEVICE_NAME), "device not advertising");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().deinit(), "BLE deinit failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(DEVICE_NAME), "BLE manager re-init failed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, nativebench::allocations() - before, "heap used by init");
+}
+
+void TestBLEStaticMemoryUart() {
+    const char message[] = "Hello World!";
+    char v[128];
+    GattAttribute::Handle_t txHandle, rxHandle;
+    BLESim &sim = BLESim::getInstance();
+    BLEConfig config(DEVICE_NAME);
+
+    uint32_t before = nativebench::allocations();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE manager init failed");
+
+    // the buffers are part of the service object, here on the stack
+    BLEStaticUartService<128, 128> uart(BLE::Instance());
+    Gap::Handle_t connection = connectAndSubscribe(&txHandle, &rxHandle);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE,
+                                  sim.write(connection, txHandle, reinterpret_cast<const uint8_t *>(message),
+                                            static_cast<uint16_t>(strlen(message))),
+                                  "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+    int n = uart.read(reinterpret_cast<uint8_t *>(v), sizeof(v) - 1);
+    v[n > 0 ? n : 0] = '\0';
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(message, v, "wrong message received");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(strlen(message), uart.send(reinterpret_cast<const uint8_t *>(message),
+                                                             static_cast<uint16_t>(strlen(message))),
+                                  "send failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    n = sim.receive(connection, reinterpret_cast<uint8_t *>(v), sizeof(v) - 1);
+    v[n] = '\0';
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(message, v, "wrong message sent");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.disconnect(connection), "disconnect failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "disconnect not processed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, nativebench::allocations() - before, "heap used by the UART service");
+}
+
+void TestBLEStaticMemoryPerConnection() {
+    const char first[] = "first", second[] = "second";
+    char v[64];
+    GattAttribute::Handle_t txHandle, rxHandle;
+    BLESim &sim = BLESim::getInstance();
+    BLEConfig config(DEVICE_NAME, 10, 0, 2);
+
+    uint32_t before = nativebench::allocations();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE manager init failed");
+
+    BLEStaticUartService<64, 64, 2> uart(BLE::Instance());
+    Gap::Handle_t c1 = connectAndSubscribe(&txHandle, &rxHandle);
+    Gap::Handle_t c2 = connectAndSubscribe(&txHandle, &rxHandle);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE,
+                                  sim.write(c1, txHandle, reinterpret_cast<const uint8_t *>(first), sizeof(first)),
+                                  "write failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE,
+                                  sim.write(c2, txHandle, reinterpret_cast<const uint8_t *>(second), sizeof(second)),
+                                  "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "writes not processed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(first), uart.read(c1, reinterpret_cast<uint8_t *>(v), sizeof(v)),
+                                  "wrong length from first peer");
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(first, v, "wrong data from first peer");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(second), uart.read(c2, reinterpret_cast<uint8_t *>(v), sizeof(v)),
+                                  "wrong length from second peer");
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(second, v, "wrong data from second peer");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, nativebench::allocations() - before, "heap used per connection");
+}
+
+#if !BLE_MANAGER_OWN_EVENT_THREAD
+void TestBLEStaticMemoryNoEventThread() {
+    BLEManager &bleManager = BLEManager::getInstance();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setEventQueue(NULL), "event queue not reset");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_STATE, bleManager.init(DEVICE_NAME),
+                                  "initialized without an event queue");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.setEventQueue(&appQueue), "event queue not accepted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(DEVICE_NAME), "BLE manager init failed");
+    TEST_ASSERT_TRUE_MESSAGE(BLESim::getInstance().discover(DEVICE_NAME), "device not advertising");
+}
+#endif
+
+void case_teardown_handler() {
+    printf("BLEManager::getInstance().deinit()\r\n");
+    BLEManager::getInstance().deinit();
+    BLESim::getInstance().reset();
+}
+
+int main() {
+    nativetest::Case cases[] = {
+            {"Test ble-static-init", TestBLEStaticMemoryInit},
+            {"Test ble-static-uart", TestBLEStaticMemoryUart},
+            {"Test ble-static-per-connection", TestBLEStaticMemoryPerConnection},
+#if !BLE_MANAGER_OWN_EVENT_THREAD
+            {"Test ble-static-no-event-thread", TestBLEStaticMemoryNoEventThread},
+#endif
+    };
+
+#if !BLE_MANAGER_OWN_EVENT_THREAD
+    Thread appThread;
+    appThread.start(mbed::callback(&appQueue, &EventQueue::dispatch_forever));
+    BLEManager::getInstance().setEventQueue(&appQueue);
+#endif
+
+    int result = nativetest::run(cases, sizeof(cases) / sizeof(cases[0]), case_teardown_handler);
+
+#if !BLE_MANAGER_OWN_EVENT_THREAD
+    appQueue.break_dispatch();
+    appThread.join();
+#endif
+    return result;
+}
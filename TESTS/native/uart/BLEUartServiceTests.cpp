@@ -0,0 +1,857 @@
+/*!
+ * @file
+ * @brief Native test for the BLE UART Service using the simulated stack
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <BLEManager.h>
+#include <BLESim.h>
+#include <UARTService.h>
+#include <services/BLEUartService.h>
+#include <services/BLEUartStream.h>
+
+#include "nativetest.h"
+
+#define DEVICE_NAME "C0NNECTME"
+
+/**
+ * BLE initialized with a test config and the UART services of a test. BLE is shut down
+ * before the services are deleted, until then the BLE thread may dispatch events to them.
+ */
+class UartFixture {
+public:
+    BLEConfig config;
+    GattAttribute::Handle_t txHandle;
+    GattAttribute::Handle_t rxHandle;
+
+    UartFixture() : config(DEVICE_NAME), txHandle(GattAttribute::INVALID_HANDLE),
+                    rxHandle(GattAttribute::INVALID_HANDLE), serviceCount(0) {}
+
+    ~UartFixture() {
+        stop();
+    }
+
+    /**
+     * Add a UART service, the first one initializes BLE with the config.
+     * @return the service, deleted by stop()
+     */
+    BLEUartService *addService(uint16_t rxBufferSize = 20, uint16_t txBufferSize = 20, bool perConnection = false,
+                               BLEUartService::RxOverflowPolicy policy = BLEUartService::RX_OVERFLOW_DROP_NEWEST) {
+        TEST_ASSERT_TRUE_MESSAGE(serviceCount < MAX_SERVICES, "too many services");
+        if (!serviceCount) {
+            TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config),
+                                          "BLE manager init failed");
+        }
+        services[serviceCount] = new BLEUartService(BLE::Instance(), rxBufferSize, txBufferSize, perConnection, policy);
+        return services[serviceCount++];
+    }
+
+    /**
+     * Connect the central and subscribe to the notifications of the first service.
+     * @return the connection handle
+     */
+    Gap::Handle_t connect() {
+        BLESim &sim = BLESim::getInstance();
+
+        TEST_ASSERT_TRUE_MESSAGE(sim.discover(DEVICE_NAME), "device not advertising");
+        Gap::Handle_t connection = sim.connect();
+        TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+
+        txHandle = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID));
+        rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+        TEST_ASSERT_TRUE_MESSAGE(txHandle != GattAttribute::INVALID_HANDLE, "TX characteristic not found");
+        TEST_ASSERT_TRUE_MESSAGE(rxHandle != GattAttribute::INVALID_HANDLE, "RX characteristic not found");
+
+        TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, rxHandle), "subscribe failed");
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+        return connection;
+    }
+
+    /**
+     * Shut BLE down, then delete the services.
+     */
+    void stop() {
+        BLEManager::getInstance().deinit();
+        while (serviceCount) delete services[--serviceCount];
+    }
+
+private:
+    static const int MAX_SERVICES = 2;
+
+    BLEUartService *services[MAX_SERVICES];
+    int serviceCount;
+};
+
+void TestBLEUartServiceDiscoverCharacteristics() {
+    char uuid[37];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService();
+
+    TEST_ASSERT_TRUE_MESSAGE(sim.hasService(UUID(UARTServiceUUID)), "UART service not found");
+
+    // check if we find the correct characteristic UUIDs (UART TX/ UART RX)
+    UUID(UARTServiceTXCharacteristicUUID).toString(uuid);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("6E400002-B5A3-F393-E0A9-E50E24DCCA9E", uuid, "TX UUID does not match");
+    TEST_ASSERT_TRUE_MESSAGE(sim.findCharacteristic(UUID(uuid)) != GattAttribute::INVALID_HANDLE,
+                             "TX characteristic not found");
+    UUID(UARTServiceRXCharacteristicUUID).toString(uuid);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("6E400003-B5A3-F393-E0A9-E50E24DCCA9E", uuid, "RX UUID does not match");
+    TEST_ASSERT_TRUE_MESSAGE(sim.findCharacteristic(UUID(uuid)) != GattAttribute::INVALID_HANDLE,
+                             "RX characteristic not found");
+}
+
+void TestBLEUartServiceReceiveData() {
+    const char expected[] = "Hello World!";
+    char v[128];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 128);
+
+    Gap::Handle_t connection = fixture.connect();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE,
+                                  sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>(expected),
+                                            static_cast<uint16_t>(strlen(expected))),
+                                  "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+
+    // now read all the data
+    int i = 0;
+    while (uartService->isReadable()) v[i++] = static_cast<char>(uartService->getc());
+    v[i] = '\0';
+
+    // check that the message we expected has been received
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, v, "wrong message received");
+}
+
+void TestBLEUartServiceSendData() {
+    const char *messages[] = {"Hello World!", "0123456789ABCDEFGHIJ"};
+    char v[128];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 128);
+
+    Gap::Handle_t connection = fixture.connect();
+
+    for (int i = 0; i < 2; i++) {
+        const char *expected = messages[i];
+        int sent = uartService->send(reinterpret_cast<const uint8_t *>(expected), static_cast<int>(strlen(expected)));
+        TEST_ASSERT_EQUAL_INT_MESSAGE(strlen(expected), sent, "could not send all data");
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+
+        uint16_t len = sim.receive(connection, reinterpret_cast<uint8_t *>(v), sizeof(v) - 1);
+        v[len] = '\0';
+
+        // check that the message we expected has been received
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, v, "wrong message received");
+    }
+}
+
+void TestBLEUartServiceSendFragmented() {
+    uint8_t expected[600], v[700];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    // a notification of (MTU - 3) bytes fits into one link layer packet
+    fixture.config.dataLength = 251;
+    BLEUartService *uartService = fixture.addService(512, 512);
+
+    Gap::Handle_t connection = fixture.connect();
+    for (size_t i = 0; i < sizeof(expected); i++) expected[i] = static_cast<uint8_t>(i);
+
+    // at the default MTU everything is split into 20 byte notifications
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), uartService->send(expected, sizeof(expected)), "send failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), sim.receive(connection, v, sizeof(v)), "data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected, v, sizeof(expected), "wrong data received");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(20, sim.stats(connection).maxPayload, "wrong payload size");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim.stats(connection).truncated, "notifications truncated");
+
+    // after the MTU exchange notifications use the full (MTU - 3) payload
+    TEST_ASSERT_EQUAL_INT_MESSAGE(247, sim.exchangeMtu(connection, 517), "MTU exchange failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "MTU exchange not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(247, BLEManager::getInstance().getAttMtu(connection), "MTU not tracked");
+
+    uint32_t notifications = sim.stats(connection).notifications;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), uartService->send(expected, sizeof(expected)), "send failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), sim.receive(connection, v, sizeof(v)), "data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected, v, sizeof(expected), "wrong data received");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(244, sim.stats(connection).maxPayload, "wrong payload size");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim.stats(connection).truncated, "notifications truncated");
+    TEST_ASSERT_TRUE_MESSAGE(sim.stats(connection).notifications - notifications <= 5, "too many notifications");
+}
+
+static volatile int completedLength = 0;
+
+static void onSendComplete(int length) {
+    completedLength += length;
+}
+
+void TestBLEUartServiceSendAsync() {
+    uint8_t expected[1000], v[1100];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 2048);
+
+    Gap::Handle_t connection = fixture.connect();
+    for (size_t i = 0; i < sizeof(expected); i++) expected[i] = static_cast<uint8_t>(i * 7);
+
+    // several notifications are in flight, the rest is sent when the stack reports TX complete
+    completedLength = 0;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), uartService->sendAsync(expected, sizeof(expected), onSendComplete),
+                                  "data not queued");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), completedLength, "completion not called");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), sim.receive(connection, v, sizeof(v)), "data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected, v, sizeof(expected), "wrong data received");
+    TEST_ASSERT_TRUE_MESSAGE(sim.stats(connection).maxInFlight > 1, "only one notification in flight");
+
+    // with less stack buffers than credits the service backs off on BLE_ERROR_NO_MEM and continues
+    sim.setTxBuffers(2);
+    completedLength = 0;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), uartService->sendAsync(expected, sizeof(expected), onSendComplete),
+                                  "data not queued");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), completedLength, "completion not called");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), sim.receive(connection, v, sizeof(v)), "data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected, v, sizeof(expected), "wrong data received");
+    TEST_ASSERT_TRUE_MESSAGE(sim.stats(connection).noMemory > 0, "stack buffers never exhausted");
+}
+
+static BLEUartService *blockedService;
+static uint8_t blockedData[1000];
+static int blockedSent;
+static Semaphore blockedReturned;
+
+static void sendBlocked() {
+    blockedSent = blockedService->send(blockedData, sizeof(blockedData));
+    blockedReturned.release();
+}
+
+void TestBLEUartServiceSendBackpressure() {
+    uint8_t *data = blockedData, v[1100];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 64);
+
+    Gap::Handle_t connection = fixture.connect();
+    for (size_t i = 0; i < sizeof(blockedData); i++) data[i] = static_cast<uint8_t>(i);
+
+    // nothing leaves the stack buffers: send() sleeps until the timeout and returns what it queued
+    sim.setLinkStalled(true);
+    uartService->setSendTimeout(50);
+    int sent = uartService->send(data, sizeof(blockedData));
+    // the ring buffer plus the stack buffers, which may hold short segments where the ring wraps
+    TEST_ASSERT_TRUE_MESSAGE(sent > 64 && sent <= BLESim::DEFAULT_TX_BUFFERS * 20 + 64, "wrong partial write");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim.stats(connection).noMemory, "stack buffers overrun");
+
+    // when the link runs again the queued part arrives completely
+    sim.setLinkStalled(false);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sent, sim.receive(connection, v, sizeof(v)), "data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, v, sent, "wrong data received");
+
+    // without a timeout the sender sleeps while the link is stalled, it neither returns nor
+    // retries the full stack, and the TX complete events wake it up to send the rest
+    sim.setLinkStalled(true);
+    uartService->setSendTimeout(osWaitForever);
+    blockedService = uartService;
+    Thread sender;
+    sender.start(callback(sendBlocked));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, blockedReturned.wait(100), "send returned while the link is stalled");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim.stats(connection).noMemory, "stack retried while the link is stalled");
+    sim.setLinkStalled(false);
+    sender.join();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(blockedData), blockedSent, "send did not complete");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(blockedData), sim.receive(connection, v, sizeof(v)), "data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, v, sizeof(blockedData), "wrong data received");
+
+    // a busy stack does not report when it is ready again, send() retries it
+    sim.setBusy(3);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(blockedData), uartService->send(data, sizeof(blockedData)), "send failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(blockedData), sim.receive(connection, v, sizeof(v)), "data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, v, sizeof(blockedData), "wrong data received");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, sim.stats(connection).busy, "busy stack not simulated");
+
+    // a disconnect wakes up a blocked sender
+    sim.setLinkStalled(true);
+    uartService->setSendTimeout(osWaitForever);
+    sim.disconnect(connection);
+    TEST_ASSERT_TRUE_MESSAGE(uartService->send(data, sizeof(blockedData)) < static_cast<int>(sizeof(blockedData)),
+                             "sent to disconnected peer");
+}
+
+void TestBLEUartServiceLatency() {
+    uint8_t expected[100], v[128];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 256);
+
+    Gap::Handle_t connection = fixture.connect();
+    memset(expected, 'L', sizeof(expected));
+
+    // every notification is timestamped when written to the stack and when it is transmitted
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), uartService->send(expected, sizeof(expected)), "send failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expected), sim.receive(connection, v, sizeof(v)), "data missing");
+
+    const BLEHistogram &queued = uartService->getLatency(BLEUartService::LATENCY_QUEUED);
+    const BLEHistogram &stack = uartService->getLatency(BLEUartService::LATENCY_STACK);
+    const BLEHistogram &total = uartService->getLatency(BLEUartService::LATENCY_TOTAL);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, queued.count(), "not all notifications queued");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, stack.count(), "not all notifications completed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, total.count(), "not all notifications completed");
+    TEST_ASSERT_TRUE_MESSAGE(total.max() >= stack.max(), "total shorter than the stack latency");
+    TEST_ASSERT_TRUE_MESSAGE(total.percentile(50) <= total.percentile(99), "percentiles not ordered");
+    TEST_ASSERT_TRUE_MESSAGE(total.percentile(99) <= total.max(), "percentile above the maximum");
+    uartService->dumpLatency();
+
+    uartService->resetLatency();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, total.count(), "histogram not reset");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, total.percentile(50), "empty histogram has a percentile");
+
+    // percentiles are the upper end of their power of two bucket, capped at the maximum
+    BLEHistogram histogram;
+    histogram.add(0);
+    for (int i = 0; i < 98; i++) histogram.add(100);
+    histogram.add(5000);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(100, histogram.count(), "wrong sample count");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, histogram.percentile(1), "wrong p1");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(127, histogram.percentile(50), "wrong p50");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(127, histogram.percentile(99), "wrong p99");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5000, histogram.percentile(100), "wrong p100");
+    histogram.add(0xFFFFFFFFUL);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, histogram.bucket(BLEHistogram::BUCKETS - 1), "overflow not counted");
+}
+
+void TestBLEUartServiceStats() {
+    uint8_t data[50], v[64];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(16, 128);
+
+    Gap::Handle_t connection = fixture.connect();
+    memset(data, 'S', sizeof(data));
+    BLEManager &bleManager = BLEManager::getInstance();
+    bleManager.resetStats();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(data), uartService->send(data, sizeof(data)), "send failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(data), sim.receive(connection, v, sizeof(v)), "data missing");
+
+    // the receive buffer holds 16 bytes, the second write is dropped
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.write(connection, fixture.txHandle, data, 16), "write failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.write(connection, fixture.txHandle, data, 10), "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+
+    BLEStats stats = bleManager.getStats();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(data), stats.txBytes, "sent bytes not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(26, stats.rxBytes, "received bytes not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(10, stats.rxDropped, "dropped bytes not counted");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stats.txFailed, "failed writes counted");
+}
+
+void TestBLEUartServicePeekConsume() {
+    BLEUartService::Span spans[2];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(16, 16);
+
+    Gap::Handle_t connection = fixture.connect();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, uartService->peek(spans), "data without a write");
+
+    // fill, partially consume and refill, so the data wraps around the end of the buffer
+    sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>("0123456789AB"), 12);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(12, uartService->peek(spans), "wrong readable size");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE("0123456789AB", spans[0].data, 12, "wrong data");
+    uartService->consume(10);
+
+    sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>("CDEFGHIJ"), 8);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(10, uartService->peek(spans), "wrong readable size");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(6, spans[0].length, "wrong first span");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(4, spans[1].length, "wrong second span");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE("ABCDEF", spans[0].data, 6, "wrong first span data");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE("GHIJ", spans[1].data, 4, "wrong second span data");
+
+    // consuming more than is there only releases what was received
+    uartService->consume(100);
+    TEST_ASSERT_FALSE_MESSAGE(uartService->isReadable(), "data left after consume");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, uartService->peek(spans), "data left after consume");
+}
+
+void TestBLEUartServiceMessages() {
+    const uint8_t expectedFrame[] = {0xB5, 0x00, 0x05, 'h', 'e', 'l', 'l', 'o', 0x71, 0xAD};
+    const char message[] = "a message that wraps the receive buffer";
+    uint8_t frames[128], v[64];
+    BLEUartService::Span spans[2];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(64, 64);
+    Gap::Handle_t connection = fixture.connect();
+
+    // sync byte, big endian length, payload and CRC-16/CCITT of length and payload
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, uartService->sendMessage(reinterpret_cast<const uint8_t *>("hello"), 5),
+                                  "message not sent");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "notifications not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(expectedFrame), sim.receive(connection, frames, sizeof(frames)),
+                                  "wrong frame length");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expectedFrame, frames, sizeof(expectedFrame), "wrong frame");
+
+    // garbage, a valid frame, a corrupted frame and a frame wrapping around the end of the receive buffer
+    int size = 0;
+    frames[size++] = 'x';
+    frames[size++] = 'y';
+    memcpy(frames + size, expectedFrame, sizeof(expectedFrame));
+    size += sizeof(expectedFrame);
+    memcpy(frames + size, expectedFrame, sizeof(expectedFrame));
+    frames[size + 7] = 'p';
+    size += sizeof(expectedFrame);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(message), uartService->sendMessage(
+            reinterpret_cast<const uint8_t *>(message), sizeof(message)), "message not sent");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "notifications not processed");
+    size += sim.receive(connection, frames + size, static_cast<uint16_t>(sizeof(frames) - size));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2 + 2 * sizeof(expectedFrame) + sizeof(message) + BLEUartService::FRAME_OVERHEAD,
+                                  size, "wrong frame length");
+
+    // messages are only returned once they are complete, however they are split up
+    int received = 0;
+    for (int offset = 0; offset < size; offset += 7) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(EOF, uartService->receiveMessage(v, sizeof(v)), "incomplete message");
+        sim.write(connection, fixture.txHandle, frames + offset,
+                  static_cast<uint16_t>(size - offset < 7 ? size - offset : 7));
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+
+        if (!received && uartService->peekMessage(spans) != EOF) {
+            // a message longer than the buffer is truncated
+            TEST_ASSERT_EQUAL_INT_MESSAGE(5, spans[0].length + spans[1].length, "wrong message length");
+            TEST_ASSERT_EQUAL_INT_MESSAGE(5, uartService->receiveMessage(v, 3), "wrong message length");
+            TEST_ASSERT_EQUAL_MEMORY_MESSAGE("hel", v, 3, "wrong message");
+            received++;
+        }
+    }
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, received, "first message not received");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(sizeof(message), uartService->peekMessage(spans), "wrong message length");
+    TEST_ASSERT_TRUE_MESSAGE(spans[1].length > 0, "message does not wrap");
+    memcpy(v, spans[0].data, spans[0].length);
+    memcpy(v + spans[0].length, spans[1].data, spans[1].length);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(message, reinterpret_cast<char *>(v), "wrong message");
+    uartService->consumeMessage();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(EOF, uartService->receiveMessage(v, sizeof(v)), "unexpected message");
+    TEST_ASSERT_FALSE_MESSAGE(uartService->isReadable(), "data left after the last message");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2 + sizeof(expectedFrame), uartService->getRxStats().discarded,
+                                  "garbage and corrupted frame not discarded");
+}
+
+void TestBLEUartServiceRxOverflow() {
+    const BLEUartService::RxOverflowPolicy policies[] = {BLEUartService::RX_OVERFLOW_DROP_NEWEST,
+                                                         BLEUartService::RX_OVERFLOW_DROP_OLDEST,
+                                                         BLEUartService::RX_OVERFLOW_REJECT};
+    const char *expected[] = {"0123456789ABCDEF", "89ABCDEFGHIJKLMN", "0123456789AB"};
+    const int dropped[] = {8, 8, 0};
+    char v[32];
+    BLESim &sim = BLESim::getInstance();
+
+    for (int p = 0; p < 3; p++) {
+        UartFixture fixture;
+        BLEUartService *uartService = fixture.addService(16, 16, false, policies[p]);
+        Gap::Handle_t connection = fixture.connect();
+
+        // the second write only fits partially into the 16 byte buffer
+        sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>("0123456789AB"), 12);
+        sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>("CDEFGHIJKLMNOPQR"), 12);
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "writes not processed");
+
+        BLEUartService::RxStats stats = uartService->getRxStats();
+        TEST_ASSERT_EQUAL_INT_MESSAGE(dropped[p], stats.dropped, "wrong number of dropped bytes");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(p == 2 ? 12 : 24, stats.received, "wrong number of received bytes");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(p == 2 ? 1 : 0, stats.rejected, "wrong number of rejected writes");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(p == 2 ? 1 : 0, sim.stats(connection).rejected, "central not told");
+
+        int len = uartService->read(reinterpret_cast<uint8_t *>(v), sizeof(v) - 1);
+        v[len] = '\0';
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(expected[p], v, "wrong data kept");
+
+        if (policies[p] == BLEUartService::RX_OVERFLOW_REJECT) {
+            // with space available the central's retry is accepted
+            sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>("CDEFGHIJKLMNOPQR"), 12);
+            TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+            v[uartService->read(reinterpret_cast<uint8_t *>(v), sizeof(v) - 1)] = '\0';
+            TEST_ASSERT_EQUAL_STRING_MESSAGE("CDEFGHIJKLMN", v, "retried write not received");
+        }
+
+        fixture.stop();
+        sim.reset();
+    }
+}
+
+static Gap::Handle_t delayedConnection;
+static GattAttribute::Handle_t delayedHandle;
+
+static void writeDelayed() {
+    Thread::wait(50);
+    BLESim::getInstance().write(delayedConnection, delayedHandle, reinterpret_cast<const uint8_t *>("DELAYED"), 7);
+}
+
+static volatile int readableCalls = 0;
+static BLEUartService *readableService = NULL;
+
+static void onReadable() {
+    char v[32];
+    readableCalls++;
+    while (readableService->read(reinterpret_cast<uint8_t *>(v), sizeof(v)) > 0) /* drain */;
+}
+
+void TestBLEUartServiceReadBlocking() {
+    char v[128];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 128);
+
+    Gap::Handle_t connection = fixture.connect();
+
+    // nothing received, the read times out
+    Timer timer;
+    timer.start();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, uartService->read(reinterpret_cast<uint8_t *>(v), sizeof(v), 50),
+                                  "read without data");
+    TEST_ASSERT_TRUE_MESSAGE(timer.read_ms() >= 45, "read returned before the timeout");
+
+    // the reading thread sleeps until the data arrives
+    delayedConnection = connection;
+    delayedHandle = fixture.txHandle;
+    Thread writer;
+    writer.start(callback(writeDelayed));
+    int len = uartService->read(reinterpret_cast<uint8_t *>(v), sizeof(v) - 1, 5000);
+    writer.join();
+    v[len > 0 ? len : 0] = '\0';
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("DELAYED", v, "wrong message received");
+
+    // the read returns while the BLE thread may still be in the write callback
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+}
+
+void TestBLEUartServiceOnReadable() {
+    BLESim &sim = BLESim::getInstance();
+    EventQueue queue(8 * EVENTS_EVENT_SIZE);
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 128);
+    readableService = uartService;
+    readableCalls = 0;
+    uartService->onReadable(&queue, onReadable);
+
+    Gap::Handle_t connection = fixture.connect();
+
+    // several writes before the queue runs result in a single callback
+    for (int i = 0; i < 3; i++) sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>("DATA"), 4);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "writes not processed");
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, readableCalls, "readable callback not posted once");
+    TEST_ASSERT_FALSE_MESSAGE(uartService->isReadable(), "data not read in callback");
+
+    // once it ran, new data posts the callback again
+    sim.write(connection, fixture.txHandle, reinterpret_cast<const uint8_t *>("DATA"), 4);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+    queue.dispatch(0);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, readableCalls, "readable callback not posted again");
+
+    uartService->onReadable(NULL, NULL);
+}
+
+#define STREAM_SIZE 8192
+
+static GattAttribute::Handle_t streamHandles[2];
+static uint8_t streamReceived[2][STREAM_SIZE];
+static size_t streamLength[2];
+
+static void onStreamNotification(const BLESim::Notification *notification) {
+    for (int i = 0; i < 2; i++) {
+        if (notification->handle != streamHandles[i]) continue;
+        size_t len = notification->len;
+        if (streamLength[i] + len > STREAM_SIZE) len = STREAM_SIZE - streamLength[i];
+        memcpy(streamReceived[i] + streamLength[i], notification->data, len);
+        streamLength[i] += len;
+    }
+}
+
+static BLEUartService *streamService;
+static uint8_t streamData[2][STREAM_SIZE];
+
+static void sendStream() {
+    streamService->send(streamData[0], STREAM_SIZE);
+}
+
+void TestBLEUartServiceMultipleServices() {
+    GattAttribute::Handle_t txHandles[2];
+    BLESim &sim = BLESim::getInstance();
+
+    // a control channel and a bulk data channel
+    UartFixture fixture;
+    BLEUartService *control = fixture.addService(128, 128);
+    BLEUartService *bulk = fixture.addService(128, 1024);
+
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_TRUE_MESSAGE(connection != BLESim::INVALID_CONNECTION, "connection failed");
+    for (unsigned i = 0; i < 2; i++) {
+        txHandles[i] = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID), i);
+        streamHandles[i] = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID), i);
+        TEST_ASSERT_TRUE_MESSAGE(txHandles[i] != GattAttribute::INVALID_HANDLE, "TX characteristic not found");
+        TEST_ASSERT_TRUE_MESSAGE(streamHandles[i] != GattAttribute::INVALID_HANDLE, "RX characteristic not found");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connection, streamHandles[i]), "subscribe failed");
+        streamLength[i] = 0;
+    }
+    TEST_ASSERT_TRUE_MESSAGE(streamHandles[0] != streamHandles[1], "services share a characteristic");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+
+    // writes only reach the service they are addressed to
+    sim.write(connection, txHandles[0], reinterpret_cast<const uint8_t *>("CONTROL"), 7);
+    sim.write(connection, txHandles[1], reinterpret_cast<const uint8_t *>("BULK"), 4);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "writes not processed");
+    char v[16];
+    v[control->read(reinterpret_cast<uint8_t *>(v), sizeof(v) - 1)] = '\0';
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("CONTROL", v, "wrong control data");
+    v[bulk->read(reinterpret_cast<uint8_t *>(v), sizeof(v) - 1)] = '\0';
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("BULK", v, "wrong bulk data");
+
+    // both services stream at the same time, sharing the stack buffers
+    for (size_t i = 0; i < STREAM_SIZE; i++) {
+        streamData[0][i] = static_cast<uint8_t>(i * 3);
+        streamData[1][i] = static_cast<uint8_t>(i * 5 + 1);
+    }
+    sim.onNotification(onStreamNotification);
+    streamService = control;
+    Thread sender;
+    sender.start(callback(sendStream));
+    TEST_ASSERT_EQUAL_INT_MESSAGE(STREAM_SIZE, bulk->send(streamData[1], STREAM_SIZE), "bulk send failed");
+    sender.join();
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "sends not processed");
+    sim.onNotification(NULL);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(STREAM_SIZE, streamLength[0], "control data missing");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(STREAM_SIZE, streamLength[1], "bulk data missing");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(streamData[0], streamReceived[0], STREAM_SIZE, "wrong control stream");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(streamData[1], streamReceived[1], STREAM_SIZE, "wrong bulk stream");
+}
+
+void TestBLEUartServicePerConnection() {
+    char v[32];
+    Gap::Handle_t connections[2];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    fixture.config.maxConnections = 2;
+    BLEUartService *uartService = fixture.addService(128, 128, true);
+
+    GattAttribute::Handle_t txHandle = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID));
+    GattAttribute::Handle_t rxHandle = sim.findCharacteristic(UUID(UARTServiceRXCharacteristicUUID));
+    for (int i = 0; i < 2; i++) {
+        connections[i] = sim.connect();
+        TEST_ASSERT_TRUE_MESSAGE(connections[i] != BLESim::INVALID_CONNECTION, "connection failed");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.subscribe(connections[i], rxHandle), "subscribe failed");
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+    }
+
+    // data from each peer ends up in its own buffer
+    sim.write(connections[0], txHandle, reinterpret_cast<const uint8_t *>("PHONE0"), 6);
+    sim.write(connections[1], txHandle, reinterpret_cast<const uint8_t *>("PHONE1"), 6);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "writes not processed");
+    // the shared receive methods agree that there is nothing in the shared buffer
+    TEST_ASSERT_FALSE_MESSAGE(uartService->isReadable(), "peer data readable from the shared buffer");
+    TEST_ASSERT_FALSE_MESSAGE(uartService->waitReadable(10), "peer data awaited in the shared buffer");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, uartService->read(reinterpret_cast<uint8_t *>(v), sizeof(v)),
+                                  "peer data read from the shared buffer");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(EOF, uartService->getc(), "peer data read from the shared buffer");
+    BLEUartService::Span spans[2];
+    TEST_ASSERT_EQUAL_INT_MESSAGE(6, uartService->peek(connections[0], spans), "peer data not peeked");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE("PHONE0", spans[0].data, spans[0].length, "wrong peer data peeked");
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(uartService->isReadable(connections[i]), "peer data not readable");
+        v[uartService->read(connections[i], reinterpret_cast<uint8_t *>(v), sizeof(v) - 1)] = '\0';
+        TEST_ASSERT_EQUAL_STRING_MESSAGE(i ? "PHONE1" : "PHONE0", v, "wrong peer data");
+    }
+
+    // sends only go to the addressed peer
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, uartService->send(connections[1], reinterpret_cast<const uint8_t *>("HELLO"), 5),
+                                  "send failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim.available(connections[0]), "other peer received data");
+    v[sim.receive(connections[1], reinterpret_cast<uint8_t *>(v), sizeof(v) - 1)] = '\0';
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("HELLO", v, "wrong data received");
+
+    // a disconnected peer has no buffers anymore
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.disconnect(connections[0]), "disconnect failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "disconnection not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(EOF, uartService->send(connections[0], reinterpret_cast<const uint8_t *>("X"), 1),
+                                  "sent to disconnected peer");
+}
+
+void TestBLEUartServicePerConnectionFull() {
+    const BLEUartService::RxOverflowPolicy policies[] = {BLEUartService::RX_OVERFLOW_DROP_NEWEST,
+                                                         BLEUartService::RX_OVERFLOW_REJECT};
+    BLESim &sim = BLESim::getInstance();
+    BLEManager &bleManager = BLEManager::getInstance();
+    BLEConfig config(DEVICE_NAME, 10, 0, 2);
+
+    for (int p = 0; p < 2; p++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(&config), "BLE manager init failed");
+        // channels for one peer only, the second one has no buffers
+        BLEStaticUartService<32, 32, 1> *uartService = new BLEStaticUartService<32, 32, 1>(BLE::Instance(),
+                                                                                            policies[p]);
+        GattAttribute::Handle_t txHandle = sim.findCharacteristic(UUID(UARTServiceTXCharacteristicUUID));
+        Gap::Handle_t connections[2];
+        for (int i = 0; i < 2; i++) {
+            connections[i] = sim.connect();
+            TEST_ASSERT_TRUE_MESSAGE(connections[i] != BLESim::INVALID_CONNECTION, "connection failed");
+            TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "connection events not processed");
+        }
+
+        sim.write(connections[1], txHandle, reinterpret_cast<const uint8_t *>("PHONE1"), 6);
+        TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+        BLEUartService::RxStats stats = uartService->getRxStats();
+        if (policies[p] == BLEUartService::RX_OVERFLOW_REJECT) {
+            TEST_ASSERT_EQUAL_INT_MESSAGE(1, stats.rejected, "write without channel not rejected");
+            TEST_ASSERT_EQUAL_INT_MESSAGE(1, sim.stats(connections[1]).rejected, "central not told");
+        } else {
+            TEST_ASSERT_EQUAL_INT_MESSAGE(6, stats.dropped, "write without channel not counted as dropped");
+        }
+
+        // the GATT server points to the characteristics until it is shut down
+        bleManager.deinit();
+        delete uartService;
+    }
+}
+
+void TestBLEUartServiceStream() {
+    const char text[] = "The quick brown fox jumps over the lazy dog";
+    char v[128];
+    BLESim &sim = BLESim::getInstance();
+
+    UartFixture fixture;
+    BLEUartService *uartService = fixture.addService(128, 256);
+    BLEUartStream *stream = new BLEUartStream(*uartService, 0);
+
+    Gap::Handle_t connection = fixture.connect();
+
+    // character by character, like putc() from printf(), fills whole notifications
+    for (size_t i = 0; i < strlen(text); i++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(1, stream->write(text + i, 1), "write failed");
+    }
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, sim.stats(connection).notifications, "characters not coalesced");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(40, sim.available(connection), "full notifications not sent");
+
+    // the newline sends the rest of the line
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, stream->write("\n", 1), "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, sim.stats(connection).notifications, "line not flushed");
+    uint16_t len = sim.receive(connection, reinterpret_cast<uint8_t *>(v), sizeof(v) - 1);
+    v[len] = '\0';
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("The quick brown fox jumps over the lazy dog\n", v, "wrong text received");
+
+    // a prompt stays buffered until sync()
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, stream->write("> ", 2), "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim.available(connection), "prompt sent early");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stream->sync(), "sync failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, sim.receive(connection, reinterpret_cast<uint8_t *>(v), sizeof(v)),
+                                  "prompt not flushed");
+
+    // input is read like from a serial port
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stream->poll(POLLIN), "readable without input");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE,
+                                  sim.write(connection, fixture.txHandle,
+                                            reinterpret_cast<const uint8_t *>("help\n"), 5),
+                                  "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(POLLIN, stream->poll(POLLIN), "input not readable");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, stream->read(v, sizeof(v)), "wrong input length");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE("help\n", v, 5, "wrong input");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stream->set_blocking(false), "set_blocking failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(-EAGAIN, stream->read(v, sizeof(v)), "non-blocking read blocked");
+    delete stream;
+
+    // output without a newline goes out within the maximum latency
+    stream = new BLEUartStream(*uartService, 20);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, stream->write("abc", 3), "write failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, sim.available(connection), "sent before the maximum latency");
+    Thread::wait(100);
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "send not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, sim.receive(connection, reinterpret_cast<uint8_t *>(v), sizeof(v)),
+                                  "not flushed after the maximum latency");
+
+    // without a peer the output is dropped instead of blocking the logger
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.disconnect(connection), "disconnect failed");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "disconnect not processed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(strlen(text), stream->write(text, strlen(text)), "write failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, stream->close(), "close failed");
+
+    delete stream;
+}
+
+void case_teardown_handler() {
+    printf("BLEManager::getInstance().deinit()\r\n");
+    BLEManager::getInstance().deinit();
+    BLESim::getInstance().reset();
+}
+
+int main() {
+    nativetest::Case cases[] = {
+            {"Test ble-uart-discover", TestBLEUartServiceDiscoverCharacteristics},
+            {"Test ble-uart-receive", TestBLEUartServiceReceiveData},
+            {"Test ble-uart-send", TestBLEUartServiceSendData},
+            {"Test ble-uart-send-fragmented", TestBLEUartServiceSendFragmented},
+            {"Test ble-uart-send-async", TestBLEUartServiceSendAsync},
+            {"Test ble-uart-send-backpressure", TestBLEUartServiceSendBackpressure},
+            {"Test ble-uart-latency", TestBLEUartServiceLatency},
+            {"Test ble-uart-stats", TestBLEUartServiceStats},
+            {"Test ble-uart-stream", TestBLEUartServiceStream},
+            {"Test ble-uart-peek-consume", TestBLEUartServicePeekConsume},
+            {"Test ble-uart-messages", TestBLEUartServiceMessages},
+            {"Test ble-uart-rx-overflow", TestBLEUartServiceRxOverflow},
+            {"Test ble-uart-read-blocking", TestBLEUartServiceReadBlocking},
+            {"Test ble-uart-on-readable", TestBLEUartServiceOnReadable},
+            {"Test ble-uart-multiple-services", TestBLEUartServiceMultipleServices},
+            {"Test ble-uart-per-connection", TestBLEUartServicePerConnection},
+            {"Test ble-uart-per-connection-full", TestBLEUartServicePerConnectionFull},
+    };
+
+    return nativetest::run(cases, sizeof(cases) / sizeof(cases[0]), case_teardown_handler);
+}
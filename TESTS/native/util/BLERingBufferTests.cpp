@@ -0,0 +1,250 @@
+/*!
+ * @file
+ * @brief Native test for the lock-free ring buffer
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <mbed.h>
+#include <BLERingBuffer.h>
+
+#include "nativetest.h"
+
+#define STRESS_BYTES (8 * 1024 * 1024)
+
+static uint8_t storage[256];
+static BLERingBuffer<uint8_t> ring;
+
+void TestBLERingBufferPushPop() {
+    ring.init(storage, 8);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, ring.capacity(), "wrong capacity");
+    TEST_ASSERT_TRUE_MESSAGE(ring.empty(), "new ring not empty");
+
+    // the full capacity is usable
+    for (uint8_t i = 0; i < 8; i++) TEST_ASSERT_TRUE_MESSAGE(ring.push(i), "push failed");
+    TEST_ASSERT_FALSE_MESSAGE(ring.push(8), "push into full ring");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, ring.space(), "full ring has space");
+
+    uint8_t c;
+    for (uint8_t i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE_MESSAGE(ring.pop(c), "pop failed");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(i, c, "wrong element");
+    }
+    TEST_ASSERT_FALSE_MESSAGE(ring.pop(c), "pop from empty ring");
+}
+
+void TestBLERingBufferWrapAround() {
+    uint8_t data[6] = {1, 2, 3, 4, 5, 6}, out[8];
+    const uint8_t *span;
+    ring.init(storage, 8);
+
+    // move the indices so the next write wraps around
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, ring.write(data, 5), "write failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, ring.read(out, 8), "read failed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(6, ring.write(data, 6), "wrapped write failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, ring.write(data, 6), "write beyond capacity");
+
+    // the readable data is split into two spans at the end of the storage
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, ring.readSpan(&span), "wrong first span");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, span, 3, "wrong first span data");
+    ring.consume(3);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, ring.readSpan(&span), "wrong second span");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data + 3, span, 3, "wrong second span data");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, span + 3, 2, "wrong second span data");
+    ring.consume(5);
+    TEST_ASSERT_TRUE_MESSAGE(ring.empty(), "ring not empty");
+}
+
+void TestBLERingBufferPeek() {
+    uint8_t data[6] = {1, 2, 3, 4, 5, 6}, out[8];
+    BLERingBuffer<uint8_t>::Span spans[2];
+    ring.init(storage, 8);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, ring.peek(spans), "data in empty ring");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, spans[0].length + spans[1].length, "spans of empty ring not empty");
+
+    // contiguous data is returned in the first span only
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, ring.write(data, 5), "write failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, ring.peek(spans), "wrong readable size");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, spans[0].length, "wrong first span");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, spans[1].length, "second span used");
+    TEST_ASSERT_EQUAL_PTR_MESSAGE(storage, spans[0].data, "span not in place");
+    ring.consume(5);
+
+    // wrapped data is split at the end of the storage, peeking does not remove it
+    TEST_ASSERT_EQUAL_INT_MESSAGE(6, ring.write(data, 6), "wrapped write failed");
+    for (int i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(6, ring.peek(spans), "wrong readable size");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(3, spans[0].length, "wrong first span");
+        TEST_ASSERT_EQUAL_INT_MESSAGE(3, spans[1].length, "wrong second span");
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, spans[0].data, 3, "wrong first span data");
+        TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data + 3, spans[1].data, 3, "wrong second span data");
+    }
+
+    // a partial consume moves the spans
+    ring.consume(4);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, ring.peek(spans), "wrong readable size after consume");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data + 4, spans[0].data, 2, "wrong data after consume");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, ring.read(out, 8), "read failed");
+    TEST_ASSERT_TRUE_MESSAGE(ring.empty(), "ring not empty");
+}
+
+void TestBLERingBufferOverwrite() {
+    uint8_t data[12] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12}, out[8];
+    uint32_t dropped = 0;
+    ring.init(storage, 8);
+    ring.enableOverwrite();
+
+    // while there is space nothing is discarded
+    TEST_ASSERT_EQUAL_INT_MESSAGE(5, ring.overwrite(data, 5, &dropped), "write failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, dropped, "data dropped with free space");
+
+    // the oldest elements make space for the new ones
+    TEST_ASSERT_EQUAL_INT_MESSAGE(6, ring.overwrite(data + 5, 6, &dropped), "overwrite failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(3, dropped, "wrong number of dropped elements");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, ring.read(out, 8), "read failed");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data + 3, out, 8, "oldest elements not dropped");
+
+    // more than the capacity keeps the last elements only
+    dropped = 0;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, ring.overwrite(data, 12, &dropped), "overwrite failed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(4, dropped, "wrong number of dropped elements");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, ring.read(out, 8), "read failed");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data + 4, out, 8, "wrong elements kept");
+
+    // peeked data that was discarded meanwhile is reported by consume
+    BLERingBuffer<uint8_t>::Span spans[2];
+    ring.overwrite(data, 8, &dropped);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, ring.peek(spans), "wrong readable size");
+    ring.overwrite(data, 2, &dropped);
+    TEST_ASSERT_FALSE_MESSAGE(ring.consume(8), "discarded data not reported");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, ring.size(), "new data consumed");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(2, ring.read(out, 8), "read failed");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(data, out, 2, "wrong new data");
+}
+
+static uint32_t sequenceStorage[64];
+static BLERingBuffer<uint32_t> sequenceRing;
+
+static void produceOverwriting() {
+    uint32_t chunk[16], dropped = 0;
+    for (uint32_t sequence = 1; sequence <= STRESS_BYTES / 4;) {
+        uint32_t size = sequence % 13 + 1;
+        for (uint32_t i = 0; i < size; i++) chunk[i] = sequence + i;
+        sequence += sequenceRing.overwrite(chunk, size, &dropped);
+    }
+}
+
+void TestBLERingBufferOverwriteStress() {
+    sequenceRing.init(sequenceStorage, 64);
+    sequenceRing.enableOverwrite();
+
+    Thread producer;
+    producer.start(callback(produceOverwriting));
+
+    // whatever is dropped, the consumer must never see a stale or torn element
+    uint32_t last = 0, errors = 0, size = 1, chunk[16];
+    while (last < STRESS_BYTES / 4) {
+        size = size % 15 + 1;
+        if (size % 3 == 0) {
+            BLERingBuffer<uint32_t>::Span spans[2];
+            uint32_t n = sequenceRing.peek(spans);
+            if (n > size) n = size;
+            uint32_t first = n < spans[0].length ? n : spans[0].length;
+            memcpy(chunk, spans[0].data, first * sizeof(uint32_t));
+            memcpy(chunk + first, spans[1].data, (n - first) * sizeof(uint32_t));
+            // in place data is only valid if nothing was discarded meanwhile
+            if (!sequenceRing.consume(n)) continue;
+            size = n;
+        } else {
+            size = sequenceRing.read(chunk, size);
+        }
+        for (uint32_t i = 0; i < size; i++) {
+            if (chunk[i] <= last) errors++;
+            last = chunk[i];
+        }
+        if (!size) Thread::yield();
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, errors, "stale elements read from overwritten ring");
+}
+
+static void produce() {
+    uint8_t chunk[64];
+    uint32_t written = 0, size = 1;
+    while (written < STRESS_BYTES) {
+        size = size % 61 + 1;
+        if (size > STRESS_BYTES - written) size = STRESS_BYTES - written;
+        for (uint32_t i = 0; i < size; i++) chunk[i] = static_cast<uint8_t>((written + i) * 31 + ((written + i) >> 8));
+
+        // single elements and bulk writes use the same index protocol
+        uint32_t n = size == 1 ? (ring.push(chunk[0]) ? 1 : 0) : ring.write(chunk, size);
+        written += n;
+        if (!n) Thread::yield();
+    }
+}
+
+void TestBLERingBufferStress() {
+    uint8_t chunk[64];
+    ring.init(storage, sizeof(storage));
+
+    Thread producer;
+    producer.start(callback(produce));
+
+    uint32_t read = 0, size = 1, errors = 0;
+    while (read < STRESS_BYTES) {
+        size = size % 53 + 1;
+        const uint8_t *span;
+        uint32_t n;
+        if (size % 3 == 0) {
+            n = ring.readSpan(&span);
+            if (n > size) n = size;
+            memcpy(chunk, span, n);
+            ring.consume(n);
+        } else {
+            n = ring.read(chunk, size);
+        }
+        for (uint32_t i = 0; i < n; i++) {
+            if (chunk[i] != static_cast<uint8_t>((read + i) * 31 + ((read + i) >> 8))) errors++;
+        }
+        read += n;
+        if (!n) Thread::yield();
+    }
+    producer.join();
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(0, errors, "data corrupted between producer and consumer");
+    TEST_ASSERT_TRUE_MESSAGE(ring.empty(), "ring not empty");
+}
+
+int main() {
+    nativetest::Case cases[] = {
+            {"Test ring-push-pop", TestBLERingBufferPushPop},
+            {"Test ring-wrap-around", TestBLERingBufferWrapAround},
+            {"Test ring-peek", TestBLERingBufferPeek},
+            {"Test ring-overwrite", TestBLERingBufferOverwrite},
+            {"Test ring-stress", TestBLERingBufferStress},
+            {"Test ring-overwrite-stress", TestBLERingBufferOverwriteStress},
+    };
+
+    return nativetest::run(cases, sizeof(cases) / sizeof(cases[0]));
+}
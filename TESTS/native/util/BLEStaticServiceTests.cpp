@@ -0,0 +1,106 @@
+/*!
+ * @file
+ * @brief Native test for the heap-free GATT service templates
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <BLEManager.h>
+#include <BLESim.h>
+#include <BLEStaticService.h>
+
+#include "nativetest.h"
+
+#define DEVICE_NAME "STATIC"
+
+// a battery service, declared completely at compile time
+static BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
+                               GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY, 1> batteryLevel(0x2A19, 1);
+static BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
+                               GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE, 8> batteryLabel(0x2A1A);
+static BLEStaticService<2> batteryService(0x180F);
+
+void TestBLEStaticServiceAdd() {
+    uint8_t value[8];
+    uint16_t length = sizeof(value);
+    BLESim &sim = BLESim::getInstance();
+    BLE &ble = BLE::Instance();
+
+    BLEConfig config(DEVICE_NAME);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+
+    batteryLevel.value[0] = 42;
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, batteryService.add(batteryLevel).add(batteryLabel).addTo(ble),
+                                  "service not added");
+    TEST_ASSERT_TRUE_MESSAGE(sim.hasService(UUID(0x180F)), "service not found");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(batteryLevel.getValueHandle(), sim.findCharacteristic(UUID(0x2A19)),
+                                  "level handle not set");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(batteryLabel.getValueHandle(), sim.findCharacteristic(UUID(0x2A1A)),
+                                  "label handle not set");
+
+    // the initial value is taken from the characteristic
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, ble.gattServer().read(batteryLevel.getValueHandle(), value, &length),
+                                  "level not readable");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(1, length, "wrong level length");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(42, value[0], "wrong initial level");
+
+    // the maximum length is the size of the value buffer
+    Gap::Handle_t connection = sim.connect();
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, sim.write(connection, batteryLabel.getValueHandle(),
+                                                            reinterpret_cast<const uint8_t *>("internal"), 8),
+                                  "label not writable");
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_PARAM,
+                                  sim.write(connection, batteryLabel.getValueHandle(),
+                                            reinterpret_cast<const uint8_t *>("too long!"), 9),
+                                  "label longer than its buffer accepted");
+    TEST_ASSERT_TRUE_MESSAGE(sim.flush(), "write not processed");
+    length = sizeof(value);
+    ble.gattServer().read(batteryLabel.getValueHandle(), value, &length);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(8, length, "wrong label length");
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE("internal", value, 8, "wrong label");
+}
+
+void TestBLEStaticServiceIncomplete() {
+    BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ, 4> counter(0x2A1B);
+    BLEStaticService<2> service(0x181F);
+
+    BLEConfig config(DEVICE_NAME);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, BLEManager::getInstance().init(&config), "BLE init failed");
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_INVALID_STATE, service.add(counter).addTo(BLE::Instance()),
+                                  "incomplete service added");
+    TEST_ASSERT_FALSE_MESSAGE(BLESim::getInstance().hasService(UUID(0x181F)), "incomplete service registered");
+    TEST_ASSERT_TRUE_MESSAGE(service.getCharacteristic(1) == NULL, "unset table entry");
+}
+
+void case_teardown_handler() {
+    BLEManager::getInstance().deinit();
+    BLESim::getInstance().reset();
+}
+
+int main() {
+    nativetest::Case cases[] = {
+            {"Test static-service-add", TestBLEStaticServiceAdd},
+            {"Test static-service-incomplete", TestBLEStaticServiceIncomplete},
+    };
+
+    return nativetest::run(cases, sizeof(cases) / sizeof(cases[0]), case_teardown_handler);
+}
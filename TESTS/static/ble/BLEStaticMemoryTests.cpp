@@ -0,0 +1,83 @@
+/*!
+ * @file
+ * @brief Heap-free UART service on the target, mbedgt reports its footprint
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <sdk_common.h>
+#include <BLEManager.h>
+#include <services/BLEUartService.h>
+
+#include "utest/utest.h"
+#include "unity/unity.h"
+#include "greentea-client/test_env.h"
+#include "../../ble/testhelper.h"
+
+using namespace utest::v1;
+
+#define DEVICE_NAME "ST4TIC"
+
+#if !BLE_STATIC_MEMORY
+#error "build with --app-config TESTS/static/settings.json, it defines BLE_STATIC_MEMORY=1"
+#endif
+
+void TestBLEStaticMemoryUart() {
+    char k[48], v[128];
+    BLEManager &bleManager = BLEManager::getInstance();
+
+    // the name variant keeps the config in static memory, the buffers are part of the service
+    TEST_ASSERT_EQUAL_INT_MESSAGE(BLE_ERROR_NONE, bleManager.init(DEVICE_NAME), "BLE manager initialization failed");
+    BLEStaticUartService<128, 128> uart(BLE::Instance());
+
+    greentea_send_kv("discover", DEVICE_NAME);
+    greentea_parse_kv(k, v, sizeof(k), sizeof(v));
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(DEVICE_NAME, v, "BLE device discovery failed");
+}
+
+utest::v1::status_t case_teardown_handler(const Case *const source, const size_t passed, const size_t failed,
+                                          const failure_t reason) {
+    printf("BLEManager::getInstance().deinit()\r\n");
+    BLEManager::getInstance().deinit();
+    return greentea_case_teardown_handler(source, passed, failed, reason);
+}
+
+utest::v1::status_t greentea_failure_handler(const Case *const source, const failure_t reason) {
+    greentea_case_failure_abort_handler(source, reason);
+    return STATUS_CONTINUE;
+}
+
+utest::v1::status_t greentea_test_setup(const size_t number_of_cases) {
+    GREENTEA_SETUP(120, "BLEManagerTests");
+    return verbose_test_setup_handler(number_of_cases);
+}
+
+int main() {
+    bleClockInit();
+
+    Case cases[] = {
+            Case("Test ble-static-uart", TestBLEStaticMemoryUart,
+                 case_teardown_handler, greentea_failure_handler),
+    };
+
+    Specification specification(greentea_test_setup, cases, greentea_test_teardown_handler);
+    return !Harness::run(specification);
+}
@@ -28,11 +28,21 @@
  */
 
 #include "BLEConfig.h"
+#include "BLEManager.h"
 
-BLEConfig::BLEConfig(const char *deviceName, uint16_t advertisingInterval, uint16_t advertisingTimeout) {
+BLEConfig::BLEConfig(const char *deviceName, uint16_t advertisingInterval, uint16_t advertisingTimeout,
+                     uint8_t maxConnections) {
     this->deviceName = deviceName;
     this->advertisingInterval = advertisingInterval;
     this->advertisingTimeout = advertisingTimeout;
+    this->maxConnections = maxConnections;
+    this->fastAdvertisingInterval = 30;
+    this->fastAdvertisingTimeout = 0;
+    this->nameInScanResponse = false;
+    this->connectionProfile = PROFILE_CENTRAL;
+    this->dataLength = BLE_DEFAULT_DATA_LENGTH;
+    this->preferredPhys = ble::phy_set_t(ble::phy_set_t::PHY_SET_1M);
+    this->fastAdvertising = false;
 }
 
 ble_error_t BLEConfig::onInit(BLE &ble) {
@@ -40,6 +50,7 @@ ble_error_t BLEConfig::onInit(BLE &ble) {
 
     ble.gap().onConnection(this, &BLEConfig::onConnection);
     ble.gap().onDisconnection(this, &BLEConfig::onDisconnection);
+    ble.gap().onTimeout(Gap::TimeoutEventCallback_t(this, &BLEConfig::onTimeout));
 
 //    error = ble.gap().setAddress(BLEProtocol::AddressType::RANDOM_PRIVATE_RESOLVABLE, {0});
 //    BLE_ASSERT(error, "address type");
@@ -51,22 +62,99 @@ ble_error_t BLEConfig::onInit(BLE &ble) {
                                                    GapAdvertisingData::LE_GENERAL_DISCOVERABLE);
     BLE_ASSERT(error, "adv payload");
 
-    error = ble.gap().accumulateAdvertisingPayload(GapAdvertisingData::COMPLETE_LOCAL_NAME,
-                                                   (uint8_t *) this->deviceName,
-    static_cast<uint8_t>(strlen(this->deviceName)));
+    if (this->nameInScanResponse) {
+        error = ble.gap().accumulateScanResponse(GapAdvertisingData::COMPLETE_LOCAL_NAME,
+                                                 (uint8_t *) this->deviceName,
+        static_cast<uint8_t>(strlen(this->deviceName)));
+    } else {
+        error = ble.gap().accumulateAdvertisingPayload(GapAdvertisingData::COMPLETE_LOCAL_NAME,
+                                                       (uint8_t *) this->deviceName,
+        static_cast<uint8_t>(strlen(this->deviceName)));
+    }
     BLE_ASSERT(error, "local name");
 
+    Gap::ConnectionParams_t params;
+    if (getConnectionParams(this->connectionProfile, &params)) {
+        error = ble.gap().setPreferredConnectionParams(&params);
+        BLE_ASSERT(error, "preferred connection params");
+    }
+
+    // LE 1M needs no preference, stacks without the PHY update procedure do not implement it
+    if (this->preferredPhys.get_2m() || this->preferredPhys.get_coded()) {
+        error = ble.gap().setPreferredPhys(&this->preferredPhys, &this->preferredPhys);
+        if (error != BLE_ERROR_NOT_IMPLEMENTED) BLE_ASSERT(error, "preferred phys");
+    }
+
     ble.gap().setAdvertisingType(GapAdvertisingParams::ADV_CONNECTABLE_UNDIRECTED);
-    ble.gap().setAdvertisingInterval(this->advertisingInterval);
-    ble.gap().setAdvertisingTimeout(this->advertisingTimeout);
 
-    return ble.gap().startAdvertising();
+    return startAdvertising(true);
 }
 
-void BLEConfig::onConnection(const Gap::ConnectionCallbackParams_t *params) {}
+ble_error_t BLEConfig::startAdvertising(bool fast) {
+    Gap &gap = BLE::Instance().gap();
+
+    // the parameters can only be changed while not advertising
+    if (gap.getState().advertising) gap.stopAdvertising();
+
+    this->fastAdvertising = fast && this->fastAdvertisingTimeout;
+    if (this->fastAdvertising) {
+        gap.setAdvertisingInterval(this->fastAdvertisingInterval);
+        gap.setAdvertisingTimeout(this->fastAdvertisingTimeout);
+    } else {
+        gap.setAdvertisingInterval(this->advertisingInterval);
+        gap.setAdvertisingTimeout(this->advertisingTimeout);
+    }
+    return gap.startAdvertising();
+}
+
+void BLEConfig::onConnection(const Gap::ConnectionCallbackParams_t *params) {
+    (void) params;
+    // the stack stops advertising on a connection, continue if more peers may connect
+    // (the manager has already added this connection, see the ordering in BLEConfig.h)
+    if (BLEManager::getInstance().getConnectionCount() < this->maxConnections) {
+        BLE_STATS_INC(advertisingRestarts);
+        startAdvertising(false);
+    }
+}
 
 void BLEConfig::onDisconnection(const Gap::DisconnectionCallbackParams_t *params) {
-    // restart advertising if connection is lost
-    BLE::Instance().gap().startAdvertising();
+    (void) params;
+    // restart advertising if connection is lost, fast as the peer probably wants to reconnect
+    BLE_STATS_INC(advertisingRestarts);
+    startAdvertising(true);
+}
+
+void BLEConfig::onTimeout(Gap::TimeoutSource_t source) {
+    // after the fast phase continue slowly, the slow phase ends advertising
+    if (source == Gap::TIMEOUT_SRC_ADVERTISING && this->fastAdvertising) {
+        BLE_STATS_INC(advertisingRestarts);
+        startAdvertising(false);
+    }
 }
 
+
+bool BLEConfig::getConnectionParams(ConnectionProfile profile, Gap::ConnectionParams_t *params) {
+    // intervals in 1.25ms units, supervision timeout in 10ms units
+    switch (profile) {
+        case PROFILE_BULK:
+            params->minConnectionInterval = 12;
+            params->maxConnectionInterval = 24;
+            params->slaveLatency = 0;
+            params->connectionSupervisionTimeout = 400;
+            return true;
+        case PROFILE_LOW_LATENCY:
+            params->minConnectionInterval = 12;
+            params->maxConnectionInterval = 12;
+            params->slaveLatency = 0;
+            params->connectionSupervisionTimeout = 200;
+            return true;
+        case PROFILE_LOW_POWER:
+            params->minConnectionInterval = 80;
+            params->maxConnectionInterval = 160;
+            params->slaveLatency = 4;
+            params->connectionSupervisionTimeout = 600;
+            return true;
+        default:
+            return false;
+    }
+}
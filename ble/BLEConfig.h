@@ -40,26 +40,126 @@
 
 class BLEConfig {
 public:
+    /**
+     * Connection parameter sets requested from the central, see
+     * getConnectionParams() for the values.
+     */
+    enum ConnectionProfile {
+        /** keep the parameters the central chose when connecting */
+        PROFILE_CENTRAL,
+        /** short intervals without slave latency, for streaming data */
+        PROFILE_BULK,
+        /** the shortest interval and supervision timeout, for interactive use */
+        PROFILE_LOW_LATENCY,
+        /** long intervals with slave latency, for idle connections */
+        PROFILE_LOW_POWER
+    };
+
     const char *deviceName;
+    /** the (slow) advertising interval in ms */
     uint16_t advertisingInterval;
+    /** how long to advertise slowly in seconds, 0 means no timeout */
     uint16_t advertisingTimeout;
+    /**
+     * The advertising interval in ms after boot and after a peer disconnected,
+     * for a short discovery latency.
+     */
+    uint16_t fastAdvertisingInterval;
+    /**
+     * How long to advertise fast in seconds before changing to the slow
+     * advertisingInterval, 0 disables the fast phase.
+     */
+    uint16_t fastAdvertisingTimeout;
+    /**
+     * Send the device name in the scan response instead of the advertising
+     * packet, leaving room in the advertising packet for service UUIDs.
+     * Scanners have to scan actively to see the name.
+     */
+    bool nameInScanResponse;
+    /**
+     * The profile the manager requests when a peer connects. Also announced
+     * as the peripheral preferred connection parameters.
+     */
+    ConnectionProfile connectionProfile;
+    /**
+     * The link layer payload in octets to request when a peer connects, up to
+     * BLE_MAX_DATA_LENGTH with the LE Data Length Extension. The default
+     * BLE_DEFAULT_DATA_LENGTH requests nothing. Peers without the extension,
+     * and targets that do not define bleUpdateDataLength(), keep 27.
+     */
+    uint16_t dataLength;
+    /**
+     * The PHYs to request when a peer connects, e.g. LE 2M for twice the
+     * data rate. Peers that refuse, and stacks without PHY support, keep the
+     * connection on LE 1M.
+     */
+    ble::phy_set_t preferredPhys;
+    /**
+     * Keep advertising while less than this number of peers are connected.
+     * The stack must be configured for as many peripheral links.
+     */
+    uint8_t maxConnections;
 
     /**
-     * Default configuration parameters for the BLE stack.
+     * Default configuration parameters for the BLE stack. Advertising has a
+     * single phase, set fastAdvertisingInterval and fastAdvertisingTimeout
+     * to advertise fast first. Neither the Data Length Extension nor
+     * another PHY than LE 1M is requested, set dataLength and preferredPhys.
      * @param deviceName the device name used in advertising
      * @param advertisingInterval the advertising interval
      * @param advertisingTimeout how long to advertise, 0 means no timeout
+     * @param maxConnections how many peers may connect at the same time
      */
     explicit BLEConfig(const char *deviceName = "BLEDEVICE",
-                       uint16_t advertisingInterval = 10, uint16_t advertisingTimeout = 0);
+                       uint16_t advertisingInterval = 10, uint16_t advertisingTimeout = 0,
+                       uint8_t maxConnections = 1);
 
     virtual ~BLEConfig() {};
 
     virtual ble_error_t onInit(BLE& ble);
 
+    /**
+     * Called when a peer connected, restarts advertising while less than
+     * maxConnections peers are connected. BLEManager registers its own
+     * connection callback before onInit() registers this one, so the
+     * connection is already counted by BLEManager::getConnectionCount().
+     * @param params the connection parameters
+     */
     virtual void onConnection(const Gap::ConnectionCallbackParams_t *params);
 
     virtual void onDisconnection(const Gap::DisconnectionCallbackParams_t *params);
+
+    /**
+     * Changes from fast to slow advertising when the fast phase times out.
+     */
+    virtual void onTimeout(Gap::TimeoutSource_t source);
+
+    /**
+     * Get the connection parameters of a profile. The defaults follow the
+     * rules iOS centrals apply (intervals of at least 15ms, a supervision
+     * timeout of 2-6s), so they are accepted by all common centrals:
+     *
+     * | profile     | interval     | slave latency | supervision timeout |
+     * |-------------|--------------|---------------|---------------------|
+     * | bulk        | 15 - 30ms    | 0             | 4s                  |
+     * | low latency | 15ms         | 0             | 2s                  |
+     * | low power   | 100 - 200ms  | 4             | 6s                  |
+     *
+     * @param profile the profile
+     * @param params filled with the connection parameters
+     * @return false for PROFILE_CENTRAL, which has no parameters of its own
+     */
+    virtual bool getConnectionParams(ConnectionProfile profile, Gap::ConnectionParams_t *params);
+
+protected:
+    /**
+     * (Re)start advertising in one of the phases.
+     * @param fast whether to start the fast phase, ignored if it is disabled
+     * @return the result of starting advertising
+     */
+    ble_error_t startAdvertising(bool fast);
+
+    bool fastAdvertising;
 };
 
 
@@ -0,0 +1,137 @@
+/*!
+ * @file
+ * @brief Fixed-memory latency histogram with power of two buckets.
+ *
+ * Bucket 0 counts zero, bucket i (i > 0) counts values from 2^(i-1) to
+ * 2^i - 1 and the last bucket everything above. With microseconds and the
+ * default of 24 buckets that covers up to 8s at a relative resolution of
+ * 50%, which is enough to tell a connection interval from a stalled queue.
+ * Samples are added with relaxed atomics, so a single writer can record
+ * while another thread reads or dumps the histogram.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_BLEHISTOGRAM_H
+#define UBIRCH_MBED_BLE_BLEHISTOGRAM_H
+
+#include <stdint.h>
+#include <cstdio>
+
+/** Number of histogram buckets, bucket i counts values below 2^i. */
+#ifndef BLE_HISTOGRAM_BUCKETS
+#define BLE_HISTOGRAM_BUCKETS 24
+#endif
+
+class BLEHistogram {
+public:
+    static const int BUCKETS = BLE_HISTOGRAM_BUCKETS;
+
+    BLEHistogram() {
+        reset();
+    }
+
+    /**
+     * Remove all samples. Not thread safe with add().
+     */
+    void reset() {
+        for (int i = 0; i < BUCKETS; i++) buckets[i] = 0;
+        samples = 0;
+        maximum = 0;
+    }
+
+    /**
+     * Record a sample.
+     * @param value the sample, e.g. a latency in microseconds
+     */
+    void add(uint32_t value) {
+        int i = value ? 32 - __builtin_clz(value) : 0;
+        if (i >= BUCKETS) i = BUCKETS - 1;
+        __atomic_add_fetch(&buckets[i], 1, __ATOMIC_RELAXED);
+        // samples come from several threads, a larger maximum stored meanwhile must not be lost
+        uint32_t current = __atomic_load_n(&maximum, __ATOMIC_RELAXED);
+        while (value > current &&
+               !__atomic_compare_exchange_n(&maximum, &current, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        __atomic_add_fetch(&samples, 1, __ATOMIC_RELEASE);
+    }
+
+    /** the number of samples recorded */
+    uint32_t count() const {
+        return __atomic_load_n(&samples, __ATOMIC_ACQUIRE);
+    }
+
+    /** the largest sample recorded */
+    uint32_t max() const {
+        return __atomic_load_n(&maximum, __ATOMIC_RELAXED);
+    }
+
+    /** the number of samples in a bucket */
+    uint32_t bucket(int i) const {
+        return __atomic_load_n(&buckets[i], __ATOMIC_RELAXED);
+    }
+
+    /** the largest value counted in a bucket, except for the open ended last one */
+    static uint32_t upperBound(int i) {
+        return i >= 32 ? 0xFFFFFFFFUL : (1UL << i) - 1;
+    }
+
+    /**
+     * Get an upper bound of a percentile, the upper end of the bucket it
+     * falls into, but never more than the largest sample.
+     * @param percent the percentile, e.g. 99
+     * @return the upper bound, 0 without samples
+     */
+    uint32_t percentile(uint8_t percent) const {
+        uint32_t n = count();
+        if (!n) return 0;
+
+        // the rank of the sample, rounded up
+        uint32_t rank = static_cast<uint32_t>((static_cast<uint64_t>(n) * percent + 99) / 100);
+        if (!rank) rank = 1;
+        uint32_t seen = 0;
+        for (int i = 0; i < BUCKETS - 1; i++) {
+            seen += bucket(i);
+            if (seen >= rank) return upperBound(i) < max() ? upperBound(i) : max();
+        }
+        return max();
+    }
+
+    /**
+     * Print the summary and all non-empty buckets, e.g. to the debug UART.
+     * @param name the name printed in front of every line
+     */
+    void dump(const char *name) const {
+        printf("%s: n=%lu p50<=%lu p90<=%lu p99<=%lu max=%lu\r\n", name,
+               (unsigned long) count(), (unsigned long) percentile(50),
+               (unsigned long) percentile(90), (unsigned long) percentile(99), (unsigned long) max());
+        for (int i = 0; i < BUCKETS - 1; i++) {
+            if (bucket(i)) printf("%s: <=%lu %lu\r\n", name, (unsigned long) upperBound(i), (unsigned long) bucket(i));
+        }
+        if (bucket(BUCKETS - 1))
+            printf("%s: >%lu %lu\r\n", name, (unsigned long) upperBound(BUCKETS - 2), (unsigned long) bucket(BUCKETS - 1));
+    }
+
+private:
+    uint32_t buckets[BUCKETS];
+    uint32_t samples;
+    uint32_t maximum;
+};
+
+#endif //UBIRCH_MBED_BLE_BLEHISTOGRAM_H
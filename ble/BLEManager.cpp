@@ -22,74 +22,490 @@
  * limitations under the License.
  * ```
  */
+#include <new>
 #include <rtos.h>
 #include <UARTService.h>
 #include "BLEManager.h"
 
 
-static Thread *bleEventThread;
+// set in the init flags when the initialization is done
+#define INIT_DONE 0x01
+
+// the queue BLE events are processed on, the own one or an application queue
 static EventQueue *bleEventQueue;
+#if BLE_MANAGER_OWN_EVENT_THREAD
+static Thread *bleEventThread;
+static EventQueue *bleOwnEventQueue;
+#endif
+static BLEManager::EventQueueStats bleEventQueueStats;
+// set when a processing request did not fit into the queue, the running request processes once more
+static volatile bool bleProcessingLost;
+
+#if BLE_STATIC_MEMORY && BLE_MANAGER_OWN_EVENT_THREAD
+static unsigned char bleEventQueueBuffer[BLE_MANAGER_EVENT_QUEUE_DEPTH * EVENTS_EVENT_SIZE];
+static unsigned char bleEventThreadStack[BLE_MANAGER_EVENT_THREAD_STACK_SIZE] __attribute__((aligned(8)));
+static EventQueue bleStaticEventQueue(sizeof(bleEventQueueBuffer), bleEventQueueBuffer);
+static Thread bleStaticEventThread(BLE_MANAGER_EVENT_THREAD_PRIORITY, sizeof(bleEventThreadStack),
+                                   bleEventThreadStack);
+#endif
+
+// the manager and the config of init(name, ...) are constructed in place, they are never destroyed
+static uint64_t bleManagerStorage[(sizeof(BLEManager) + 7) / 8];
+static uint64_t bleDefaultConfigStorage[(sizeof(BLEConfig) + 7) / 8];
+static BLEConfig *bleDefaultConfig;
+
+#if BLE_STATS
+BLEStats bleStats;
+#endif
+
+// targets without a vendor data length call keep the default payload
+MBED_WEAK ble_error_t bleUpdateDataLength(Gap::Handle_t connection, uint16_t txOctets) {
+    (void) connection;
+    (void) txOctets;
+    return BLE_ERROR_NOT_IMPLEMENTED;
+}
+
+static void processBleEvents(uint32_t postedAt) {
+    uint32_t latency = us_ticker_read() - postedAt;
+    __atomic_add_fetch(&bleEventQueueStats.totalLatencyUs, latency, __ATOMIC_RELAXED);
+    uint32_t max = __atomic_load_n(&bleEventQueueStats.maxLatencyUs, __ATOMIC_RELAXED);
+    while (latency > max && !__atomic_compare_exchange_n(&bleEventQueueStats.maxLatencyUs, &max, latency, false,
+                                                         __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    // events that arrive while processing may find the queue full, this request still occupies its slot
+    do {
+        BLE::Instance().processEvents();
+    } while (__atomic_exchange_n(&bleProcessingLost, false, __ATOMIC_ACQ_REL));
+    __atomic_add_fetch(&bleEventQueueStats.dispatched, 1, __ATOMIC_RELAXED);
+}
 
-// BLE events processing
+// BLE events processing, may be called from interrupt context
 static void scheduleBleEventsProcessing(BLE::OnEventsToProcessCallbackContext *context) {
-    if (bleEventQueue) bleEventQueue->call(Callback<void()>(&context->ble, &BLE::processEvents));
+    (void) context;
+    if (!bleEventQueue) return;
+
+    // the request running right now may already be past the new events, it checks the flag when done
+    if (!bleEventQueue->call(processBleEvents, us_ticker_read())) {
+        __atomic_add_fetch(&bleEventQueueStats.failed, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&bleProcessingLost, true, __ATOMIC_RELEASE);
+        return;
+    }
+
+    uint32_t waiting = __atomic_add_fetch(&bleEventQueueStats.posted, 1, __ATOMIC_RELAXED) -
+                       __atomic_load_n(&bleEventQueueStats.dispatched, __ATOMIC_RELAXED);
+    uint32_t highWater = __atomic_load_n(&bleEventQueueStats.highWater, __ATOMIC_RELAXED);
+    while (waiting > highWater && !__atomic_compare_exchange_n(&bleEventQueueStats.highWater, &highWater, waiting,
+                                                               false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
 }
 
 BLEManager &BLEManager::getInstance() {
     static BLEManager *instance;
-    if (!instance) {
-        bleEventQueue = new EventQueue(4 * EVENTS_EVENT_SIZE);
-        bleEventThread = new Thread(osPriorityNormal);
-        bleEventThread->start(callback(bleEventQueue, &EventQueue::dispatch_forever));
-        instance = new BLEManager();
-    }
+    if (!instance) instance = new(bleManagerStorage) BLEManager();
     return *instance;
 }
 
+ble_error_t BLEManager::setEventQueue(EventQueue *queue) {
+    if (initialized || initializing) return BLE_ERROR_INVALID_STATE;
+    bleEventQueue = queue;
+    return BLE_ERROR_NONE;
+}
+
+BLEManager::EventQueueStats BLEManager::getEventQueueStats() {
+    EventQueueStats stats;
+    stats.posted = __atomic_load_n(&bleEventQueueStats.posted, __ATOMIC_RELAXED);
+    stats.failed = __atomic_load_n(&bleEventQueueStats.failed, __ATOMIC_RELAXED);
+    stats.dispatched = __atomic_load_n(&bleEventQueueStats.dispatched, __ATOMIC_RELAXED);
+    stats.highWater = __atomic_load_n(&bleEventQueueStats.highWater, __ATOMIC_RELAXED);
+    stats.maxLatencyUs = __atomic_load_n(&bleEventQueueStats.maxLatencyUs, __ATOMIC_RELAXED);
+    stats.totalLatencyUs = __atomic_load_n(&bleEventQueueStats.totalLatencyUs, __ATOMIC_RELAXED);
+    return stats;
+}
+
+void BLEManager::resetEventQueueStats() {
+    // keep posted and dispatched in step, requests may still be waiting in the queue
+    uint32_t waiting = __atomic_load_n(&bleEventQueueStats.posted, __ATOMIC_RELAXED) -
+                       __atomic_load_n(&bleEventQueueStats.dispatched, __ATOMIC_RELAXED);
+    __atomic_store_n(&bleEventQueueStats.dispatched, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&bleEventQueueStats.posted, waiting, __ATOMIC_RELAXED);
+    __atomic_store_n(&bleEventQueueStats.failed, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&bleEventQueueStats.highWater, waiting, __ATOMIC_RELAXED);
+    __atomic_store_n(&bleEventQueueStats.maxLatencyUs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&bleEventQueueStats.totalLatencyUs, 0, __ATOMIC_RELAXED);
+}
+
+#if BLE_STATS
+BLEStats BLEManager::getStats() {
+    BLEStats stats;
+    const uint32_t *counters = reinterpret_cast<const uint32_t *>(&bleStats);
+    uint32_t *snapshot = reinterpret_cast<uint32_t *>(&stats);
+    for (size_t i = 0; i < sizeof(stats) / sizeof(uint32_t); i++)
+        snapshot[i] = __atomic_load_n(&counters[i], __ATOMIC_RELAXED);
+    return stats;
+}
+
+void BLEManager::resetStats() {
+    uint32_t *counters = reinterpret_cast<uint32_t *>(&bleStats);
+    for (size_t i = 0; i < sizeof(bleStats) / sizeof(uint32_t); i++)
+        __atomic_store_n(&counters[i], 0, __ATOMIC_RELAXED);
+}
+#endif
+
 bool BLEManager::isInitialized() {
     return initialized;
 }
 
 bool BLEManager::isConnected() {
-    return BLE::Instance().gap().getState().connected;
+    return getConnectionCount() > 0;
+}
+
+bool BLEManager::isConnected(Gap::Handle_t connection) {
+    connectionsMutex.lock();
+    bool connected = findConnection(connection) != NULL;
+    connectionsMutex.unlock();
+    return connected;
+}
+
+int BLEManager::getConnectionCount() {
+    int count = 0;
+    connectionsMutex.lock();
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS; i++) {
+        if (connections[i].active) count++;
+    }
+    connectionsMutex.unlock();
+    return count;
+}
+
+int BLEManager::getConnections(Gap::Handle_t *handles, int max) {
+    int count = 0;
+    connectionsMutex.lock();
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS && count < max; i++) {
+        if (connections[i].active) handles[count++] = connections[i].info.handle;
+    }
+    connectionsMutex.unlock();
+    return count;
+}
+
+bool BLEManager::getConnection(Gap::Handle_t connection, ConnectionInfo *info) {
+    connectionsMutex.lock();
+    Connection *c = findConnection(connection);
+    if (c) *info = c->info;
+    connectionsMutex.unlock();
+    return c != NULL;
+}
+
+BLEManager::Connection *BLEManager::findConnection(Gap::Handle_t handle) {
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS; i++) {
+        if (connections[i].active && connections[i].info.handle == handle) return &connections[i];
+    }
+    return NULL;
+}
+
+uint16_t BLEManager::getAttMtu(Gap::Handle_t connection) {
+    connectionsMutex.lock();
+    Connection *c = findConnection(connection);
+    uint16_t mtu = c ? c->info.attMtu : static_cast<uint16_t>(BLE_DEFAULT_ATT_MTU);
+    connectionsMutex.unlock();
+    return mtu;
+}
+
+uint16_t BLEManager::getAttMtu() {
+    uint16_t mtu = 0;
+    connectionsMutex.lock();
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS; i++) {
+        if (connections[i].active && (!mtu || connections[i].info.attMtu < mtu)) mtu = connections[i].info.attMtu;
+    }
+    connectionsMutex.unlock();
+    return mtu ? mtu : static_cast<uint16_t>(BLE_DEFAULT_ATT_MTU);
+}
+
+// a notification larger than a link layer packet is fragmented, let it fill all fragments
+static uint16_t notificationPayload(const BLEManager::ConnectionInfo &info) {
+    // the L2CAP (4) and ATT (3) headers travel in the link layer packets as well
+    uint32_t pdu = info.attMtu + 4u;
+    if (pdu > info.dataLength) pdu -= pdu % info.dataLength;
+    return static_cast<uint16_t>(pdu - 7);
+}
+
+uint16_t BLEManager::getMaxPayload(Gap::Handle_t connection) {
+    connectionsMutex.lock();
+    Connection *c = findConnection(connection);
+    uint16_t payload = c ? notificationPayload(c->info) : static_cast<uint16_t>(BLE_DEFAULT_ATT_MTU - 3);
+    connectionsMutex.unlock();
+    return payload;
+}
+
+uint16_t BLEManager::getMaxPayload() {
+    uint16_t payload = 0;
+    connectionsMutex.lock();
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS; i++) {
+        if (!connections[i].active) continue;
+        uint16_t p = notificationPayload(connections[i].info);
+        if (!payload || p < payload) payload = p;
+    }
+    connectionsMutex.unlock();
+    return payload ? payload : static_cast<uint16_t>(BLE_DEFAULT_ATT_MTU - 3);
+}
+
+ble_error_t BLEManager::setConnectionProfile(BLEConfig::ConnectionProfile profile) {
+    if (!initialized) return BLE_ERROR_INVALID_STATE;
+
+    this->connectionProfile = profile;
+    ble_error_t result = BLE_ERROR_NONE;
+    Gap::ConnectionParams_t params;
+    if (config->getConnectionParams(profile, &params)) {
+        result = BLE::Instance().gap().setPreferredConnectionParams(&params);
+    }
+    connectionsMutex.lock();
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS; i++) {
+        if (!connections[i].active) continue;
+        ble_error_t error = requestConnectionProfile(connections[i], profile);
+        if (result == BLE_ERROR_NONE) result = error;
+    }
+    connectionsMutex.unlock();
+    return result;
+}
+
+ble_error_t BLEManager::setConnectionProfile(Gap::Handle_t connection, BLEConfig::ConnectionProfile profile) {
+    if (!initialized) return BLE_ERROR_INVALID_STATE;
+
+    connectionsMutex.lock();
+    Connection *c = findConnection(connection);
+    ble_error_t error = c ? requestConnectionProfile(*c, profile) : BLE_ERROR_INVALID_PARAM;
+    connectionsMutex.unlock();
+    return error;
+}
+
+ble_error_t BLEManager::requestConnectionProfile(Connection &connection, BLEConfig::ConnectionProfile profile) {
+    Gap::ConnectionParams_t params;
+    if (!config->getConnectionParams(profile, &params)) {
+        // nothing to restore if the central's parameters were never changed
+        if (connection.info.profile == profile || !connection.info.params.minConnectionInterval) {
+            connection.info.profile = profile;
+            return BLE_ERROR_NONE;
+        }
+        params = connection.info.params;
+    }
+
+    ble_error_t error = BLE::Instance().gap().updateConnectionParams(connection.info.handle, &params);
+    if (error == BLE_ERROR_NONE) connection.info.profile = profile;
+    return error;
+}
+
+void BLEManager::requestLinkUpdate(Connection &connection) {
+    Gap &gap = BLE::Instance().gap();
+    // the results arrive as events, until then the link keeps 27 octets on LE 1M
+    // a failed request leaves the link as it is, the connection is still usable
+    if (config->dataLength > BLE_DEFAULT_DATA_LENGTH) {
+        ble_error_t error = bleUpdateDataLength(connection.info.handle, config->dataLength);
+        if (error != BLE_ERROR_NONE) PRINTF("data length update(%d)=%d\r\n", connection.info.handle, error);
+    }
+    if (config->preferredPhys.get_2m() || config->preferredPhys.get_coded()) {
+        ble_error_t error = gap.setPhy(connection.info.handle, &config->preferredPhys, &config->preferredPhys,
+                                       ble::coded_symbol_per_bit_t::UNDEFINED);
+        if (error != BLE_ERROR_NONE) PRINTF("phy update(%d)=%d\r\n", connection.info.handle, error);
+    }
+}
+
+void BLEManager::onConnection(const Gap::ConnectionCallbackParams_t *params) {
+    BLE_STATS_INC(connections);
+    connectionsMutex.lock();
+#if BLE_STATS
+    // the slots of disconnected peers still hold their addresses
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS; i++) {
+        if (connections[i].disconnected && connections[i].info.peerAddrType == params->peerAddrType &&
+            !memcmp(connections[i].info.peerAddr, params->peerAddr, sizeof(connections[i].info.peerAddr))) {
+            BLE_STATS_INC(reconnects);
+            break;
+        }
+    }
+#endif
+    for (int i = 0; i < BLE_MANAGER_MAX_CONNECTIONS; i++) {
+        if (!connections[i].active) {
+            ConnectionInfo &info = connections[i].info;
+            info.handle = params->handle;
+            info.role = params->role;
+            info.peerAddrType = params->peerAddrType;
+            memcpy(info.peerAddr, params->peerAddr, sizeof(info.peerAddr));
+            if (params->connectionParams) info.params = *params->connectionParams;
+            else memset(&info.params, 0, sizeof(info.params));
+            info.attMtu = BLE_DEFAULT_ATT_MTU;
+            info.dataLength = BLE_DEFAULT_DATA_LENGTH;
+            info.phy = ble::phy_t::LE_1M;
+            info.profile = BLEConfig::PROFILE_CENTRAL;
+            connections[i].active = true;
+            connections[i].disconnected = false;
+            // the central's parameters are often too slow for streaming, or too fast to idle
+            requestConnectionProfile(connections[i], connectionProfile);
+            requestLinkUpdate(connections[i]);
+            break;
+        }
+    }
+    connectionsMutex.unlock();
+}
+
+void BLEManager::onDisconnection(const Gap::DisconnectionCallbackParams_t *params) {
+    BLE_STATS_INC(disconnections);
+    if (params->reason == Gap::CONNECTION_TIMEOUT) BLE_STATS_INC(linkLosses);
+    connectionsMutex.lock();
+    Connection *c = findConnection(params->handle);
+    if (c) {
+        c->active = false;
+        c->disconnected = true;
+    }
+    connectionsMutex.unlock();
+}
+
+void BLEManager::onAttMtuChange(ble::connection_handle_t connectionHandle, uint16_t attMtuSize) {
+    connectionsMutex.lock();
+    Connection *c = findConnection(connectionHandle);
+    if (c) c->info.attMtu = attMtuSize;
+    connectionsMutex.unlock();
+}
+
+void BLEManager::onPhyUpdateComplete(ble_error_t status, Gap::Handle_t connectionHandle, Gap::Phy_t txPhy,
+                                     Gap::Phy_t rxPhy) {
+    (void) rxPhy;
+    // a peer that refused the update keeps the connection on its current PHY
+    connectionsMutex.lock();
+    Connection *c = findConnection(connectionHandle);
+    if (c && status == BLE_ERROR_NONE) c->info.phy = txPhy.value();
+    connectionsMutex.unlock();
+}
+
+void BLEManager::onDataLengthChange(Gap::Handle_t connectionHandle, uint16_t txSize, uint16_t rxSize) {
+    (void) rxSize;
+    connectionsMutex.lock();
+    Connection *c = findConnection(connectionHandle);
+    if (c) c->info.dataLength = txSize;
+    connectionsMutex.unlock();
 }
 
 void BLEManager::_init(BLE::InitializationCompleteCallbackContext *params) {
     BLE &ble = params->ble;
+    // a late completion of an abandoned initialization, its config may be gone
+    if (!initializing) {
+        initDone();
+        return;
+    }
     this->error = params->error;
 
-    if (!this->config || params->ble.getInstanceID() != BLE::DEFAULT_INSTANCE) {
+    if (this->error == BLE_ERROR_NONE &&
+        (!this->config || params->ble.getInstanceID() != BLE::DEFAULT_INSTANCE)) {
         this->error = BLE_ERROR_INVALID_STATE;
+    }
+    if (this->error != BLE_ERROR_NONE) {
+        initDone();
         return;
     }
 
+    clearConnections();
+    this->connectionProfile = this->config->connectionProfile;
+    // before the config's callbacks, BLEConfig::onConnection() counts this connection
+    ble.gap().onConnection(this, &BLEManager::onConnection);
+    ble.gap().onDisconnection(this, &BLEManager::onDisconnection);
+    ble.gap().setEventHandler(this);
+    ble.gattServer().setEventHandler(this);
+
     this->error = this->config->onInit(ble);
-    this->initialized = (error == BLE_ERROR_NONE);
+    initDone();
+}
+
+void BLEManager::initDone() {
+    // init() gave up waiting, nobody expects the stack to be up
+    if (!__atomic_exchange_n(&initializing, false, __ATOMIC_SEQ_CST)) {
+        if (!initialized) BLE::Instance().shutdown();
+        return;
+    }
+
+    if (error != BLE_ERROR_NONE) BLE_STATS_INC(initFailures);
+    initialized = (error == BLE_ERROR_NONE);
+    initFlags.set(INIT_DONE);
+    if (initCallback) initCallback(error);
+}
+
+ble_error_t BLEManager::init(BLEConfig *config, uint32_t timeoutMs) {
+    ble_error_t result = initAsync(config, NULL);
+    if (result != BLE_ERROR_NONE) return result;
+
+    // sleep until the stack reports the initialization done (or failed)
+    uint32_t flags = initFlags.wait_any(INIT_DONE, timeoutMs);
+    if (flags & osFlagsError) {
+        // abandon the initialization, unless it completed just now
+        if (__atomic_exchange_n(&initializing, false, __ATOMIC_SEQ_CST)) {
+            BLE_STATS_INC(initFailures);
+            BLE::Instance().shutdown();
+            return BLE_ERROR_INTERNAL_STACK_FAILURE;
+        }
+        initFlags.wait_any(INIT_DONE);
+    }
+
+    return error;
 }
 
-ble_error_t BLEManager::init(BLEConfig *config) {
-    if (initialized) return BLE_ERROR_ALREADY_INITIALIZED;
+ble_error_t BLEManager::initAsync(BLEConfig *config, Callback<void(ble_error_t)> callback) {
+    if (initialized || initializing) return BLE_ERROR_ALREADY_INITIALIZED;
 
     this->config = config;
+    this->initCallback = callback;
+    this->error = BLE_ERROR_NONE;
+    this->initializing = true;
+    initFlags.clear(INIT_DONE);
+
+    if (!bleEventQueue) {
+#if BLE_MANAGER_OWN_EVENT_THREAD
+        // the event thread is only started when no application queue is used, it costs a full stack
+        if (!bleOwnEventQueue) {
+#if BLE_STATIC_MEMORY
+            bleOwnEventQueue = &bleStaticEventQueue;
+            bleEventThread = &bleStaticEventThread;
+#else
+            bleOwnEventQueue = new EventQueue(BLE_MANAGER_EVENT_QUEUE_DEPTH * EVENTS_EVENT_SIZE);
+            bleEventThread = new Thread(BLE_MANAGER_EVENT_THREAD_PRIORITY, BLE_MANAGER_EVENT_THREAD_STACK_SIZE);
+#endif
+            bleEventThread->start(mbed::callback(bleOwnEventQueue, &EventQueue::dispatch_forever));
+        }
+        bleEventQueue = bleOwnEventQueue;
+#else
+        // nothing would process the stack's events
+        this->initializing = false;
+        return BLE_ERROR_INVALID_STATE;
+#endif
+    }
 
     BLE &ble = BLE::Instance();
     ble.onEventsToProcess(scheduleBleEventsProcessing);
-    ble.init(this, &BLEManager::_init);
-
-    while (!initialized && error == BLE_ERROR_NONE) /* wait for initialization done or error state */;
+    ble_error_t result = ble.init(this, &BLEManager::_init);
+    if (result != BLE_ERROR_NONE) {
+        // the callback will not be called
+        this->initializing = false;
+        return result;
+    }
 
-    return error;
+    return BLE_ERROR_NONE;
 }
 
 ble_error_t BLEManager::init(const char *deviceName, const uint16_t advInterval, const uint16_t advTimeout) {
-    return init(new BLEConfig(deviceName, advInterval, advTimeout));
+    if (initialized || initializing) return BLE_ERROR_ALREADY_INITIALIZED;
+
+    if (bleDefaultConfig) bleDefaultConfig->~BLEConfig();
+    bleDefaultConfig = new(bleDefaultConfigStorage) BLEConfig(deviceName, advInterval, advTimeout);
+    return init(bleDefaultConfig);
 }
 
 ble_error_t BLEManager::deinit() {
     if (initialized) {
         initialized = false;
-        return BLE::Instance().shutdown();
+        ble_error_t error = BLE::Instance().shutdown();
+        // the stack reports no disconnections on shutdown
+        clearConnections();
+        return error;
     }
     return BLE_ERROR_NONE;
 }
 
+void BLEManager::clearConnections() {
+    connectionsMutex.lock();
+    memset(connections, 0, sizeof(connections));
+    connectionsMutex.unlock();
+}
+
@@ -25,11 +25,107 @@
 #ifndef UBIRCH_MBED_BLE_BLEMANAGER_H
 #define UBIRCH_MBED_BLE_BLEMANAGER_H
 
+#include <mbed.h>
 #include <BLE.h>
 #include <BLEConfig.h>
+#include <BLEStats.h>
+#include <BLEStaticService.h>
 
-class BLEManager {
+#ifndef BLE_MANAGER_MAX_CONNECTIONS
+#define BLE_MANAGER_MAX_CONNECTIONS 4
+#endif
+
+/** How long init() waits for the BLE stack to finish its initialization. */
+#ifndef BLE_MANAGER_INIT_TIMEOUT
+#define BLE_MANAGER_INIT_TIMEOUT 5000
+#endif
+
+/** Number of BLE processing requests the manager's own event queue can hold. */
+#ifndef BLE_MANAGER_EVENT_QUEUE_DEPTH
+#define BLE_MANAGER_EVENT_QUEUE_DEPTH 4
+#endif
+
+/** Priority of the thread dispatching the manager's own BLE event queue. */
+#ifndef BLE_MANAGER_EVENT_THREAD_PRIORITY
+#define BLE_MANAGER_EVENT_THREAD_PRIORITY osPriorityNormal
+#endif
+
+/** Stack size of the thread dispatching the manager's own BLE event queue. */
+#ifndef BLE_MANAGER_EVENT_THREAD_STACK_SIZE
+#define BLE_MANAGER_EVENT_THREAD_STACK_SIZE OS_STACK_SIZE
+#endif
+
+/**
+ * Set to 0 if BLE events are always processed on an application queue
+ * (see BLEManager::setEventQueue()). The own event queue and thread are not
+ * built then, with BLE_STATIC_MEMORY their buffer and stack are not reserved.
+ */
+#ifndef BLE_MANAGER_OWN_EVENT_THREAD
+#define BLE_MANAGER_OWN_EVENT_THREAD 1
+#endif
+
+/** The ATT MTU every connection starts with, before an MTU exchange. */
+#define BLE_DEFAULT_ATT_MTU 23
+
+/** The link layer payload in octets every connection starts with, before a data length update. */
+#define BLE_DEFAULT_DATA_LENGTH 27
+
+/** The largest link layer payload in octets, with the LE Data Length Extension. */
+#define BLE_MAX_DATA_LENGTH 251
+
+/**
+ * Target hook requesting a link layer payload of txOctets on a connection.
+ * mbed's Gap has no portable call for the LE Data Length Extension, the
+ * default returns BLE_ERROR_NOT_IMPLEMENTED and links keep
+ * BLE_DEFAULT_DATA_LENGTH. A target port defines it with the vendor call,
+ * e.g. sd_ble_gap_data_length_update() on the nRF52, the new length is
+ * reported by the stack to Gap::EventHandler::onDataLengthChange().
+ * @param connection the connection
+ * @param txOctets the maximum payload to send, up to BLE_MAX_DATA_LENGTH
+ * @return BLE_ERROR_NONE if the update was started
+ */
+ble_error_t bleUpdateDataLength(Gap::Handle_t connection, uint16_t txOctets);
+
+class BLEManager : private Gap::EventHandler, private GattServer::EventHandler {
 public:
+    /**
+     * Counters of the BLE event queue, used to size the queue and thread.
+     */
+    struct EventQueueStats {
+        /** processing requests posted to the queue */
+        uint32_t posted;
+        /** processing requests that did not fit into the queue */
+        uint32_t failed;
+        /** processing requests completed by the event thread */
+        uint32_t dispatched;
+        /** maximum number of requests waiting in the queue at the same time */
+        uint32_t highWater;
+        /** maximum time from posting to dispatching a request (us) */
+        uint32_t maxLatencyUs;
+        /** accumulated time from posting to dispatching all requests (us) */
+        uint32_t totalLatencyUs;
+    };
+
+    /**
+     * What the manager knows about a connected peer.
+     */
+    struct ConnectionInfo {
+        Gap::Handle_t handle;
+        Gap::Role_t role;
+        BLEProtocol::AddressType_t peerAddrType;
+        BLEProtocol::AddressBytes_t peerAddr;
+        /** the connection parameters negotiated when connecting */
+        Gap::ConnectionParams_t params;
+        /** the profile last requested for the connection */
+        BLEConfig::ConnectionProfile profile;
+        /** the negotiated ATT MTU */
+        uint16_t attMtu;
+        /** the negotiated link layer payload in octets */
+        uint16_t dataLength;
+        /** the PHY of the connection, LE 1M unless a PHY update succeeded */
+        ble::phy_t::type phy;
+    };
+
     /**
      * Get a singleton of this manager.
      * @return a single instance reference.
@@ -37,17 +133,62 @@ public:
     static BLEManager &getInstance();
 
     /**
-     * The actual initialization of the BLE instance.
+     * The actual initialization of the BLE instance. Blocks the calling
+     * thread until the stack is initialized and the config applied.
+     *
+     * If the stack does not finish in time the initialization is abandoned
+     * and the stack shut down, init() can be called again. A completion the
+     * stack reports after that is ignored. If it arrives while a new
+     * initialization is running, it completes that one with its config.
      *
-     * @param deviceName the name of  the BLE device for advertisement
+     * @param config the configuration to apply when the stack is ready
+     * @param timeoutMs how long to wait for the initialization to finish
      * @returns BLE_ERROR_NONE if the initialization was successful
      * @returns BLE_ERROR_ALDREADY_INITIALIZED if this instance is configured
+     * @returns BLE_ERROR_INTERNAL_STACK_FAILURE if the stack did not finish in time
      * @returns BLE_ERROR_* for any other BLE related errors
      */
-    ble_error_t init(BLEConfig *config);
+    ble_error_t init(BLEConfig *config, uint32_t timeoutMs = BLE_MANAGER_INIT_TIMEOUT);
+
+    /**
+     * Process BLE events on an application event queue instead of the
+     * manager's own event thread, which is then never created. Pass
+     * mbed_event_queue() to use the shared event queue. Must be called
+     * before the initialization.
+     *
+     * If the calling thread dispatches the queue itself, it must use
+     * initAsync(), init() would block the dispatch and time out.
+     *
+     * A processing request that does not fit into the queue is made up for
+     * by the BLE request waiting in or running on the queue. If the queue is
+     * full of other events and no BLE request is waiting, processing resumes
+     * only with the next stack event, so leave room for one BLE request (see
+     * the failed count of getEventQueueStats()).
+     *
+     * @param queue the queue to schedule event processing on, NULL for the own thread
+     *              (only available with BLE_MANAGER_OWN_EVENT_THREAD)
+     * @returns BLE_ERROR_NONE if the queue will be used
+     * @returns BLE_ERROR_INVALID_STATE if this instance is initialized or initializing
+     */
+    ble_error_t setEventQueue(EventQueue *queue);
+
+    /**
+     * Start the initialization of the BLE instance and return immediately.
+     * The callback is called with the result once the stack is initialized
+     * and the config applied (on the BLE event thread).
+     *
+     * @param config the configuration to apply when the stack is ready
+     * @param callback called with the result of the initialization, may be NULL
+     * @returns BLE_ERROR_NONE if the initialization was started
+     * @returns BLE_ERROR_ALDREADY_INITIALIZED if this instance is configured or initializing
+     * @returns BLE_ERROR_INVALID_STATE if built without BLE_MANAGER_OWN_EVENT_THREAD and no queue is set
+     * @returns BLE_ERROR_* for any other BLE related errors
+     */
+    ble_error_t initAsync(BLEConfig *config, Callback<void(ble_error_t)> callback);
 
     /**
      * Initialize the BLE instance and configure services using the config.
+     * The config is kept in static memory, replacing the one of an earlier call.
      * @param deviceName the device name to use
      * @param advInterval the advertising interval to use
      * @param advTimeout how long to advertise until low power mode
@@ -72,16 +213,125 @@ public:
 
     /**
      * Check if this instance is currently connected.
-     * @returns the status of the connectivity
+     * @returns whether at least one peer is connected
      */
     bool isConnected();
 
+    /**
+     * Check if a specific connection is established.
+     * @param connection the connection handle
+     * @returns whether the peer is connected
+     */
+    bool isConnected(Gap::Handle_t connection);
+
+    /**
+     * Get the number of connected peers.
+     * @return the number of connections
+     */
+    int getConnectionCount();
+
+    /**
+     * Get the handles of all connected peers.
+     * @param handles the array to store the handles in
+     * @param max the size of the array
+     * @return the number of handles stored
+     */
+    int getConnections(Gap::Handle_t *handles, int max);
+
+    /**
+     * Get the state of a connection.
+     * @param connection the connection handle
+     * @param info filled with the connection state
+     * @return false if the connection is unknown
+     */
+    bool getConnection(Gap::Handle_t connection, ConnectionInfo *info);
+
+    /**
+     * Request the parameters of a profile for all connections, and for
+     * peers connecting later. The central decides whether and when it
+     * applies them. PROFILE_CENTRAL asks for the parameters the central
+     * chose when connecting.
+     * @param profile the connection profile
+     * @returns BLE_ERROR_NONE if the parameters were requested
+     * @returns BLE_ERROR_INVALID_STATE if this instance is not initialized
+     * @returns BLE_ERROR_* of the first request the stack refused
+     */
+    ble_error_t setConnectionProfile(BLEConfig::ConnectionProfile profile);
+
+    /**
+     * Request the parameters of a profile for one connection, e.g. go to
+     * PROFILE_BULK for a log dump and back to PROFILE_LOW_POWER afterwards.
+     * @param connection the connection handle
+     * @param profile the connection profile
+     * @returns BLE_ERROR_NONE if the parameters were requested
+     * @returns BLE_ERROR_INVALID_PARAM if the connection is unknown
+     * @returns BLE_ERROR_* if the stack refused the request
+     */
+    ble_error_t setConnectionProfile(Gap::Handle_t connection, BLEConfig::ConnectionProfile profile);
+
+    /**
+     * Get the negotiated ATT MTU of a connection.
+     * @param connection the connection handle
+     * @return the ATT MTU or BLE_DEFAULT_ATT_MTU if the connection is unknown
+     */
+    uint16_t getAttMtu(Gap::Handle_t connection);
+
+    /**
+     * Get the smallest negotiated ATT MTU of all connections. This is the
+     * MTU usable for notifications that go out to all connected peers.
+     * @return the smallest ATT MTU or BLE_DEFAULT_ATT_MTU if not connected
+     */
+    uint16_t getAttMtu();
+
+    /**
+     * Get the notification payload to use on a connection. It is the ATT
+     * MTU - 3, reduced if the notification does not fit into one link layer
+     * packet, so that it fills all packets it is fragmented into.
+     * @param connection the connection handle
+     * @return the payload in bytes, 20 if the connection is unknown
+     */
+    uint16_t getMaxPayload(Gap::Handle_t connection);
+
+    /**
+     * Get the smallest notification payload of all connections, usable for
+     * notifications that go out to all connected peers.
+     * @return the payload in bytes, 20 if not connected
+     */
+    uint16_t getMaxPayload();
+
+    /**
+     * Get a snapshot of the BLE event queue counters.
+     * @return the counters since startup or the last reset
+     */
+    EventQueueStats getEventQueueStats();
+
+    /**
+     * Reset the BLE event queue counters.
+     */
+    void resetEventQueueStats();
+
+#if BLE_STATS
+    /**
+     * Get a snapshot of the BLE layer counters. The counters are updated
+     * independently, so they may be from slightly different moments.
+     * @return the counters since startup or the last reset
+     */
+    BLEStats getStats();
+
+    /**
+     * Reset the BLE layer counters.
+     */
+    void resetStats();
+#endif
 
 protected:
     BLEManager() {
         config = NULL;
         initialized = false;
+        initializing = false;
         error = BLE_ERROR_NONE;
+        connectionProfile = BLEConfig::PROFILE_CENTRAL;
+        memset(connections, 0, sizeof(connections));
     };
 
     ~BLEManager() {
@@ -90,10 +340,52 @@ protected:
 
     void _init(BLE::InitializationCompleteCallbackContext *params);
 
+    void initDone();
+
+    void onConnection(const Gap::ConnectionCallbackParams_t *params);
+
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params);
+
+    void onAttMtuChange(ble::connection_handle_t connectionHandle, uint16_t attMtuSize);
+
+    void onPhyUpdateComplete(ble_error_t status, Gap::Handle_t connectionHandle, Gap::Phy_t txPhy, Gap::Phy_t rxPhy);
+
+    void onDataLengthChange(Gap::Handle_t connectionHandle, uint16_t txSize, uint16_t rxSize);
+
 private:
+    struct Connection {
+        bool active;
+        // the slot still holds the address of a disconnected peer
+        bool disconnected;
+        ConnectionInfo info;
+    };
+
+    /**
+     * Find an active connection, the caller must hold connectionsMutex.
+     */
+    Connection *findConnection(Gap::Handle_t handle);
+
+    void clearConnections();
+
+    ble_error_t requestConnectionProfile(Connection &connection, BLEConfig::ConnectionProfile profile);
+
+    /**
+     * Request the configured data length and PHYs, the peer may refuse both.
+     */
+    void requestLinkUpdate(Connection &connection);
+
     BLEConfig *config;
-    bool initialized;
-    ble_error_t error;
+    volatile bool initialized;
+    volatile bool initializing;
+    volatile ble_error_t error;
+    EventFlags initFlags;
+    Callback<void(ble_error_t)> initCallback;
+
+    // requested for new connections
+    BLEConfig::ConnectionProfile connectionProfile;
+    // written on the BLE event thread, read from application threads
+    Mutex connectionsMutex;
+    Connection connections[BLE_MANAGER_MAX_CONNECTIONS];
 };
 
 
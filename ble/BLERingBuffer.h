@@ -0,0 +1,304 @@
+/*!
+ * @file
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * One thread (or interrupt) may write while another one reads without any
+ * locking. The capacity is a power of two, the head and tail indices run
+ * freely over the full 32 bit range and are masked on access, so the whole
+ * buffer is usable and no modulo is needed. The producer publishes data with
+ * a release store of the head, the consumer frees space with a release store
+ * of the tail, each side reads the other index with acquire semantics.
+ *
+ * The producer may also discard the oldest elements to make space for new
+ * ones (overwrite()). It then moves the tail itself, so the consumer always
+ * advances the tail with a compare-and-swap and retries copying reads if the
+ * producer got in between.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_BLERINGBUFFER_H
+#define UBIRCH_MBED_BLE_BLERINGBUFFER_H
+
+#include <stdint.h>
+#include <cstring>
+
+template<typename T>
+class BLERingBuffer {
+public:
+    /**
+     * Readable elements, in place in the ring storage.
+     */
+    struct Span {
+        const T *data;
+        uint32_t length;
+    };
+
+    /**
+     * Create an unusable ring buffer, call init() before use.
+     */
+    BLERingBuffer() : buffer(NULL), mask(0), head(0), tail(0), peekTail(0), overwritable(false) {}
+
+    /**
+     * Create a ring buffer on top of existing storage.
+     * @param storage the element storage, must hold capacity elements
+     * @param capacity the number of elements, must be a power of two
+     */
+    BLERingBuffer(T *storage, uint32_t capacity)
+            : buffer(storage), mask(capacity - 1), head(0), tail(0), peekTail(0), overwritable(false) {}
+
+    /**
+     * Assign storage and reset the ring buffer, overwrite() is disabled
+     * again. Not thread safe.
+     * @param storage the element storage, must hold capacity elements
+     * @param capacity the number of elements, must be a power of two
+     */
+    void init(T *storage, uint32_t capacity) {
+        buffer = storage;
+        mask = capacity - 1;
+        head = tail = peekTail = 0;
+        overwritable = false;
+    }
+
+    /**
+     * Allow the producer to use overwrite(). The consumer then releases
+     * elements with a compare-and-swap, as the producer may move the tail
+     * too. Not thread safe, call after init() and before use.
+     */
+    void enableOverwrite() {
+        overwritable = true;
+    }
+
+    /**
+     * Round a size up to the next power of two (a usable capacity).
+     */
+    static uint32_t capacityFor(uint32_t size) {
+        uint32_t capacity = 1;
+        while (capacity < size) capacity <<= 1;
+        return capacity;
+    }
+
+    uint32_t capacity() const {
+        return buffer ? mask + 1 : 0;
+    }
+
+    /**
+     * @return the number of elements that can be read (exact for the consumer)
+     */
+    uint32_t size() const {
+        return load(head) - load(tail);
+    }
+
+    /**
+     * @return the number of elements that can be written (exact for the producer)
+     */
+    uint32_t space() const {
+        return capacity() - size();
+    }
+
+    bool empty() const {
+        return load(head) == load(tail);
+    }
+
+    // == producer side ==
+
+    /**
+     * Append a single element.
+     * @return false if the buffer is full
+     */
+    bool push(const T &element) {
+        uint32_t h = head;
+        if (h - acquire(tail) > mask || !buffer) return false;
+        buffer[h & mask] = element;
+        release(head, h + 1);
+        return true;
+    }
+
+    /**
+     * Append as many elements as fit, copied in at most two segments.
+     * @return the number of elements written
+     */
+    uint32_t write(const T *data, uint32_t count) {
+        uint32_t h = head;
+        uint32_t free = buffer ? mask + 1 - (h - acquire(tail)) : 0;
+        if (count > free) count = free;
+        if (!count) return 0;
+
+        uint32_t offset = h & mask;
+        uint32_t first = mask + 1 - offset;
+        if (first > count) first = count;
+        memcpy(buffer + offset, data, first * sizeof(T));
+        memcpy(buffer, data + first, (count - first) * sizeof(T));
+        release(head, h + count);
+        return count;
+    }
+
+    /**
+     * Append elements, discarding the oldest ones if there is not enough
+     * space. If more elements than the capacity are given, only the last
+     * ones are kept. Requires enableOverwrite().
+     * @param dropped incremented by the number of elements discarded
+     * @return the number of elements written
+     */
+    uint32_t overwrite(const T *data, uint32_t count, uint32_t *dropped) {
+        if (!buffer) return 0;
+        if (count > mask + 1) {
+            *dropped += count - (mask + 1);
+            data += count - (mask + 1);
+            count = mask + 1;
+        }
+
+        uint32_t h = head;
+        uint32_t t = acquire(tail);
+        while (count > mask + 1 - (h - t)) {
+            // the consumer may release elements at the same time, only discard what is still needed
+            uint32_t discard = count - (mask + 1 - (h - t));
+            if (__atomic_compare_exchange_n(&tail, &t, t + discard, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                *dropped += discard;
+                break;
+            }
+        }
+        return write(data, count);
+    }
+
+    // == consumer side ==
+
+    /**
+     * Remove a single element.
+     * @return false if the buffer is empty
+     */
+    bool pop(T &element) {
+        for (;;) {
+            uint32_t t = acquire(tail);
+            if (acquire(head) == t) return false;
+            element = buffer[t & mask];
+            if (advance(t, 1)) return true;
+        }
+    }
+
+    /**
+     * Remove up to count elements, copied out in at most two segments.
+     * @return the number of elements read
+     */
+    uint32_t read(T *data, uint32_t count) {
+        for (;;) {
+            uint32_t t = acquire(tail);
+            uint32_t available = acquire(head) - t;
+            uint32_t n = count < available ? count : available;
+            if (!n) return 0;
+
+            uint32_t offset = t & mask;
+            uint32_t first = mask + 1 - offset;
+            if (first > n) first = n;
+            memcpy(data, buffer + offset, first * sizeof(T));
+            memcpy(data + first, buffer, (n - first) * sizeof(T));
+            // if the producer discarded elements meanwhile the copy may be overwritten, read again
+            if (advance(t, n)) return n;
+        }
+    }
+
+    /**
+     * Get the readable elements that are contiguous in memory, in place.
+     * @param span set to the first readable element
+     * @return the number of contiguous readable elements
+     */
+    uint32_t readSpan(const T **span) {
+        uint32_t t = peekTail = acquire(tail);
+        uint32_t available = acquire(head) - t;
+        uint32_t offset = t & mask;
+        if (available > mask + 1 - offset) available = mask + 1 - offset;
+        *span = buffer + offset;
+        return available;
+    }
+
+    /**
+     * Get all readable elements in place, as at most two spans (the second one
+     * is only used if the data wraps around the end of the storage).
+     * @param spans set to the readable spans, the lengths are 0 if unused
+     * @return the number of readable elements in both spans
+     */
+    uint32_t peek(Span spans[2]) {
+        uint32_t t = peekTail = acquire(tail);
+        uint32_t available = acquire(head) - t;
+        uint32_t offset = t & mask;
+        uint32_t first = mask + 1 - offset;
+        if (first > available) first = available;
+        spans[0].data = buffer + offset;
+        spans[0].length = first;
+        spans[1].data = buffer;
+        spans[1].length = available - first;
+        return available;
+    }
+
+    /**
+     * Release elements obtained with the last readSpan() or peek().
+     * @return false if the producer discarded some of them in the meantime,
+     *         so the data seen in place may have been overwritten
+     */
+    bool consume(uint32_t count) {
+        uint32_t t = peekTail;
+        if (advance(t, count)) return true;
+
+        // never move the tail back behind what the producer already discarded
+        uint32_t target = t + count;
+        uint32_t current = acquire(tail);
+        while (static_cast<int32_t>(target - current) > 0 &&
+               !__atomic_compare_exchange_n(&tail, &current, target, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+        return false;
+    }
+
+private:
+    // copying would break the producer/consumer ownership of the indices
+    BLERingBuffer(const BLERingBuffer &);
+
+    BLERingBuffer &operator=(const BLERingBuffer &);
+
+    static uint32_t load(const uint32_t &index) {
+        return __atomic_load_n(&index, __ATOMIC_RELAXED);
+    }
+
+    static uint32_t acquire(const uint32_t &index) {
+        return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+    }
+
+    static void release(uint32_t &index, uint32_t value) {
+        __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+    }
+
+    // release count elements read from t, fails if overwrite() discarded some of them meanwhile
+    bool advance(uint32_t t, uint32_t count) {
+        if (!overwritable) {
+            release(tail, t + count);
+            return true;
+        }
+        return __atomic_compare_exchange_n(&tail, &t, t + count, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+    }
+
+    T *buffer;
+    uint32_t mask;
+    uint32_t head;
+    uint32_t tail;
+    // where the last readSpan() or peek() started, only used by the consumer
+    uint32_t peekTail;
+    // whether the producer may move the tail with overwrite()
+    bool overwritable;
+};
+
+#endif //UBIRCH_MBED_BLE_BLERINGBUFFER_H
@@ -0,0 +1,124 @@
+/*!
+ * @file
+ * @brief GATT services and characteristics without heap allocation.
+ *
+ * A service is usually built by allocating GattCharacteristic objects with
+ * new and collecting them in a temporary table. The stack keeps pointers to
+ * the characteristics (handles, authorization callbacks), so they can never
+ * be freed. These templates put the characteristic table, the properties and
+ * the value buffers into the objects themselves, sized at compile time. A
+ * service declared as a static or global object lives completely in .bss,
+ * as a class member it is part of the owning object:
+ *
+ * ```
+ * static BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ, 4> counter(counterUUID, 4);
+ * static BLEStaticService<1> service(serviceUUID);
+ *
+ * service.add(counter).addTo(ble);
+ * ```
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_BLESTATICSERVICE_H
+#define UBIRCH_MBED_BLE_BLESTATICSERVICE_H
+
+#include <BLE.h>
+#include <cstring>
+
+/**
+ * Heap-free build: the manager keeps its event queue and thread in static
+ * memory and only the statically sized services (BLEStaticUartService) are
+ * available, so the library never allocates.
+ */
+#ifndef BLE_STATIC_MEMORY
+#define BLE_STATIC_MEMORY 0
+#endif
+
+/**
+ * A characteristic with its properties and value buffer fixed at compile time.
+ * The value buffer holds the initial value and SIZE is the maximum length of
+ * the value.
+ */
+template<uint8_t PROPERTIES, uint16_t SIZE>
+class BLEStaticCharacteristic : public GattCharacteristic {
+public:
+    /**
+     * Create the characteristic with an initial value of all zeros.
+     * @param uuid the characteristic UUID
+     * @param length the initial length of the value
+     */
+    explicit BLEStaticCharacteristic(const UUID &uuid, uint16_t length = 0)
+            : GattCharacteristic(uuid, value, length, SIZE, PROPERTIES) {
+        memset(value, 0, sizeof(value));
+    }
+
+    /** the initial value, changes after registration have to go through the GattServer */
+    uint8_t value[SIZE];
+};
+
+/**
+ * A GATT service with a table of N characteristics kept in the object.
+ * The characteristics must live as long as the service is registered.
+ */
+template<uint8_t N>
+class BLEStaticService : public GattService {
+public:
+    /**
+     * Create an empty service, add() all N characteristics before addTo().
+     * @param uuid the service UUID
+     */
+    explicit BLEStaticService(const UUID &uuid) : GattService(uuid, characteristics, N), count(0) {
+        memset(characteristics, 0, sizeof(characteristics));
+    }
+
+    /**
+     * Add the next characteristic to the service table.
+     * @param characteristic the characteristic, ignored if the table is full
+     * @return the service, so calls can be chained
+     */
+    BLEStaticService &add(GattCharacteristic &characteristic) {
+        if (count < N) characteristics[count++] = &characteristic;
+        return *this;
+    }
+
+    /**
+     * Register the service with the GATT server. Afterwards the characteristic
+     * value handles are set.
+     * @param ble the BLE instance
+     * @return BLE_ERROR_INVALID_STATE if not all characteristics have been added,
+     *         else the result of adding the service
+     */
+    ble_error_t addTo(BLE &ble) {
+        if (count != N) return BLE_ERROR_INVALID_STATE;
+        return ble.addService(*this);
+    }
+
+private:
+    GattCharacteristic *characteristics[N];
+    uint8_t count;
+
+    // the stack keeps pointers into the table
+    BLEStaticService(const BLEStaticService &);
+
+    BLEStaticService &operator=(const BLEStaticService &);
+};
+
+#endif //UBIRCH_MBED_BLE_BLESTATICSERVICE_H
@@ -0,0 +1,82 @@
+/*!
+ * @file
+ * @brief Runtime counters of the BLE layer.
+ *
+ * The manager, the config and the services count into one global block
+ * with relaxed atomic adds, cheap enough for the send and receive paths.
+ * Read a snapshot with BLEManager::getStats() or over the air with the
+ * BLEStatsService. Without BLE_STATS the counters, the API and the
+ * service compile out completely.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_BLESTATS_H
+#define UBIRCH_MBED_BLE_BLESTATS_H
+
+#include <stdint.h>
+
+/** Count bytes, errors and link events, see BLEManager::getStats(). */
+#ifndef BLE_STATS
+#define BLE_STATS 0
+#endif
+
+#if BLE_STATS
+
+/**
+ * The counters since startup or the last BLEManager::resetStats(). All
+ * members are uint32_t, in this order, which is also the layout of the
+ * diagnostics characteristic.
+ */
+struct BLEStats {
+    /** payload bytes written to the stack as notifications */
+    uint32_t txBytes;
+    /** bytes written by centrals */
+    uint32_t rxBytes;
+    /** received bytes dropped or rejected because the receive buffer was full */
+    uint32_t rxDropped;
+    /** GATT writes refused for lack of stack buffers (BLE_ERROR_NO_MEM) */
+    uint32_t txNoMemory;
+    /** GATT writes failing otherwise, e.g. BLE_STACK_BUSY */
+    uint32_t txFailed;
+    /** peers connected */
+    uint32_t connections;
+    /** peers connected again from an address seen before */
+    uint32_t reconnects;
+    /** peers disconnected */
+    uint32_t disconnections;
+    /** disconnections because the supervision timeout expired */
+    uint32_t linkLosses;
+    /** advertising restarted after a connection, disconnection or timeout */
+    uint32_t advertisingRestarts;
+    /** initializations that failed or timed out */
+    uint32_t initFailures;
+};
+
+extern BLEStats bleStats;
+
+#define BLE_STATS_ADD(counter, n) __atomic_add_fetch(&bleStats.counter, (n), __ATOMIC_RELAXED)
+#else
+#define BLE_STATS_ADD(counter, n) ((void) 0)
+#endif
+
+#define BLE_STATS_INC(counter) BLE_STATS_ADD(counter, 1)
+
+#endif //UBIRCH_MBED_BLE_BLESTATS_H
@@ -0,0 +1,59 @@
+/*!
+ * @file
+ * @brief BLE diagnostics service, the runtime counters as a read-only characteristic
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <BLEManager.h>
+#include "BLEStatsService.h"
+
+#if BLE_STATS
+
+const char BLEStatsServiceUUID[] = "B1E50001-2C4D-4E5F-8A9B-0C1D2E3F4A5B";
+const char BLEStatsCharacteristicUUID[] = "B1E50002-2C4D-4E5F-8A9B-0C1D2E3F4A5B";
+
+BLEStatsService::BLEStatsService(BLE &_ble)
+: statsCharacteristic(UUID(BLEStatsCharacteristicUUID), VALUE_SIZE), service(UUID(BLEStatsServiceUUID)) {
+    memset(snapshot, 0, sizeof(snapshot));
+    statsCharacteristic.setReadAuthorizationCallback(this, &BLEStatsService::onReadAuthorization);
+    service.add(statsCharacteristic).addTo(_ble);
+}
+
+void BLEStatsService::onReadAuthorization(GattReadAuthCallbackParams *params) {
+    // the follow-up requests of a long read continue with the same snapshot
+    if (params->offset == 0) {
+        BLEStats stats = BLEManager::getInstance().getStats();
+        const uint32_t *counters = reinterpret_cast<const uint32_t *>(&stats);
+        snapshot[0] = VERSION;
+        for (size_t i = 0; i < sizeof(stats) / sizeof(uint32_t); i++) {
+            for (int b = 0; b < 4; b++) snapshot[1 + i * 4 + b] = static_cast<uint8_t>(counters[i] >> (8 * b));
+        }
+    }
+    if (params->offset > sizeof(snapshot)) {
+        params->authorizationReply = AUTH_CALLBACK_REPLY_ATTERR_INVALID_OFFSET;
+        return;
+    }
+    params->data = snapshot + params->offset;
+    params->len = static_cast<uint16_t>(sizeof(snapshot) - params->offset);
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*!
+ * @file
+ * @brief BLE diagnostics service, the runtime counters as a read-only characteristic
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_BLESTATSSERVICE_H
+#define UBIRCH_MBED_BLE_BLESTATSSERVICE_H
+
+#include <BLE.h>
+#include <BLEStats.h>
+#include <BLEStaticService.h>
+
+#if BLE_STATS
+
+extern const char BLEStatsServiceUUID[];
+extern const char BLEStatsCharacteristicUUID[];
+
+class BLEStatsService {
+
+public:
+    /** Version of the characteristic layout, the first byte of the value. */
+    static const uint8_t VERSION = 1;
+
+    /** The characteristic value: the version and all BLEStats counters (little endian). */
+    static const uint16_t VALUE_SIZE = 1 + sizeof(BLEStats);
+
+    /**
+     * Add the diagnostics service. Every read returns the current counters,
+     * a long read (several requests at a small ATT MTU) returns the counters
+     * of the moment it started.
+     * @param _ble the ble reference
+     */
+    explicit BLEStatsService(BLE &_ble);
+
+protected:
+    /**
+     * BLE callback before a read is answered, fills in the counters.
+     */
+    void onReadAuthorization(GattReadAuthCallbackParams *params);
+
+    uint8_t snapshot[VALUE_SIZE];
+
+    BLEStaticCharacteristic<GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ, VALUE_SIZE> statsCharacteristic;
+    BLEStaticService<1> service;
+
+private:
+    // the callbacks are bound to this instance
+    BLEStatsService(const BLEStatsService &);
+
+    BLEStatsService &operator=(const BLEStatsService &);
+};
+
+#endif
+
+#endif //UBIRCH_MBED_BLE_BLESTATSSERVICE_H
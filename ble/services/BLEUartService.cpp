@@ -26,109 +26,564 @@
  * ```
  */
 
+#include <new>
 #include <UARTService.h>
+#include <BLEManager.h>
 #include "BLEUartService.h"
 
-// some static stuff, because the underlying lib does not handle object pointers here
-static uint8_t txBufferHead = 0;
-static uint8_t txBufferTail = 0;
+// set in the RX event flags when data was received
+#define RX_READABLE 0x01
+// set in the TX event flags when notification buffers were released or a peer disconnected
+#define TX_SPACE 0x01
 
-static GattCharacteristic *rxCharacteristic = NULL;
-static volatile bool txEmpty = false;
+// ATT limits attribute values to 512 bytes, a notification never carries more than (ATT MTU - 3) anyway
+static inline uint16_t attributeLength(uint16_t bufferSize) {
+    return bufferSize < 512 ? bufferSize : static_cast<uint16_t>(512);
+}
+
+// CRC-16/CCITT (polynomial 0x1021, initial value 0xFFFF), a nibble table keeps it small
+static const uint16_t crc16Table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
 
-void onConfirmationReceived(uint16_t handle) {
-    if (handle == rxCharacteristic->getValueAttribute().getHandle()) {
-        txBufferTail = txBufferHead;
-        txEmpty = true;
+static uint16_t crc16(uint16_t crc, const uint8_t *data, uint32_t length) {
+    while (length--) {
+        crc = static_cast<uint16_t>((crc << 4) ^ crc16Table[(crc >> 12) ^ (*data >> 4)]);
+        crc = static_cast<uint16_t>((crc << 4) ^ crc16Table[(crc >> 12) ^ (*data++ & 0x0F)]);
     }
+    return crc;
 }
 
-BLEUartService::BLEUartService(BLE &_ble, uint8_t _rxBufferSize, uint8_t _txBufferSize)
-: ble(_ble),
-  rxBufferSize(static_cast<uint8_t>(_rxBufferSize + 1)),
-  txBufferSize(static_cast<uint8_t>(_txBufferSize + 1)),
-  rxBuffer(new uint8_t[rxBufferSize]),
-  txBuffer(new uint8_t[txBufferSize]),
-  rxBufferHead(0), txBufferHead(0), rxBufferTail(0), txBufferTail(0) {
-    txCharacteristic = new GattCharacteristic(UARTServiceTXCharacteristicUUID,
-                                              rxBuffer, 1, static_cast<uint16_t>(rxBufferSize),
-                                              GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE |
-                                              GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE_WITHOUT_RESPONSE);
-    rxCharacteristic = new GattCharacteristic(UARTServiceRXCharacteristicUUID,
-                                              txBuffer, 1, static_cast<uint16_t>(txBufferSize),
-                                              GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
-                                              GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY);
+// select a range of the received data, which may wrap around the end of the buffer
+static void sliceSpans(const BLEUartService::Span spans[2], uint32_t offset, uint32_t length,
+                       BLEUartService::Span slice[2]) {
+    if (offset < spans[0].length) {
+        uint32_t first = spans[0].length - offset < length ? spans[0].length - offset : length;
+        slice[0].data = spans[0].data + offset;
+        slice[0].length = first;
+        slice[1].data = spans[1].data;
+        slice[1].length = length - first;
+    } else {
+        slice[0].data = spans[1].data + (offset - spans[0].length);
+        slice[0].length = length;
+        slice[1].data = NULL;
+        slice[1].length = 0;
+    }
+}
 
-    GattCharacteristic *charTable[] = {txCharacteristic, rxCharacteristic};
-    GattService uartService(UARTServiceUUID, charTable, sizeof(charTable) / sizeof(GattCharacteristic *));
-    ble.addService(uartService);
+static void copySpans(const BLEUartService::Span slice[2], uint8_t *dst) {
+    if (slice[0].length) memcpy(dst, slice[0].data, slice[0].length);
+    if (slice[1].length) memcpy(dst + slice[0].length, slice[1].data, slice[1].length);
+}
 
-    this->txCharacteristicHandle = txCharacteristic->getValueAttribute().getHandle();
+// the buffers come from the storage of a static service, or from the heap
+static void initChannel(BLERingBuffer<uint8_t> &ring, uint8_t *&buffer, uint16_t size, uint8_t *&storage) {
+    uint32_t capacity = BLERingBuffer<uint8_t>::capacityFor(size);
+    if (storage) {
+        buffer = storage;
+        storage += capacity;
+    } else {
+        buffer = new uint8_t[capacity];
+    }
+    ring.init(buffer, capacity);
+}
+
+// write requests can be rejected, writes without response can not
+static uint8_t txProperties(BLEUartService::RxOverflowPolicy rxOverflowPolicy) {
+    return static_cast<uint8_t>(GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE |
+                                (rxOverflowPolicy == BLEUartService::RX_OVERFLOW_REJECT
+                                 ? 0 : GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE_WITHOUT_RESPONSE));
+}
+
+#if !BLE_STATIC_MEMORY
+BLEUartService::BLEUartService(BLE &_ble, uint16_t _rxBufferSize, uint16_t _txBufferSize, bool _perConnection,
+                               RxOverflowPolicy _rxOverflowPolicy)
+: ble(_ble), peers(NULL), peerCount(0), ownsMemory(true), rxOverflowPolicy(_rxOverflowPolicy),
+  rxReadableQueue(NULL), rxReadablePending(false), txTimeoutMs(BLE_UART_SEND_TIMEOUT),
+  txCharacteristic(UARTServiceTXCharacteristicUUID, NULL, 0, attributeLength(_rxBufferSize),
+                   txProperties(_rxOverflowPolicy)),
+  rxCharacteristic(UARTServiceRXCharacteristicUUID, NULL, 0, attributeLength(_txBufferSize),
+                   GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
+                   GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY),
+  service(UARTServiceUUID) {
+    if (_perConnection) {
+        // all buffers are allocated up front, connecting peers only claim a channel
+        peerCount = BLE_UART_MAX_CONNECTIONS;
+        peers = new Channel[peerCount];
+    }
+    setup(_rxBufferSize, _txBufferSize, NULL);
+}
+#endif
+
+BLEUartService::BLEUartService(BLE &_ble, uint16_t _rxBufferSize, uint16_t _txBufferSize, uint8_t *_buffers,
+                               uint8_t _peerCount, void *_peerStorage, RxOverflowPolicy _rxOverflowPolicy)
+: ble(_ble), peers(NULL), peerCount(_peerCount), ownsMemory(false), rxOverflowPolicy(_rxOverflowPolicy),
+  rxReadableQueue(NULL), rxReadablePending(false), txTimeoutMs(BLE_UART_SEND_TIMEOUT),
+  txCharacteristic(UARTServiceTXCharacteristicUUID, NULL, 0, attributeLength(_rxBufferSize),
+                   txProperties(_rxOverflowPolicy)),
+  rxCharacteristic(UARTServiceRXCharacteristicUUID, NULL, 0, attributeLength(_txBufferSize),
+                   GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ |
+                   GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY),
+  service(UARTServiceUUID) {
+    // element by element, array placement new may put a cookie in front
+    if (peerCount) peers = static_cast<Channel *>(_peerStorage);
+    for (uint8_t i = 0; i < peerCount; i++) new(&peers[i]) Channel();
+    setup(_rxBufferSize, _txBufferSize, _buffers);
+}
+
+void BLEUartService::setup(uint16_t rxBufferSize, uint16_t txBufferSize, uint8_t *buffers) {
+    initChannel(shared.rxRing, shared.rxBuffer, rxBufferSize, buffers);
+    initChannel(shared.txRing, shared.txBuffer, txBufferSize, buffers);
+    if (rxOverflowPolicy == RX_OVERFLOW_DROP_OLDEST) shared.rxRing.enableOverwrite();
+    shared.connection = ALL_CONNECTIONS;
+    shared.active = true;
+    memset(&shared.rxStats, 0, sizeof(shared.rxStats));
+    txReset(shared);
+
+    for (uint8_t i = 0; i < peerCount; i++) {
+        initChannel(peers[i].rxRing, peers[i].rxBuffer, rxBufferSize, buffers);
+        initChannel(peers[i].txRing, peers[i].txBuffer, txBufferSize, buffers);
+        if (rxOverflowPolicy == RX_OVERFLOW_DROP_OLDEST) peers[i].rxRing.enableOverwrite();
+        peers[i].active = false;
+        memset(&peers[i].rxStats, 0, sizeof(peers[i].rxStats));
+        txReset(peers[i]);
+    }
+
+    if (rxOverflowPolicy == RX_OVERFLOW_REJECT)
+        txCharacteristic.setWriteAuthorizationCallback(this, &BLEUartService::onWriteAuthorization);
+    service.add(txCharacteristic).add(rxCharacteristic).addTo(ble);
+
+    this->txCharacteristicHandle = txCharacteristic.getValueAttribute().getHandle();
+    this->rxCharacteristicHandle = rxCharacteristic.getValueAttribute().getHandle();
 
     ble.gattServer().onDataWritten(this, &BLEUartService::onDataWritten);
-    ble.gattServer().onConfirmationReceived(onConfirmationReceived);
+    ble.gattServer().onDataSent(this, &BLEUartService::onDataSent);
+    ble.gap().onConnection(this, &BLEUartService::onConnection);
+    ble.gap().onDisconnection(this, &BLEUartService::onDisconnection);
+}
+
+BLEUartService::~BLEUartService() {
+    ble.gattServer().onDataWritten().detach(
+            FunctionPointerWithContext<const GattWriteCallbackParams *>(this, &BLEUartService::onDataWritten));
+    ble.gattServer().onDataSent().detach(FunctionPointerWithContext<unsigned>(this, &BLEUartService::onDataSent));
+    ble.gap().onConnection().detach(
+            FunctionPointerWithContext<const Gap::ConnectionCallbackParams_t *>(this,
+                                                                              &BLEUartService::onConnection));
+    ble.gap().onDisconnection().detach(
+            FunctionPointerWithContext<const Gap::DisconnectionCallbackParams_t *>(this,
+                                                                                 &BLEUartService::onDisconnection));
+    // services can not be removed, the stack keeps pointing to the characteristics until BLE is shut down
+    if (!ownsMemory) {
+        for (uint8_t i = 0; i < peerCount; i++) peers[i].~Channel();
+        return;
+    }
+    for (uint8_t i = 0; i < peerCount; i++) {
+        delete[] peers[i].rxBuffer;
+        delete[] peers[i].txBuffer;
+    }
+    delete[] peers;
+    delete[] shared.rxBuffer;
+    delete[] shared.txBuffer;
+}
+
+BLEUartService::Channel *BLEUartService::findChannel(Gap::Handle_t connection) {
+    for (uint8_t i = 0; i < peerCount; i++) {
+        if (peers[i].active && peers[i].connection == connection) return &peers[i];
+    }
+    return NULL;
+}
+
+bool BLEUartService::isConnected(Channel &channel) {
+    if (channel.connection == ALL_CONNECTIONS) {
+        BLEManager &bleManager = BLEManager::getInstance();
+        return bleManager.isInitialized() ? bleManager.isConnected() : ble.getGapState().connected;
+    }
+    return channel.active;
 }
 
 bool BLEUartService::isReadable() {
-    return (rxBufferTail != rxBufferHead);
+    // like read(), the peer buffers are only read with their connection handle
+    return !shared.rxRing.empty();
+}
+
+bool BLEUartService::isReadable(Gap::Handle_t connection) {
+    Channel *channel = findChannel(connection);
+    return channel && !channel->rxRing.empty();
+}
+
+bool BLEUartService::waitReadable(uint32_t timeoutMs) {
+    // the flag is only set after data has been written, so a set flag after clearing means data
+    rxFlags.clear(RX_READABLE);
+    if (isReadable()) return true;
+
+    rxFlags.wait_any(RX_READABLE, timeoutMs);
+    return isReadable();
+}
+
+void BLEUartService::onReadable(EventQueue *queue, Callback<void()> callback) {
+    rxReadableQueue = queue;
+    rxReadableCallback = callback;
+    __atomic_store_n(&rxReadablePending, false, __ATOMIC_RELEASE);
+}
+
+void BLEUartService::dispatchReadable() {
+    // clear before calling, so data arriving while the callback reads posts it again
+    __atomic_store_n(&rxReadablePending, false, __ATOMIC_RELEASE);
+    if (rxReadableCallback) rxReadableCallback();
 }
 
 int BLEUartService::send(const uint8_t *buf, int length) {
-    if (length < 1) return EOF;
+    return send(shared, buf, length);
+}
 
-//    bool updatesEnabled = false;
+int BLEUartService::send(Gap::Handle_t connection, const uint8_t *buf, int length) {
+    Channel *channel = findChannel(connection);
+    if (!channel) return EOF;
+    return send(*channel, buf, length);
+}
 
-//    ble.gattServer().areUpdatesEnabled(*rxCharacteristic, &updatesEnabled);
+int BLEUartService::send(Channel &channel, const uint8_t *buf, int length) {
+    if (length < 1) return EOF;
 
-    if (!ble.getGapState().connected/* && !updatesEnabled*/)
+    if (!isConnected(channel))
         return EOF;
 
     int bytesWritten = 0;
+    Timer timer;
+    timer.start();
+
+    for (;;) {
+        // cleared before trying, so space released from now on wakes us up
+        txFlags.clear(TX_SPACE);
+        bytesWritten += enqueue(channel, buf + bytesWritten, length - bytesWritten);
+        txPump(channel);
+        if (bytesWritten == length || !isConnected(channel)) break;
+
+        // the buffer is full: sleep until a TX complete frees stack buffers, a busy stack
+        // does not report anything, so retry it after a while
+        uint32_t wait = BLE_UART_SEND_RETRY_INTERVAL;
+        if (txTimeoutMs != osWaitForever) {
+            uint32_t elapsed = static_cast<uint32_t>(timer.read_ms());
+            if (elapsed >= txTimeoutMs) break;
+            if (txTimeoutMs - elapsed < wait) wait = txTimeoutMs - elapsed;
+        }
+        txFlags.wait_any(TX_SPACE, wait);
+    }
 
-    while (bytesWritten < length && ble.getGapState().connected/* && updatesEnabled*/) {
+    return bytesWritten;
+}
 
-        for (int bufferIterator = bytesWritten; bufferIterator < length; bufferIterator++) {
-            uint8_t nextHead = static_cast<uint8_t>((txBufferHead + 1) % txBufferSize);
+void BLEUartService::setSendTimeout(uint32_t timeoutMs) {
+    txTimeoutMs = timeoutMs;
+}
 
-            if (nextHead != txBufferTail) {
-                txBuffer[txBufferHead] = buf[bufferIterator];
-                txBufferHead = nextHead;
-                bytesWritten++;
-            }
-        }
+int BLEUartService::sendAsync(const uint8_t *buf, int length, Callback<void(int)> completion) {
+    return sendAsync(shared, buf, length, completion);
+}
 
-        uint8_t size = static_cast<uint8_t>(txFill());
-        uint8_t *temp = new uint8_t[size];
-        memset(temp, 0, size);
+int BLEUartService::sendAsync(Gap::Handle_t connection, const uint8_t *buf, int length,
+                              Callback<void(int)> completion) {
+    Channel *channel = findChannel(connection);
+    if (!channel) return EOF;
+    return sendAsync(*channel, buf, length, completion);
+}
+
+int BLEUartService::sendAsync(Channel &channel, const uint8_t *buf, int length, Callback<void(int)> completion) {
+    if (length < 1) return EOF;
 
-        circularCopy(txBuffer, txBufferSize, temp, txBufferTail, txBufferHead);
+    if (!isConnected(channel))
+        return EOF;
 
-        ble_error_t error = ble.gattServer().write(rxCharacteristic->getValueAttribute().getHandle(), temp, size);
-        if(error == BLE_ERROR_NONE) txBufferTail = txBufferHead;
+    // the completion queue is shared with the pump, which may run on the BLE event thread
+    txMutex.lock();
+    uint8_t nextCompletionHead = static_cast<uint8_t>((channel.txCompletionHead + 1) % BLE_UART_MAX_PENDING_SENDS);
+    if (completion && nextCompletionHead == channel.txCompletionTail) {
+        txMutex.unlock();
+        return EOF;
+    }
 
-//        ble.gattServer().areUpdatesEnabled(*rxCharacteristic, &updatesEnabled);
+    int queued = enqueue(channel, buf, length);
+    if (completion && queued) {
+        channel.txCompletions[channel.txCompletionHead].mark = channel.txQueued;
+        channel.txCompletions[channel.txCompletionHead].length = queued;
+        channel.txCompletions[channel.txCompletionHead].callback = completion;
+        channel.txCompletionHead = nextCompletionHead;
     }
+    txMutex.unlock();
 
-    return bytesWritten;
+    txPump(channel);
+    return queued;
 }
 
 int BLEUartService::read(uint8_t *buf, int len) {
-    int i = 0;
-    int c;
+    if (len < 1) return 0;
+    return static_cast<int>(shared.rxRing.read(buf, static_cast<uint32_t>(len)));
+}
+
+int BLEUartService::read(uint8_t *buf, int len, uint32_t timeoutMs) {
+    if (!waitReadable(timeoutMs)) return 0;
+    return read(buf, len);
+}
+
+int BLEUartService::read(Gap::Handle_t connection, uint8_t *buf, int len) {
+    Channel *channel = findChannel(connection);
+    if (!channel || len < 1) return 0;
+    return static_cast<int>(channel->rxRing.read(buf, static_cast<uint32_t>(len)));
+}
+
+int BLEUartService::peek(Span spans[2]) {
+    return static_cast<int>(shared.rxRing.peek(spans));
+}
 
-    while (i < len && (c = getc()) >= 0) {
-        buf[i] = static_cast<uint8_t>(c);
-        i++;
+int BLEUartService::peek(Gap::Handle_t connection, Span spans[2]) {
+    Channel *channel = findChannel(connection);
+    if (!channel) {
+        spans[0].data = spans[1].data = NULL;
+        spans[0].length = spans[1].length = 0;
+        return 0;
     }
+    return static_cast<int>(channel->rxRing.peek(spans));
+}
 
-    return i;
+void BLEUartService::consume(int count) {
+    // never release more than was received, the producer would see free space that is still in use
+    uint32_t size = shared.rxRing.size();
+    if (count > 0) shared.rxRing.consume(static_cast<uint32_t>(count) < size ? static_cast<uint32_t>(count) : size);
 }
 
-int BLEUartService::getc() {
-    if (!isReadable()) return EOF;
+void BLEUartService::consume(Gap::Handle_t connection, int count) {
+    Channel *channel = findChannel(connection);
+    if (!channel || count < 1) return;
+    uint32_t size = channel->rxRing.size();
+    channel->rxRing.consume(static_cast<uint32_t>(count) < size ? static_cast<uint32_t>(count) : size);
+}
+
+int BLEUartService::sendMessage(const uint8_t *msg, int length) {
+    return sendMessage(shared, msg, length);
+}
+
+int BLEUartService::sendMessage(Gap::Handle_t connection, const uint8_t *msg, int length) {
+    Channel *channel = findChannel(connection);
+    if (!channel) return EOF;
+    return sendMessage(*channel, msg, length);
+}
+
+int BLEUartService::sendMessage(Channel &channel, const uint8_t *msg, int length) {
+    if (length < 0 || length > 0xFFFF || (length && !msg)) return EOF;
+
+    uint8_t header[3] = {BLE_UART_FRAME_SYNC, static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)};
+    uint16_t crc = crc16(crc16(0xFFFF, header + 1, 2), msg, static_cast<uint32_t>(length));
+    uint8_t trailer[2] = {static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc)};
 
-    char c = rxBuffer[rxBufferTail];
-    rxBufferTail = static_cast<uint8_t>((rxBufferTail + 1) % rxBufferSize);
+    // send() returns early if the peer disconnected or the timeout expired, the receiver resyncs on the next frame
+    if (send(channel, header, sizeof(header)) != sizeof(header)) return EOF;
+    if (length && send(channel, msg, length) != length) return EOF;
+    if (send(channel, trailer, sizeof(trailer)) != sizeof(trailer)) return EOF;
+    return length;
+}
+
+int BLEUartService::receiveMessage(uint8_t *buf, int len) {
+    return receiveMessage(shared, buf, len);
+}
+
+int BLEUartService::receiveMessage(Gap::Handle_t connection, uint8_t *buf, int len) {
+    Channel *channel = findChannel(connection);
+    if (!channel) return EOF;
+    return receiveMessage(*channel, buf, len);
+}
+
+int BLEUartService::receiveMessage(Channel &channel, uint8_t *buf, int len) {
+    for (;;) {
+        Span spans[2], payload[2];
+        int length = findMessage(channel, spans);
+        if (length == EOF) return EOF;
+
+        sliceSpans(spans, 3, static_cast<uint32_t>(len < length ? (len > 0 ? len : 0) : length), payload);
+        copySpans(payload, buf);
+
+        if (channel.rxRing.consume(static_cast<uint32_t>(length + FRAME_OVERHEAD))) return length;
+        // the frame was discarded while copying it (RX_OVERFLOW_DROP_OLDEST), try the next one
+    }
+}
+
+int BLEUartService::peekMessage(Span spans[2]) {
+    return peekMessage(shared, spans);
+}
+
+int BLEUartService::peekMessage(Gap::Handle_t connection, Span spans[2]) {
+    Channel *channel = findChannel(connection);
+    if (!channel) {
+        spans[0].data = spans[1].data = NULL;
+        spans[0].length = spans[1].length = 0;
+        return EOF;
+    }
+    return peekMessage(*channel, spans);
+}
+
+int BLEUartService::peekMessage(Channel &channel, Span spans[2]) {
+    Span frame[2];
+    int length = findMessage(channel, frame);
+    if (length == EOF) {
+        spans[0].data = spans[1].data = NULL;
+        spans[0].length = spans[1].length = 0;
+        return EOF;
+    }
+    sliceSpans(frame, 3, static_cast<uint32_t>(length), spans);
+    return length;
+}
+
+void BLEUartService::consumeMessage() {
+    consumeMessage(shared);
+}
+
+void BLEUartService::consumeMessage(Gap::Handle_t connection) {
+    Channel *channel = findChannel(connection);
+    if (channel) consumeMessage(*channel);
+}
+
+void BLEUartService::consumeMessage(Channel &channel) {
+    // peekMessage() left the frame at the start of the receive buffer, only its length is needed
+    Span spans[2], header[2];
+    uint32_t size = channel.rxRing.peek(spans);
+    if (size < 3) return;
+    sliceSpans(spans, 0, 3, header);
+    uint8_t bytes[3];
+    copySpans(header, bytes);
+    if (bytes[0] != BLE_UART_FRAME_SYNC) return;
+
+    uint32_t frameLength = static_cast<uint32_t>((bytes[1] << 8) | bytes[2]) + FRAME_OVERHEAD;
+    channel.rxRing.consume(frameLength < size ? frameLength : size);
+}
+
+int BLEUartService::findMessage(Channel &channel, Span spans[2]) {
+    for (;;) {
+        uint32_t size = channel.rxRing.peek(spans);
+        if (!size) return EOF;
+
+        // skip everything up to the next sync byte
+        uint32_t skip = size;
+        const void *sync = memchr(spans[0].data, BLE_UART_FRAME_SYNC, spans[0].length);
+        if (sync) {
+            skip = static_cast<uint32_t>(static_cast<const uint8_t *>(sync) - spans[0].data);
+        } else if (spans[1].length && (sync = memchr(spans[1].data, BLE_UART_FRAME_SYNC, spans[1].length))) {
+            skip = spans[0].length + static_cast<uint32_t>(static_cast<const uint8_t *>(sync) - spans[1].data);
+        }
+
+        if (!skip) {
+            if (size < 3) return EOF;
+
+            Span header[2], payload[2];
+            uint8_t bytes[2];
+            sliceSpans(spans, 1, 2, header);
+            copySpans(header, bytes);
+            uint32_t length = static_cast<uint32_t>((bytes[0] << 8) | bytes[1]);
+
+            // a frame that can never fit into the receive buffer is corrupted data
+            if (length + FRAME_OVERHEAD <= channel.rxRing.capacity()) {
+                if (size < length + FRAME_OVERHEAD) return EOF;
+
+                sliceSpans(spans, 1, length + 2, payload);
+                uint16_t crc = crc16(crc16(0xFFFF, payload[0].data, payload[0].length),
+                                     payload[1].data, payload[1].length);
+                sliceSpans(spans, length + 3, 2, header);
+                copySpans(header, bytes);
+                if (crc == ((bytes[0] << 8) | bytes[1])) return static_cast<int>(length);
+            }
+
+            // not a valid frame, look for the next sync byte
+            skip = 1;
+        }
+
+        if (channel.rxRing.consume(skip)) __atomic_add_fetch(&channel.rxStats.discarded, skip, __ATOMIC_RELAXED);
+    }
+}
+
+static void addRxStats(BLEUartService::RxStats &sum, const BLEUartService::RxStats &stats) {
+    sum.received += __atomic_load_n(&stats.received, __ATOMIC_RELAXED);
+    sum.dropped += __atomic_load_n(&stats.dropped, __ATOMIC_RELAXED);
+    sum.rejected += __atomic_load_n(&stats.rejected, __ATOMIC_RELAXED);
+    sum.discarded += __atomic_load_n(&stats.discarded, __ATOMIC_RELAXED);
+}
+
+BLEUartService::RxStats BLEUartService::getRxStats() {
+    RxStats stats = {0, 0, 0, 0};
+    addRxStats(stats, shared.rxStats);
+    for (uint8_t i = 0; i < peerCount; i++) addRxStats(stats, peers[i].rxStats);
+    return stats;
+}
+
+BLEUartService::RxStats BLEUartService::getRxStats(Gap::Handle_t connection) {
+    RxStats stats = {0, 0, 0, 0};
+    Channel *channel = findChannel(connection);
+    if (channel) addRxStats(stats, channel->rxStats);
+    return stats;
+}
+
+#if BLE_UART_LATENCY_STATS
+const BLEHistogram &BLEUartService::getLatency(LatencyStage stage) {
+    return txLatency[stage];
+}
+
+void BLEUartService::resetLatency() {
+    for (int i = 0; i <= LATENCY_TOTAL; i++) txLatency[i].reset();
+}
+
+void BLEUartService::dumpLatency() {
+    txLatency[LATENCY_QUEUED].dump("uart.latency.queued");
+    txLatency[LATENCY_STACK].dump("uart.latency.stack");
+    txLatency[LATENCY_TOTAL].dump("uart.latency.total");
+}
+
+void BLEUartService::latencyEnqueued(Channel &channel, uint32_t offset, int space) {
+    // the sending thread is the only one moving the head
+    uint8_t head = channel.txMarkHead;
+    uint8_t tail = __atomic_load_n(&channel.txMarkTail, __ATOMIC_ACQUIRE);
+    // without a free mark the data counts from the previous send, the latency is overestimated
+    if (!space || static_cast<uint8_t>(head - tail) >= BLE_UART_LATENCY_MARKS) return;
+
+    TxMark &mark = channel.txMarks[head % BLE_UART_LATENCY_MARKS];
+    mark.offset = offset;
+    mark.time = us_ticker_read();
+    __atomic_store_n(&channel.txMarkHead, static_cast<uint8_t>(head + 1), __ATOMIC_RELEASE);
+}
+
+void BLEUartService::latencyWritten(Channel &channel, bool completes) {
+    uint32_t now = us_ticker_read();
+    uint8_t head = __atomic_load_n(&channel.txMarkHead, __ATOMIC_ACQUIRE);
+    uint8_t tail = channel.txMarkTail;
+    if (head == tail) return;
+
+    // skip the sends that went out completely, the last one may still have data queued
+    while (static_cast<uint8_t>(head - tail) > 1 &&
+           static_cast<int32_t>(channel.txMarks[(tail + 1) % BLE_UART_LATENCY_MARKS].offset - channel.txSent) <= 0)
+        tail++;
+    uint32_t enqueuedAt = channel.txMarks[tail % BLE_UART_LATENCY_MARKS].time;
+    __atomic_store_n(&channel.txMarkTail, tail, __ATOMIC_RELEASE);
+
+    txLatency[LATENCY_QUEUED].add(now - enqueuedAt);
+    if (completes && channel.txPacketCount < BLE_UART_TX_CREDITS) {
+        TxPacket &packet = channel.txPackets[(channel.txPacketHead + channel.txPacketCount) % BLE_UART_TX_CREDITS];
+        packet.enqueuedAt = enqueuedAt;
+        packet.writtenAt = now;
+        channel.txPacketCount++;
+    }
+}
+
+void BLEUartService::latencySent(Channel &channel, unsigned count, uint32_t now) {
+    while (count-- && channel.txPacketCount) {
+        TxPacket &packet = channel.txPackets[channel.txPacketHead];
+        txLatency[LATENCY_STACK].add(now - packet.writtenAt);
+        txLatency[LATENCY_TOTAL].add(now - packet.enqueuedAt);
+        channel.txPacketHead = static_cast<uint8_t>((channel.txPacketHead + 1) % BLE_UART_TX_CREDITS);
+        channel.txPacketCount--;
+    }
+}
+#endif
+
+int BLEUartService::getc() {
+    uint8_t c;
+    if (!shared.rxRing.pop(c)) return EOF;
     return c;
 }
 
@@ -136,38 +591,213 @@ int BLEUartService::putc(char c) {
     return (send((uint8_t *) &c, 1) == 1) ? 1 : EOF;
 }
 
+int BLEUartService::enqueue(Channel &channel, const uint8_t *buf, int length) {
+#if BLE_UART_LATENCY_STATS
+    // marked before the data is visible to the pump, the space only grows until the write
+    latencyEnqueued(channel, channel.txQueued, static_cast<int>(channel.txRing.space()));
+#endif
+    int queued = static_cast<int>(channel.txRing.write(buf, static_cast<uint32_t>(length)));
+    channel.txQueued += queued;
+    return queued;
+}
+
+void BLEUartService::txPump(Channel &channel) {
+    txMutex.lock();
+
+    // the shared channel notifies all subscribed peers, limited by the smallest payload of them
+    bool all = channel.connection == ALL_CONNECTIONS;
+    bool updatesEnabled = false;
+    uint16_t maxPayload;
+    if (all) {
+        ble.gattServer().areUpdatesEnabled(rxCharacteristic, &updatesEnabled);
+        maxPayload = BLEManager::getInstance().getMaxPayload();
+    } else {
+        ble.gattServer().areUpdatesEnabled(channel.connection, rxCharacteristic, &updatesEnabled);
+        maxPayload = BLEManager::getInstance().getMaxPayload(channel.connection);
+    }
+
+    // hand the contiguous ring segments directly to the stack, it copies the notification payload
+    const uint8_t *segment;
+    uint32_t size;
+    while (channel.active && channel.txCredits && (size = channel.txRing.readSpan(&segment)) > 0) {
+        if (size > maxPayload) size = maxPayload;
+
+        ble_error_t error = all
+                            ? ble.gattServer().write(rxCharacteristicHandle, segment, static_cast<uint16_t>(size))
+                            : ble.gattServer().write(channel.connection, rxCharacteristicHandle, segment,
+                                                     static_cast<uint16_t>(size));
+        if (error == BLE_ERROR_NO_MEM) {
+            BLE_STATS_INC(txNoMemory);
+            // the stack has less buffers than we thought (other services share them), wait for the next TX complete
+            channel.txCredits = 0;
+            break;
+        }
+        if (error != BLE_ERROR_NONE) {
+            BLE_STATS_INC(txFailed);
+            break;
+        }
+
+#if BLE_UART_LATENCY_STATS
+        latencyWritten(channel, updatesEnabled);
+#endif
+        // without subscribers only the value is updated and no TX complete will return the credit
+        if (updatesEnabled) channel.txCredits--;
+        channel.txRing.consume(size);
+        channel.txSent += size;
+        BLE_STATS_ADD(txBytes, size);
+    }
+    txMutex.unlock();
+
+    // report completed sends outside of the lock, the callback may send again
+    for (;;) {
+        txMutex.lock();
+        if (channel.txCompletionTail == channel.txCompletionHead ||
+            static_cast<int32_t>(channel.txSent - channel.txCompletions[channel.txCompletionTail].mark) < 0) {
+            txMutex.unlock();
+            break;
+        }
+        TxCompletion completion = channel.txCompletions[channel.txCompletionTail];
+        channel.txCompletionTail = static_cast<uint8_t>((channel.txCompletionTail + 1) % BLE_UART_MAX_PENDING_SENDS);
+        txMutex.unlock();
+
+        completion.callback(completion.length);
+    }
+}
+
+void BLEUartService::txReset(Channel &channel) {
+    channel.txQueued = 0;
+    channel.txSent = 0;
+    channel.txCredits = BLE_UART_TX_CREDITS;
+    channel.txCompletionHead = 0;
+    channel.txCompletionTail = 0;
+#if BLE_UART_LATENCY_STATS
+    channel.txMarkHead = channel.txMarkTail = 0;
+    channel.txPacketHead = channel.txPacketCount = 0;
+#endif
+}
+
+void BLEUartService::onDataSent(unsigned count) {
+    // the stack does not tell which connection the packets belonged to, a channel that
+    // gets more credits than buffers are free backs off on BLE_ERROR_NO_MEM
+    txMutex.lock();
+#if BLE_UART_LATENCY_STATS
+    uint32_t now = us_ticker_read();
+    latencySent(shared, count, now);
+    for (uint8_t i = 0; i < peerCount; i++) latencySent(peers[i], count, now);
+#endif
+    shared.txCredits = static_cast<uint8_t>(shared.txCredits + count < BLE_UART_TX_CREDITS
+                                            ? shared.txCredits + count : BLE_UART_TX_CREDITS);
+    for (uint8_t i = 0; i < peerCount; i++) {
+        peers[i].txCredits = static_cast<uint8_t>(peers[i].txCredits + count < BLE_UART_TX_CREDITS
+                                                  ? peers[i].txCredits + count : BLE_UART_TX_CREDITS);
+    }
+    txMutex.unlock();
+
+    // refill the stack buffers that just became free
+    txPump(shared);
+    for (uint8_t i = 0; i < peerCount; i++) {
+        if (peers[i].active) txPump(peers[i]);
+    }
+    txFlags.set(TX_SPACE);
+}
+
+void BLEUartService::onConnection(const Gap::ConnectionCallbackParams_t *params) {
+    txMutex.lock();
+    for (uint8_t i = 0; i < peerCount; i++) {
+        if (!peers[i].active) {
+            // the channel is unused, nobody reads or writes its buffers
+            peers[i].rxRing.init(peers[i].rxBuffer, peers[i].rxRing.capacity());
+            if (rxOverflowPolicy == RX_OVERFLOW_DROP_OLDEST) peers[i].rxRing.enableOverwrite();
+            peers[i].txRing.init(peers[i].txBuffer, peers[i].txRing.capacity());
+            txReset(peers[i]);
+            memset(&peers[i].rxStats, 0, sizeof(peers[i].rxStats));
+            peers[i].connection = params->handle;
+            peers[i].active = true;
+            break;
+        }
+    }
+    txMutex.unlock();
+}
+
+void BLEUartService::onDisconnection(const Gap::DisconnectionCallbackParams_t *params) {
+    // the stack releases all buffers of a connection when it is gone
+    txMutex.lock();
+    shared.txCredits = BLE_UART_TX_CREDITS;
+    Channel *channel = findChannel(params->handle);
+    if (channel) channel->active = false;
+#if BLE_UART_LATENCY_STATS
+    // the dropped notifications never complete
+    shared.txPacketCount = 0;
+    if (channel) channel->txPacketCount = 0;
+#endif
+    txMutex.unlock();
+
+    // senders waiting for the peer give up
+    txFlags.set(TX_SPACE);
+}
+
 int BLEUartService::rxFill() {
-    if (rxBufferTail > rxBufferHead)
-        return (rxBufferSize - rxBufferTail) + rxBufferHead;
-    return rxBufferHead - rxBufferTail;
+    return static_cast<int>(shared.rxRing.size());
 }
 
 int BLEUartService::txFill() {
-    if (txBufferTail > txBufferHead)
-        return (txBufferSize - txBufferTail) + txBufferHead;
-    return txBufferHead - txBufferTail;
+    return static_cast<int>(shared.txRing.size());
 }
 
-void BLEUartService::circularCopy(const uint8_t *circularBuff, uint8_t circularBuffSize, uint8_t *linearBuff,
-                                  uint16_t tailPosition, uint16_t headPosition) {
-    int toBuffIndex = 0;
-
-    while (tailPosition != headPosition) {
-        linearBuff[toBuffIndex++] = circularBuff[tailPosition];
-        tailPosition = static_cast<uint16_t>((tailPosition + 1) % circularBuffSize);
+void BLEUartService::onWriteAuthorization(GattWriteAuthCallbackParams *params) {
+    Channel *channel = peerCount ? findChannel(params->connHandle) : &shared;
+    // a peer beyond the channels has no buffer at all, the shared counters take its writes
+    if (!channel) {
+        __atomic_add_fetch(&shared.rxStats.rejected, 1, __ATOMIC_RELAXED);
+        BLE_STATS_ADD(rxDropped, params->len);
+        params->authorizationReply = AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_RESOURCES;
+        return;
+    }
+    // the space only grows until the write is processed, the reader is the only one freeing it
+    if (params->len > channel->rxRing.space()) {
+        __atomic_add_fetch(&channel->rxStats.rejected, 1, __ATOMIC_RELAXED);
+        BLE_STATS_ADD(rxDropped, params->len);
+        params->authorizationReply = AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_RESOURCES;
     }
 }
 
 void BLEUartService::onDataWritten(const GattWriteCallbackParams *params) {
     if (params->handle == this->txCharacteristicHandle) {
-        for (int byteIterator = 0; byteIterator < params->len; byteIterator++) {
-            uint8_t bufferHead = static_cast<uint8_t>((rxBufferHead + 1) % rxBufferSize);
-            if (bufferHead != rxBufferTail) {
-                char c = params->data[byteIterator];
-                rxBuffer[rxBufferHead] = static_cast<uint8_t>(c);
-                rxBufferHead = bufferHead;
+        Channel *channel = peerCount ? findChannel(params->connHandle) : &shared;
+        if (!channel) {
+            // a peer beyond the channels, dropped like an overflow
+            __atomic_add_fetch(&shared.rxStats.received, params->len, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&shared.rxStats.dropped, params->len, __ATOMIC_RELAXED);
+            BLE_STATS_ADD(rxBytes, params->len);
+            BLE_STATS_ADD(rxDropped, params->len);
+            return;
+        }
+
+        // copied in at most two segments, this runs on the BLE event thread
+        uint32_t dropped = 0;
+        uint32_t written;
+        if (rxOverflowPolicy == RX_OVERFLOW_DROP_OLDEST) {
+            written = channel->rxRing.overwrite(params->data, params->len, &dropped);
+        } else {
+            written = channel->rxRing.write(params->data, params->len);
+            dropped = params->len - written;
+        }
+        __atomic_add_fetch(&channel->rxStats.received, params->len, __ATOMIC_RELAXED);
+        BLE_STATS_ADD(rxBytes, params->len);
+        if (dropped) {
+            __atomic_add_fetch(&channel->rxStats.dropped, dropped, __ATOMIC_RELAXED);
+            BLE_STATS_ADD(rxDropped, dropped);
+        }
+        if (!written) return;
+
+        rxFlags.set(RX_READABLE);
+        if (rxReadableCallback && !__atomic_exchange_n(&rxReadablePending, true, __ATOMIC_ACQ_REL)) {
+            if (!rxReadableQueue) {
+                dispatchReadable();
+            } else if (!rxReadableQueue->call(this, &BLEUartService::dispatchReadable)) {
+                // the queue is full, try again with the next write
+                __atomic_store_n(&rxReadablePending, false, __ATOMIC_RELEASE);
             }
         }
     }
 }
-
@@ -30,34 +30,221 @@
 
 #include <mbed.h>
 #include <BLE.h>
+#include <BLEManager.h>
+#include <BLERingBuffer.h>
+#include <BLEStaticService.h>
+#include <BLEHistogram.h>
+
+/** Number of notifications the service hands to the stack before waiting for TX complete. */
+#ifndef BLE_UART_TX_CREDITS
+#define BLE_UART_TX_CREDITS 6
+#endif
+
+/** Number of sendAsync() requests with a completion callback that may be pending. */
+#ifndef BLE_UART_MAX_PENDING_SENDS
+#define BLE_UART_MAX_PENDING_SENDS 8
+#endif
+
+/** How long send() waits for space in a full send buffer before it returns (ms), see setSendTimeout(). */
+#ifndef BLE_UART_SEND_TIMEOUT
+#define BLE_UART_SEND_TIMEOUT 10000
+#endif
+
+/** How long send() sleeps before it retries a stack that was busy (ms). */
+#ifndef BLE_UART_SEND_RETRY_INTERVAL
+#define BLE_UART_SEND_RETRY_INTERVAL 10
+#endif
+
+/** Number of peers a per-connection service keeps separate buffers for, at most as many as can connect. */
+#ifndef BLE_UART_MAX_CONNECTIONS
+#define BLE_UART_MAX_CONNECTIONS BLE_MANAGER_MAX_CONNECTIONS
+#endif
+
+/**
+ * Timestamp every notification and keep latency histograms, see getLatency().
+ * Costs three histograms and BLE_UART_LATENCY_MARKS send marks per channel.
+ */
+#ifndef BLE_UART_LATENCY_STATS
+#define BLE_UART_LATENCY_STATS 0
+#endif
+
+/**
+ * Number of sends per channel whose enqueue time is kept until their data went
+ * to the stack, a power of two up to 128.
+ */
+#ifndef BLE_UART_LATENCY_MARKS
+#define BLE_UART_LATENCY_MARKS 8
+#endif
+
+/** First byte of a message frame, used to find the next frame after corrupted data. */
+#ifndef BLE_UART_FRAME_SYNC
+#define BLE_UART_FRAME_SYNC 0xB5
+#endif
 
 class BLEUartService {
 
 public:
+    typedef BLERingBuffer<uint8_t>::Span Span;
+
+    /**
+     * Bytes added to each message: the sync byte, the 16 bit payload length
+     * (big endian) and the CRC-16/CCITT of length and payload (big endian).
+     */
+    static const int FRAME_OVERHEAD = 5;
+
+    /**
+     * What to do with received data that does not fit into the receive buffer.
+     */
+    enum RxOverflowPolicy {
+        /** keep the buffered data, drop what does not fit of the new write */
+        RX_OVERFLOW_DROP_NEWEST,
+        /** discard the oldest buffered data to make space for the new write */
+        RX_OVERFLOW_DROP_OLDEST,
+        /**
+         * reject writes that do not fit with an ATT error, the central has to
+         * retry (flow control). Only write requests can be rejected, so the
+         * characteristic does not allow writes without response.
+         */
+        RX_OVERFLOW_REJECT
+    };
+
+    /**
+     * Receive counters, in bytes unless noted otherwise.
+     */
+    struct RxStats {
+        uint32_t received;
+        uint32_t dropped;
+        /** number of writes rejected with an ATT error */
+        uint32_t rejected;
+        /** bytes skipped by the message receiver because they were not part of a valid frame */
+        uint32_t discarded;
+    };
+
     /**
      * Initialize the BLE UART service using the current BLE reference.
-     * Optionally adapt the buffer sizes from (default is 20 bytes, which
-     * is also the max. MTU of a BLE notification packet.
+     * Optionally adapt the buffer sizes (default is 20 bytes, the payload
+     * of a notification at the default ATT MTU of 23). Sends are split into
+     * notifications of up to (ATT MTU - 3) bytes, so a buffer of up to 244
+     * bytes is used in one notification if the central negotiated a larger
+     * MTU. The payload is cut to fill whole link layer packets, see
+     * BLEManager::getMaxPayload(). The MTU and the connections are tracked
+     * by BLEManager, if it did not initialize BLE the service sends 20 byte
+     * notifications and the shared channel asks the Gap state if a peer
+     * is connected.
+     * The buffers are rounded up to the next power of two. Reading and
+     * sending are lock-free, as long as only one thread reads and only
+     * one thread sends. Several services can be added, each one keeps its
+     * own state and is addressed by its characteristic handles.
+     *
+     * Without per-connection buffers all peers share one receive buffer
+     * and sends are notified to all of them. With per-connection buffers
+     * each of up to BLE_UART_MAX_CONNECTIONS peers gets its own buffers of
+     * the same sizes, used with the methods taking a connection handle.
+     * Received data then only goes to the peer buffers, the receive methods
+     * without a connection handle read the shared buffer and find nothing.
+     *
+     * The buffers are allocated on the heap, a BLEStaticUartService has
+     * them in the object and is the only variant with BLE_STATIC_MEMORY.
+     *
      * @param _ble the ble reference
      * @param _rxBufferSize the receive buffer size
      * @param _txBufferSize the send buffer size
+     * @param _perConnection whether to keep separate buffers per connection
+     * @param _rxOverflowPolicy what to do if received data does not fit
+     */
+#if !BLE_STATIC_MEMORY
+    explicit BLEUartService(BLE &_ble, uint16_t _rxBufferSize = 20, uint16_t _txBufferSize = 20,
+                            bool _perConnection = false,
+                            RxOverflowPolicy _rxOverflowPolicy = RX_OVERFLOW_DROP_NEWEST);
+#endif
+
+    /**
+     * Detach the service from the BLE callbacks and free the buffers.
+     * The service stays in the GATT table until BLE is shut down, but its
+     * characteristics are part of this object, so peers must not access it
+     * any more. Must not run while the BLE events are processed, e.g. delete
+     * the service on the BLE event queue.
      */
-    explicit BLEUartService(BLE &_ble, uint8_t _rxBufferSize = 20, uint8_t _txBufferSize = 20);
+    ~BLEUartService();
 
     /**
-     * Check if we have received data.
+     * Check if we have received data in the shared buffer, the one read()
+     * reads. With per-connection buffers use isReadable(connection).
      * @return whether there is data to read
      */
     bool isReadable();
 
     /**
-     * Send data to the connected client.
+     * Check if we have received data from a peer (per-connection buffers only).
+     * @param connection the connection handle
+     * @return whether there is data to read
+     */
+    bool isReadable(Gap::Handle_t connection);
+
+    /**
+     * Block the calling thread until data has been received in the shared buffer.
+     * @param timeoutMs how long to wait at most, osWaitForever to wait without timeout
+     * @return whether there is data to read
+     */
+    bool waitReadable(uint32_t timeoutMs = osWaitForever);
+
+    /**
+     * Get notified when data has been received, from any peer with
+     * per-connection buffers. The callback is posted to
+     * the given event queue, or called on the BLE event thread if no queue
+     * is given. It is posted once until it ran, so it should read all data.
+     * @param queue the event queue to dispatch the callback on or NULL
+     * @param callback the callback, NULL to remove it
+     */
+    void onReadable(EventQueue *queue, Callback<void()> callback);
+
+    /**
+     * Send data to the connected client. Blocks while the send buffer is
+     * full, sleeping until the stack reports TX complete, but not longer
+     * than the send timeout. Must not be called on the BLE event thread
+     * if the data may not fit, the TX complete could never arrive.
      * @param buf the byte buffer to send
      * @param length the length of the byte buffer
-     * @return how many bytes have actually been written
+     * @return how many bytes have actually been written, less than length if
+     *         the peer disconnected or the send timeout expired, EOF if not connected
      */
     int send(const uint8_t *buf, int length);
 
+    /**
+     * Send data to one peer (per-connection buffers only).
+     * @param connection the connection handle
+     * @param buf the byte buffer to send
+     * @param length the length of the byte buffer
+     * @return how many bytes have actually been written, like send(), EOF if the peer is not connected
+     */
+    int send(Gap::Handle_t connection, const uint8_t *buf, int length);
+
+    /**
+     * Queue data for sending to the connected client and return immediately.
+     * The data is copied into the send buffer and transmitted whenever the
+     * stack has free notification buffers (refilled on TX complete).
+     * The completion is called from the sending or BLE event thread once
+     * the queued bytes have been handed to the stack.
+     * @param buf the byte buffer to send
+     * @param length the length of the byte buffer
+     * @param completion called with the number of queued bytes when done
+     * @return how many bytes have been queued (less if the send buffer is full),
+     *         EOF if not connected or too many sends are pending
+     */
+    int sendAsync(const uint8_t *buf, int length, Callback<void(int)> completion = NULL);
+
+    /**
+     * Queue data for sending to one peer (per-connection buffers only).
+     * Pending completions are dropped when the peer disconnects.
+     * @param connection the connection handle
+     * @param buf the byte buffer to send
+     * @param length the length of the byte buffer
+     * @param completion called with the number of queued bytes when done
+     * @return how many bytes have been queued, EOF if the peer is not connected
+     *         or too many sends are pending
+     */
+    int sendAsync(Gap::Handle_t connection, const uint8_t *buf, int length, Callback<void(int)> completion = NULL);
+
     /**
      * Read incoming data into a byte buffer.
      * @param buf the buffer to read into
@@ -66,6 +253,172 @@ public:
      */
     int read(uint8_t *buf, int len);
 
+    /**
+     * Read incoming data into a byte buffer, wait for data if none is available.
+     * Returns as soon as some data was read, like a POSIX read().
+     * @param buf the buffer to read into
+     * @param len the size of the buffer
+     * @param timeoutMs how long to wait for data at most
+     * @return how many bytes have actually been read, 0 on timeout
+     */
+    int read(uint8_t *buf, int len, uint32_t timeoutMs);
+
+    /**
+     * Read data received from one peer (per-connection buffers only).
+     * @param connection the connection handle
+     * @param buf the buffer to read into
+     * @param len the size of the buffer
+     * @return how many bytes have actually been read
+     */
+    int read(Gap::Handle_t connection, uint8_t *buf, int len);
+
+    /**
+     * Get the received data in place, without copying it. The data is split
+     * into two spans if it wraps around the end of the receive buffer. It
+     * stays in the buffer until it is released with consume().
+     * @param spans set to the readable data, the second span may be empty
+     * @return the number of readable bytes in both spans
+     */
+    int peek(Span spans[2]);
+
+    /**
+     * Get the data received from one peer in place (per-connection buffers only).
+     * @param connection the connection handle
+     * @param spans set to the readable data, the second span may be empty
+     * @return the number of readable bytes in both spans
+     */
+    int peek(Gap::Handle_t connection, Span spans[2]);
+
+    /**
+     * Release received data obtained with peek().
+     * @param count the number of bytes to release, at most the peeked size
+     */
+    void consume(int count);
+
+    /**
+     * Release data of one peer obtained with peek() (per-connection buffers only).
+     * @param connection the connection handle
+     * @param count the number of bytes to release, at most the peeked size
+     */
+    void consume(Gap::Handle_t connection, int count);
+
+    /**
+     * Send a message as one frame. The frame is streamed through the send
+     * buffer like send(), so the message may be larger than the buffer.
+     * Messages and raw data should not be mixed on the same connection.
+     * @param msg the message to send
+     * @param length the length of the message, up to 65535 bytes
+     * @return the message length if the whole frame was queued, else EOF
+     */
+    int sendMessage(const uint8_t *msg, int length);
+
+    /**
+     * Send a message as one frame to one peer (per-connection buffers only).
+     * @param connection the connection handle
+     * @param msg the message to send
+     * @param length the length of the message, up to 65535 bytes
+     * @return the message length if the whole frame was queued, else EOF
+     */
+    int sendMessage(Gap::Handle_t connection, const uint8_t *msg, int length);
+
+    /**
+     * Receive the next complete message. The payload is copied straight from
+     * the receive buffer, so a frame has to fit into it completely (message
+     * length + FRAME_OVERHEAD). Bytes that do not form a valid frame are
+     * skipped. Like a datagram socket, a message longer than the buffer is
+     * truncated and the full length is returned.
+     * @param buf the buffer to copy the message into
+     * @param len the size of the buffer
+     * @return the length of the message, EOF if no complete message has been received
+     */
+    int receiveMessage(uint8_t *buf, int len);
+
+    /**
+     * Receive the next complete message of one peer (per-connection buffers only).
+     * @param connection the connection handle
+     * @param buf the buffer to copy the message into
+     * @param len the size of the buffer
+     * @return the length of the message, EOF if no complete message has been received
+     */
+    int receiveMessage(Gap::Handle_t connection, uint8_t *buf, int len);
+
+    /**
+     * Get the next complete message in place, without copying it. The message
+     * stays in the receive buffer until it is released with consumeMessage().
+     * @param spans set to the message payload, the second span may be empty
+     * @return the length of the message, EOF if no complete message has been received
+     */
+    int peekMessage(Span spans[2]);
+
+    /**
+     * Get the next complete message of one peer in place (per-connection buffers only).
+     * @param connection the connection handle
+     * @param spans set to the message payload, the second span may be empty
+     * @return the length of the message, EOF if no complete message has been received
+     */
+    int peekMessage(Gap::Handle_t connection, Span spans[2]);
+
+    /**
+     * Release the message obtained with peekMessage().
+     */
+    void consumeMessage();
+
+    /**
+     * Release the message of one peer obtained with peekMessage() (per-connection buffers only).
+     * @param connection the connection handle
+     */
+    void consumeMessage(Gap::Handle_t connection);
+
+    /**
+     * Get the receive counters (of all peers with per-connection buffers).
+     * @return the counters since the service was created
+     */
+    RxStats getRxStats();
+
+    /**
+     * Get the receive counters of one peer (per-connection buffers only).
+     * @param connection the connection handle
+     * @return the counters since the peer connected, all 0 if it is unknown
+     */
+    RxStats getRxStats(Gap::Handle_t connection);
+
+#if BLE_UART_LATENCY_STATS
+    /**
+     * The stretches of the send path measured for every notification, in
+     * microseconds from the time its first byte was passed to send().
+     */
+    enum LatencyStage {
+        /** until the data was written to the stack (waiting for a free notification buffer) */
+        LATENCY_QUEUED,
+        /** from the write to the stack until its TX complete (waiting for a connection event) */
+        LATENCY_STACK,
+        /** from send() until the TX complete */
+        LATENCY_TOTAL
+    };
+
+    /**
+     * Get a latency histogram of all notifications sent by this service.
+     * Notifications without subscribers never complete and only count
+     * as queued. The stack does not tell which connection a TX complete
+     * belongs to, with several peers the oldest notifications of all of
+     * them are taken as transmitted.
+     * @param stage the part of the send path
+     * @return the histogram, in microseconds
+     */
+    const BLEHistogram &getLatency(LatencyStage stage);
+
+    /**
+     * Clear all latency histograms, e.g. after a dump. Not thread safe with
+     * sending, call it from the sending thread.
+     */
+    void resetLatency();
+
+    /**
+     * Print all latency histograms to the console (the debug UART).
+     */
+    void dumpLatency();
+#endif
+
     /**
      * Get a single character from the input buffer. Returns EOF
      * if no data is available.
@@ -76,14 +429,94 @@ public:
     /**
      * Put a single character in the outgoing buffer.
      * This may be very inefficient as it tries to send the data
-     * immediately.
+     * immediately, use a BLEUartStream to send text.
      * @param c the character to send
      * @return 1 if the data was written, else EOF (-1)
      */
     int putc(char c);
 
+    /**
+     * Set how long send() waits for space in a full send buffer, in total
+     * for one call. A saturated link then returns a partial write instead
+     * of blocking the sender.
+     * @param timeoutMs the timeout, osWaitForever to wait until disconnected
+     */
+    void setSendTimeout(uint32_t timeoutMs);
+
 
 protected:
+    struct TxCompletion {
+        uint32_t mark;
+        int length;
+        Callback<void(int)> callback;
+    };
+
+#if BLE_UART_LATENCY_STATS
+    struct TxMark {
+        // txQueued before the send, the first byte the time belongs to
+        uint32_t offset;
+        uint32_t time;
+    };
+
+    struct TxPacket {
+        uint32_t enqueuedAt;
+        uint32_t writtenAt;
+    };
+#endif
+
+    /**
+     * The buffers and send state for all peers or a single one.
+     */
+    struct Channel {
+        // the peer, or ALL_CONNECTIONS for the shared channel
+        Gap::Handle_t connection;
+        bool active;
+
+        uint8_t *rxBuffer;
+        uint8_t *txBuffer;
+        // written by the BLE event thread, read by the application
+        BLERingBuffer<uint8_t> rxRing;
+        // written by the application, sent by the pump (serialized by txMutex)
+        BLERingBuffer<uint8_t> txRing;
+
+        // updated by the BLE event thread only
+        RxStats rxStats;
+
+        uint32_t txQueued;
+        uint32_t txSent;
+        uint8_t txCredits;
+        TxCompletion txCompletions[BLE_UART_MAX_PENDING_SENDS];
+        uint8_t txCompletionHead;
+        uint8_t txCompletionTail;
+#if BLE_UART_LATENCY_STATS
+        // enqueue times, written by the sending thread and read by the pump (lock-free)
+        TxMark txMarks[BLE_UART_LATENCY_MARKS];
+        uint8_t txMarkHead;
+        uint8_t txMarkTail;
+        // notifications waiting for TX complete (serialized by txMutex)
+        TxPacket txPackets[BLE_UART_TX_CREDITS];
+        uint8_t txPacketHead;
+        uint8_t txPacketCount;
+#endif
+    };
+
+    static const Gap::Handle_t ALL_CONNECTIONS = 0xFFFF;
+
+    /**
+     * Initialize the service on memory provided by a subclass, see BLEStaticUartService.
+     * @param _buffers the receive and send buffer of the shared channel, then of every
+     *        peer, each BLERingBuffer::capacityFor() its size
+     * @param _peerCount the number of peers with separate buffers, 0 for shared buffers only
+     * @param _peerStorage uninitialized memory for the channels of the peers
+     */
+    BLEUartService(BLE &_ble, uint16_t _rxBufferSize, uint16_t _txBufferSize, uint8_t *_buffers,
+                   uint8_t _peerCount, void *_peerStorage, RxOverflowPolicy _rxOverflowPolicy);
+
+    /**
+     * Set up the channels and register the service, buffers is NULL to allocate them.
+     */
+    void setup(uint16_t rxBufferSize, uint16_t txBufferSize, uint8_t *buffers);
+
     /**
      * Get the current size of the receive buffer.
      * @return the size of the receive buffer
@@ -97,35 +530,167 @@ protected:
     int txFill();
 
     /**
-     * This copies data from the internal circular buffer into a linear buffer.
+     * Find the channel of a connected peer.
+     * @return the channel or NULL if the peer has none
+     */
+    Channel *findChannel(Gap::Handle_t connection);
+
+    /**
+     * Check whether the peer(s) of a channel are connected.
+     */
+    bool isConnected(Channel &channel);
+
+    int send(Channel &channel, const uint8_t *buf, int length);
+
+    int sendAsync(Channel &channel, const uint8_t *buf, int length, Callback<void(int)> completion);
+
+    int sendMessage(Channel &channel, const uint8_t *msg, int length);
+
+    int receiveMessage(Channel &channel, uint8_t *buf, int len);
+
+    int peekMessage(Channel &channel, Span spans[2]);
+
+    void consumeMessage(Channel &channel);
+
+    /**
+     * Find the next valid frame in the receive buffer, skipping anything else.
+     * @param spans set to the received data, starting with the frame
+     * @return the payload length, EOF if no complete frame has been received
+     */
+    int findMessage(Channel &channel, Span spans[2]);
+
+    /**
+     * Copy as much data into the send buffer as fits.
+     * @return the number of bytes copied
      */
-    void circularCopy(const uint8_t *circularBuff, uint8_t circularBuffSize, uint8_t *linearBuff, uint16_t tailPosition,
-                      uint16_t headPosition);
+    int enqueue(Channel &channel, const uint8_t *buf, int length);
+
+    /**
+     * Hand buffered data to the stack while it has free notification buffers.
+     */
+    void txPump(Channel &channel);
+
+    /**
+     * Reset the send state, all notification buffers are free again.
+     */
+    void txReset(Channel &channel);
+
+#if BLE_UART_LATENCY_STATS
+    /**
+     * Record the time the data of a send was enqueued at, if any fits (space > 0).
+     */
+    void latencyEnqueued(Channel &channel, uint32_t offset, int space);
+
+    /**
+     * Record a notification written to the stack, starting at txSent.
+     */
+    void latencyWritten(Channel &channel, bool completes);
+
+    /**
+     * Record the TX complete of the oldest notifications of a channel.
+     */
+    void latencySent(Channel &channel, unsigned count, uint32_t now);
+#endif
 
     /**
      * BLE callback when data has been received from the connected client.
      */
     void onDataWritten(const GattWriteCallbackParams *params);
 
+    /**
+     * BLE callback before a write is accepted, rejects it if it does not fit.
+     */
+    void onWriteAuthorization(GattWriteAuthCallbackParams *params);
+
+    /**
+     * Runs the readable callback on the user event queue.
+     */
+    void dispatchReadable();
+
+    /**
+     * BLE callback when notifications have been transmitted (TX complete).
+     */
+    void onDataSent(unsigned count);
+
+    /**
+     * BLE callback when a peer connects, assigns it a channel.
+     */
+    void onConnection(const Gap::ConnectionCallbackParams_t *params);
+
+    /**
+     * BLE callback when a connection is lost, releases all its notification buffers.
+     */
+    void onDisconnection(const Gap::DisconnectionCallbackParams_t *params);
+
 protected:
     BLE &ble;
 
-    uint8_t rxBufferSize;
-    uint8_t txBufferSize;
-
-    uint8_t *rxBuffer;
-    uint8_t *txBuffer;
+    Channel shared;
+    Channel *peers;
+    uint8_t peerCount;
+    // whether the buffers and channels were allocated by the service
+    bool ownsMemory;
+    RxOverflowPolicy rxOverflowPolicy;
 
-    uint8_t rxBufferHead;
-    uint8_t txBufferHead;
-    uint8_t rxBufferTail;
-    uint8_t txBufferTail;
+    EventFlags rxFlags;
+    EventQueue *rxReadableQueue;
+    Callback<void()> rxReadableCallback;
+    bool rxReadablePending;
 
+    EventFlags txFlags;
+    uint32_t txTimeoutMs;
 
+    Mutex txMutex;
+#if BLE_UART_LATENCY_STATS
+    BLEHistogram txLatency[LATENCY_TOTAL + 1];
+#endif
 
     uint32_t txCharacteristicHandle;
+    GattAttribute::Handle_t rxCharacteristicHandle;
+
+    GattCharacteristic txCharacteristic;
+    GattCharacteristic rxCharacteristic;
+    BLEStaticService<2> service;
+
+private:
+    // the callbacks are bound to this instance
+    BLEUartService(const BLEUartService &);
+
+    BLEUartService &operator=(const BLEUartService &);
+};
+
+/**
+ * A UART service with all buffers in the object, sized at compile time. As
+ * a static or global object it lives completely in .bss:
+ *
+ * ```
+ * static BLEStaticUartService<128, 256> uart(BLE::Instance());
+ * ```
+ *
+ * The buffer sizes must be powers of two, which the dynamic service rounds
+ * up to. PEERS > 0 gives each of up to PEERS peers separate buffers of the
+ * same sizes, like a per-connection service.
+ */
+template<uint16_t RX, uint16_t TX, uint8_t PEERS = 0>
+class BLEStaticUartService : public BLEUartService {
+public:
+    /**
+     * Initialize the service, see BLEUartService.
+     * @param _ble the ble reference
+     * @param _rxOverflowPolicy what to do if received data does not fit
+     */
+    explicit BLEStaticUartService(BLE &_ble, RxOverflowPolicy _rxOverflowPolicy = RX_OVERFLOW_DROP_NEWEST)
+            : BLEUartService(_ble, RX, TX, buffers, PEERS, channels, _rxOverflowPolicy) {
+    }
+
+protected:
+    // a negative array size fails the build if a size is not a power of two
+    typedef char RxSizeMustBeAPowerOfTwo[RX && !(RX & (RX - 1)) ? 1 : -1];
+    typedef char TxSizeMustBeAPowerOfTwo[TX && !(TX & (TX - 1)) ? 1 : -1];
 
-    GattCharacteristic *txCharacteristic;
+    // raw memory, the base class is constructed first and sets it up
+    uint8_t buffers[(PEERS + 1) * (RX + TX)];
+    uint64_t channels[PEERS ? (PEERS * sizeof(Channel) + 7) / 8 : 1];
 };
 
 
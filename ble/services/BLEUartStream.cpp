@@ -0,0 +1,170 @@
+/*!
+ * @file
+ * @brief Buffered stdio stream over the BLE UART service
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+
+#include <BLEManager.h>
+#include "BLEUartStream.h"
+
+BLEUartStream::BLEUartStream(BLEUartService &_uart, uint32_t _maxLatencyMs, EventQueue *_queue)
+        : uart(_uart), queue(_queue), maxLatencyMs(_maxLatencyMs), lineBuffered(true), blocking(true),
+          flushEvent(0), length(0) {
+}
+
+BLEUartStream::~BLEUartStream() {
+    int id = __atomic_exchange_n(&flushEvent, 0, __ATOMIC_RELAXED);
+    if (id) queue->cancel(id);
+}
+
+ssize_t BLEUartStream::read(void *data, size_t size) {
+    if (!size) return 0;
+
+    uint8_t *bytes = static_cast<uint8_t *>(data);
+    int n = uart.read(bytes, static_cast<int>(size));
+    if (!n && blocking) {
+        // whoever waits for input wants to see the prompt
+        sync();
+        while (!n) n = uart.read(bytes, static_cast<int>(size), osWaitForever);
+    }
+    return n ? n : -EAGAIN;
+}
+
+ssize_t BLEUartStream::write(const void *data, size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    size_t taken = 0;
+
+    mutex.lock();
+    while (taken < size) {
+        // fill whole notifications, the payload changes with the peers connected
+        size_t payload = BLEManager::getInstance().getMaxPayload();
+        if (payload > sizeof(buffer)) payload = sizeof(buffer);
+        if (length >= payload) {
+            flush(blocking);
+            // the link stalled, the caller keeps the rest
+            if (length >= payload) break;
+        }
+
+        size_t n = size - taken < payload - length ? size - taken : payload - length;
+        bool newline = false;
+        if (lineBuffered) {
+            const uint8_t *end = static_cast<const uint8_t *>(memchr(bytes + taken, '\n', n));
+            if (end) {
+                n = static_cast<size_t>(end - (bytes + taken)) + 1;
+                newline = true;
+            }
+        }
+        memcpy(buffer + length, bytes + taken, n);
+        length = static_cast<uint16_t>(length + n);
+        taken += n;
+
+        if (newline || length >= payload) flush(blocking);
+    }
+    scheduleFlush();
+    mutex.unlock();
+
+    return taken ? static_cast<ssize_t>(taken) : -EAGAIN;
+}
+
+off_t BLEUartStream::seek(off_t offset, int whence) {
+    (void) offset;
+    (void) whence;
+    return -ESPIPE;
+}
+
+int BLEUartStream::close() {
+    int result = sync();
+
+    mutex.lock();
+    int id = __atomic_exchange_n(&flushEvent, 0, __ATOMIC_RELAXED);
+    if (id) queue->cancel(id);
+    mutex.unlock();
+
+    return result;
+}
+
+int BLEUartStream::sync() {
+    mutex.lock();
+    flush(blocking);
+    int result = length ? -EAGAIN : 0;
+    scheduleFlush();
+    mutex.unlock();
+    return result;
+}
+
+int BLEUartStream::isatty() {
+    return true;
+}
+
+int BLEUartStream::set_blocking(bool _blocking) {
+    blocking = _blocking;
+    return 0;
+}
+
+bool BLEUartStream::is_blocking() const {
+    return blocking;
+}
+
+short BLEUartStream::poll(short events) const {
+    short revents = 0;
+    if ((events & POLLIN) && uart.isReadable()) revents |= POLLIN;
+    if (events & POLLOUT) revents |= POLLOUT;
+    return revents;
+}
+
+void BLEUartStream::setLineBuffered(bool _lineBuffered) {
+    lineBuffered = _lineBuffered;
+}
+
+void BLEUartStream::flush(bool wait) {
+    if (!length) return;
+
+    int sent = wait ? uart.send(buffer, length) : uart.sendAsync(buffer, length);
+    if (sent == EOF) {
+        // nobody is connected to read it
+        length = 0;
+        return;
+    }
+    length = static_cast<uint16_t>(length - sent);
+    if (length) memmove(buffer, buffer + sent, length);
+}
+
+void BLEUartStream::scheduleFlush() {
+    if (!length || !maxLatencyMs || __atomic_load_n(&flushEvent, __ATOMIC_RELAXED)) return;
+    __atomic_store_n(&flushEvent, queue->call_in(static_cast<int>(maxLatencyMs), this, &BLEUartStream::onFlushTimer),
+                     __ATOMIC_RELAXED);
+}
+
+void BLEUartStream::onFlushTimer() {
+    // a writer holding the lock may wait for the link, try again later instead of blocking the queue
+    if (!mutex.trylock()) {
+        __atomic_store_n(&flushEvent, queue->call_in(static_cast<int>(maxLatencyMs), this,
+                                                     &BLEUartStream::onFlushTimer), __ATOMIC_RELAXED);
+        return;
+    }
+
+    __atomic_store_n(&flushEvent, 0, __ATOMIC_RELAXED);
+    // never wait on the queue, what does not fit is sent with the next round
+    flush(false);
+    scheduleFlush();
+    mutex.unlock();
+}
@@ -0,0 +1,181 @@
+/*!
+ * @file
+ * @brief Buffered stdio stream over the BLE UART service
+ *
+ * Coalesces small writes like printf() output into full notifications
+ * instead of sending one notification per character. The buffer is
+ * flushed when it fills a notification, on a newline, on fsync()/sync()
+ * and at the latest a short time after the first byte was buffered, so
+ * output that ends without a newline still goes out. To route the console over BLE retarget stdio to the stream:
+ *
+ * ```
+ * static BLEUartStream *bleConsole;
+ *
+ * FileHandle *mbed::mbed_override_console(int fd) {
+ *     return bleConsole;
+ * }
+ * ```
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_BLEUARTSTREAM_H
+#define UBIRCH_MBED_BLE_BLEUARTSTREAM_H
+
+#include <mbed.h>
+#include <services/BLEUartService.h>
+
+/** Size of the write buffer, the largest notification payload is 244 bytes. */
+#ifndef BLE_UART_STREAM_BUFFER_SIZE
+#define BLE_UART_STREAM_BUFFER_SIZE 244
+#endif
+
+/**
+ * The longest time written data waits in the buffer before it is sent (ms).
+ * It counts from the first buffered byte, further writes do not extend it.
+ */
+#ifndef BLE_UART_STREAM_MAX_LATENCY
+#define BLE_UART_STREAM_MAX_LATENCY 20
+#endif
+
+class BLEUartStream : public FileHandle {
+
+public:
+    /**
+     * Create a stream on a UART service. All peers receive the output (the
+     * service's shared buffers), input is read from the shared receive
+     * buffer. The stream must be the only sender on the service.
+     * @param _uart the UART service to send and receive with
+     * @param _maxLatencyMs how long buffered data waits at most, counted from the first
+     *        buffered byte, 0 to flush only on a full notification, a newline or sync()
+     * @param _queue the event queue the delayed flush runs on
+     */
+    explicit BLEUartStream(BLEUartService &_uart, uint32_t _maxLatencyMs = BLE_UART_STREAM_MAX_LATENCY,
+                           EventQueue *_queue = mbed_event_queue());
+
+    /**
+     * Cancel the delayed flush and drop what is still buffered, call sync()
+     * or close() before to send it. Must not run while the delayed flush
+     * runs, e.g. delete the stream on its event queue.
+     */
+    virtual ~BLEUartStream();
+
+    /**
+     * Read received data. Blocks until some data is available, unless the
+     * stream is non-blocking. Buffered output is flushed before blocking,
+     * so a prompt is visible while waiting for the answer.
+     * @param buffer the buffer to read into
+     * @param size the size of the buffer
+     * @return the number of bytes read, -EAGAIN if non-blocking and no data is available
+     */
+    virtual ssize_t read(void *buffer, size_t size);
+
+    /**
+     * Buffer data and send it when a notification is full, a line is
+     * complete or the maximum latency expired. Without a connected peer the
+     * data is dropped, like on a serial line without a cable.
+     * @param buffer the data to write
+     * @param size the length of the data
+     * @return the number of bytes taken, less if the link stalled beyond the send
+     *         timeout of the service (blocking) or the send buffer is full
+     *         (non-blocking), -EAGAIN if none was taken
+     */
+    virtual ssize_t write(const void *buffer, size_t size);
+
+    /**
+     * Streams can not seek.
+     * @return -ESPIPE
+     */
+    virtual off_t seek(off_t offset, int whence = SEEK_SET);
+
+    /**
+     * Send all buffered data and cancel the delayed flush.
+     * @return 0, or -EAGAIN if the data could not be sent completely
+     */
+    virtual int close();
+
+    /**
+     * Send all buffered data, waiting for the send buffer of the service if
+     * it is full (blocking) or queueing what fits (non-blocking).
+     * @return 0, or -EAGAIN if the data could not be sent completely
+     */
+    virtual int sync();
+
+    /**
+     * The stream is a terminal, so stdio buffers it line by line.
+     * @return true
+     */
+    virtual int isatty();
+
+    virtual int set_blocking(bool blocking);
+
+    virtual bool is_blocking() const;
+
+    /**
+     * @param events the events of interest
+     * @return POLLIN if data has been received, POLLOUT always, data is buffered or dropped
+     */
+    virtual short poll(short events) const;
+
+    /**
+     * Choose whether a newline flushes the buffer (default). Without, lines
+     * are coalesced until the notification is full or the maximum latency expired.
+     * @param lineBuffered whether to flush on a newline
+     */
+    void setLineBuffered(bool lineBuffered);
+
+protected:
+    /**
+     * Hand the buffered data to the service, keeps what does not fit.
+     * @param wait whether to wait for space in the send buffer
+     */
+    void flush(bool wait);
+
+    /**
+     * Arm the delayed flush if data is buffered and it is not armed yet. An armed
+     * flush is not restarted by further writes, it bounds the latency.
+     */
+    void scheduleFlush();
+
+    /**
+     * The delayed flush, runs on the event queue.
+     */
+    void onFlushTimer();
+
+    BLEUartService &uart;
+    EventQueue *queue;
+    uint32_t maxLatencyMs;
+    bool lineBuffered;
+    bool blocking;
+
+    // serializes writers and the delayed flush, the service allows only one sender
+    Mutex mutex;
+    int flushEvent;
+    uint16_t length;
+    uint8_t buffer[BLE_UART_STREAM_BUFFER_SIZE];
+
+private:
+    // the delayed flush is bound to this instance
+    BLEUartStream(const BLEUartStream &);
+
+    BLEUartStream &operator=(const BLEUartStream &);
+};
+
+#endif //UBIRCH_MBED_BLE_BLEUARTSTREAM_H
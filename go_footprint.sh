@@ -0,0 +1,10 @@
+#! /bin/sh
+# build and run the footprint apps, compare with TESTS/footprint/baseline.csv
+# pass --update to record the measured values as the new baseline
+TESTS='tests-footprint*'
+mbed new .
+mbed target NRF52_DK
+mbed toolchain GCC_ARM
+mbed test --compile -n "$TESTS" --app-config TESTS/footprint/settings.json
+mbedgt -n "$TESTS" --plain --report-memory-metrics-csv=footprint.csv
+python TESTS/footprint/footprint.py --metrics footprint.csv "$@"
@@ -4,4 +4,7 @@ mbed new .
 mbed target NRF52_DK
 mbed toolchain GCC_ARM
 mbed test --compile -n "$TESTS"
-mbedgt -n "$TESTS" --plain --report-junit=testresult.xml --report-memory-metrics-csv=testmem.csv
\ No newline at end of file
+mbedgt -n "$TESTS" --plain --report-junit=testresult.xml --report-memory-metrics-csv=testmem.csv
+# the heap-free build has its own configuration
+mbed test --compile -n 'tests-static*' --app-config TESTS/static/settings.json --build BUILD/tests-static
+mbedgt -n 'tests-static*' --test-spec BUILD/tests-static/test_spec.json --plain --report-memory-metrics-csv=testmem-static.csv
@@ -0,0 +1,390 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API (BLE, Gap and GattServer).
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#include "BLE.h"
+#include "BLESim.h"
+
+BLE &BLE::Instance(InstanceID_t id) {
+    static BLE instance(DEFAULT_INSTANCE);
+    (void) id;
+    return instance;
+}
+
+BLE::BLE(InstanceID_t instanceID) : instanceID(instanceID), initialized(false) {}
+
+ble_error_t BLE::init(InitializationCompleteCallback_t completionCallback) {
+    // the nRF5 port completes initialization synchronously, so does the simulation
+    ble_error_t error = initialized ? BLE_ERROR_ALREADY_INITIALIZED : BLE_ERROR_NONE;
+    initialized = true;
+    if (error == BLE_ERROR_NONE && BLESim::getInstance().deferInit(completionCallback)) return BLE_ERROR_NONE;
+
+    InitializationCompleteCallbackContext context = {*this, error};
+    completionCallback.call(&context);
+    return error;
+}
+
+bool BLE::hasInitialized() const {
+    return initialized;
+}
+
+ble_error_t BLE::shutdown() {
+    if (!initialized) return BLE_ERROR_INITIALIZATION_INCOMPLETE;
+
+    BLESim::getInstance().reset();
+    _gap.reset();
+    _gattServer.reset();
+    initialized = false;
+    return BLE_ERROR_NONE;
+}
+
+const char *BLE::getVersion() {
+    return "BLESim";
+}
+
+Gap &BLE::gap() {
+    return _gap;
+}
+
+const Gap &BLE::gap() const {
+    return _gap;
+}
+
+GattServer &BLE::gattServer() {
+    return _gattServer;
+}
+
+const GattServer &BLE::gattServer() const {
+    return _gattServer;
+}
+
+SecurityManager &BLE::securityManager() {
+    return _securityManager;
+}
+
+void BLE::onEventsToProcess(const OnEventsToProcessCallback_t &callback) {
+    whenEventsToProcess = callback;
+}
+
+void BLE::processEvents() {
+    BLESim::getInstance().process(*this);
+}
+
+void BLE::signalEventsToProcess() {
+    if (whenEventsToProcess) {
+        OnEventsToProcessCallbackContext params = {*this};
+        whenEventsToProcess.call(&params);
+    } else {
+        processEvents();
+    }
+}
+
+// == Gap ==
+
+Gap::Gap() : _advParams(), _preferredTxPhys(PhySet_t::PHY_SET_1M), _preferredRxPhys(PhySet_t::PHY_SET_1M),
+             _eventHandler(NULL) {
+    memset(deviceName, 0, sizeof(deviceName));
+    memset(&_preferredConnectionParams, 0, sizeof(_preferredConnectionParams));
+}
+
+ble_error_t Gap::setDeviceName(const uint8_t *name) {
+    if (!name) return BLE_ERROR_INVALID_PARAM;
+    strncpy(reinterpret_cast<char *>(deviceName), reinterpret_cast<const char *>(name), DEVICE_NAME_MAX_LENGTH);
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t Gap::getDeviceName(uint8_t *name, unsigned *lengthP) {
+    unsigned length = static_cast<unsigned>(strlen(reinterpret_cast<const char *>(deviceName)));
+    if (name) {
+        if (*lengthP < length) return BLE_ERROR_BUFFER_OVERFLOW;
+        memcpy(name, deviceName, length);
+    }
+    *lengthP = length;
+    return BLE_ERROR_NONE;
+}
+
+void Gap::setAdvertisingType(GapAdvertisingParams::AdvertisingType_t advType) {
+    _advParams.setAdvertisingType(advType);
+}
+
+void Gap::setAdvertisingInterval(uint16_t interval) {
+    if (interval == 0) {
+        stopAdvertising();
+    } else if (interval < getMinAdvertisingInterval()) {
+        interval = getMinAdvertisingInterval();
+    }
+    _advParams.setInterval(interval);
+}
+
+uint16_t Gap::getMinAdvertisingInterval() const {
+    return GapAdvertisingParams::ADVERTISEMENT_DURATION_UNITS_TO_MS(GapAdvertisingParams::GAP_ADV_PARAMS_INTERVAL_MIN);
+}
+
+uint16_t Gap::getMinNonConnectableAdvertisingInterval() const {
+    return GapAdvertisingParams::ADVERTISEMENT_DURATION_UNITS_TO_MS(
+            GapAdvertisingParams::GAP_ADV_PARAMS_INTERVAL_MIN_NONCON);
+}
+
+uint16_t Gap::getMaxAdvertisingInterval() const {
+    return GapAdvertisingParams::ADVERTISEMENT_DURATION_UNITS_TO_MS(GapAdvertisingParams::GAP_ADV_PARAMS_INTERVAL_MAX);
+}
+
+void Gap::setAdvertisingTimeout(uint16_t timeout) {
+    _advParams.setTimeout(timeout);
+}
+
+void Gap::setAdvertisingParams(const GapAdvertisingParams &newParams) {
+    _advParams = newParams;
+}
+
+GapAdvertisingParams &Gap::getAdvertisingParams() {
+    return _advParams;
+}
+
+const GapAdvertisingParams &Gap::getAdvertisingParams() const {
+    return _advParams;
+}
+
+ble_error_t Gap::startAdvertising() {
+    return BLESim::getInstance().startAdvertising() ? BLE_ERROR_NONE : BLE_ERROR_INVALID_STATE;
+}
+
+ble_error_t Gap::stopAdvertising() {
+    BLESim::getInstance().stopAdvertising();
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t Gap::accumulateAdvertisingPayload(uint8_t flags) {
+    return _advPayload.addFlags(flags);
+}
+
+ble_error_t Gap::accumulateAdvertisingPayload(GapAdvertisingData::Appearance app) {
+    return _advPayload.addAppearance(app);
+}
+
+ble_error_t Gap::accumulateAdvertisingPayloadTxPower(int8_t power) {
+    return _advPayload.addTxPower(power);
+}
+
+ble_error_t Gap::accumulateAdvertisingPayload(GapAdvertisingData::DataType type, const uint8_t *data, uint8_t len) {
+    return _advPayload.addData(type, data, len);
+}
+
+ble_error_t Gap::updateAdvertisingPayload(GapAdvertisingData::DataType type, const uint8_t *data, uint8_t len) {
+    return _advPayload.updateData(type, data, len);
+}
+
+ble_error_t Gap::setAdvertisingPayload(const GapAdvertisingData &payload) {
+    _advPayload = payload;
+    return BLE_ERROR_NONE;
+}
+
+const GapAdvertisingData &Gap::getAdvertisingPayload() const {
+    return _advPayload;
+}
+
+void Gap::clearAdvertisingPayload() {
+    _advPayload.clear();
+}
+
+ble_error_t Gap::accumulateScanResponse(GapAdvertisingData::DataType type, const uint8_t *data, uint8_t len) {
+    return _scanResponse.addData(type, data, len);
+}
+
+void Gap::clearScanResponse() {
+    _scanResponse.clear();
+}
+
+const GapAdvertisingData &Gap::getScanResponsePayload() const {
+    return _scanResponse;
+}
+
+Gap::GapState_t Gap::getState() const {
+    GapState_t state;
+    state.advertising = BLESim::getInstance().advertising();
+    state.connected = BLESim::getInstance().connected();
+    return state;
+}
+
+ble_error_t Gap::disconnect(Handle_t connectionHandle, DisconnectionReason_t reason) {
+    return BLESim::getInstance().hostDisconnect(connectionHandle, reason);
+}
+
+ble_error_t Gap::getPreferredConnectionParams(ConnectionParams_t *params) {
+    *params = _preferredConnectionParams;
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t Gap::setPreferredConnectionParams(const ConnectionParams_t *params) {
+    _preferredConnectionParams = *params;
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t Gap::updateConnectionParams(Handle_t handle, const ConnectionParams_t *params) {
+    return BLESim::getInstance().updateConnectionParams(handle, params);
+}
+
+ble_error_t Gap::setPreferredPhys(const PhySet_t *txPhys, const PhySet_t *rxPhys) {
+    if (txPhys) _preferredTxPhys = *txPhys;
+    if (rxPhys) _preferredRxPhys = *rxPhys;
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t Gap::setPhy(Handle_t connection, const PhySet_t *txPhys, const PhySet_t *rxPhys,
+                        CodedSymbolPerBit_t codedSymbol) {
+    (void) codedSymbol;
+    return BLESim::getInstance().setPhy(connection, txPhys ? txPhys->value() : _preferredTxPhys.value(),
+                                        rxPhys ? rxPhys->value() : _preferredRxPhys.value());
+}
+
+ble_error_t Gap::reset() {
+    memset(deviceName, 0, sizeof(deviceName));
+    _advParams = GapAdvertisingParams();
+    _advPayload.clear();
+    _scanResponse.clear();
+    timeoutCallbackChain.clear();
+    connectionCallChain.clear();
+    disconnectionCallChain.clear();
+    _preferredTxPhys = _preferredRxPhys = PhySet_t(PhySet_t::PHY_SET_1M);
+    _eventHandler = NULL;
+    return BLE_ERROR_NONE;
+}
+
+// == GattServer ==
+
+GattServer::GattServer() : serviceCount(0), attributeCount(0), nextHandle(1), eventHandler(NULL) {}
+
+ble_error_t GattServer::addService(GattService &service) {
+    // the table is full, like the SoftDevice's attribute table
+    if (serviceCount == MAX_SERVICES || attributeCount + service.getCharacteristicCount() > MAX_ATTRIBUTES)
+        return BLE_ERROR_NO_MEM;
+    for (uint8_t i = 0; i < service.getCharacteristicCount(); i++) {
+        if (service.getCharacteristic(i)->getValueAttribute().getMaxLength() > MAX_VALUE_LENGTH)
+            return BLE_ERROR_INVALID_PARAM;
+    }
+
+    // handle layout as on the target: service, then declaration, value and CCCD per characteristic
+    Service &s = services[serviceCount++];
+    s.uuid = service.getUUID();
+    s.handle = nextHandle++;
+    service.setHandle(s.handle);
+
+    for (uint8_t i = 0; i < service.getCharacteristicCount(); i++) {
+        GattCharacteristic *characteristic = service.getCharacteristic(i);
+        GattAttribute &valueAttribute = characteristic->getValueAttribute();
+
+        nextHandle++; // characteristic declaration
+        Attribute &attribute = attributes[attributeCount++];
+        attribute.handle = nextHandle++;
+        attribute.characteristic = characteristic;
+        attribute.maxLength = valueAttribute.getMaxLength();
+        memset(attribute.value, 0, attribute.maxLength);
+        attribute.length = valueAttribute.getLength();
+        if (valueAttribute.getValuePtr() && attribute.length)
+            memcpy(attribute.value, valueAttribute.getValuePtr(), attribute.length);
+        valueAttribute.setHandle(attribute.handle);
+
+        if (characteristic->getProperties() & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY |
+                                               GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE))
+            nextHandle++;
+        for (uint8_t d = 0; d < characteristic->getDescriptorCount(); d++)
+            characteristic->getDescriptor(d)->setHandle(nextHandle++);
+    }
+    return BLE_ERROR_NONE;
+}
+
+GattServer::Attribute *GattServer::findAttribute(GattAttribute::Handle_t handle) {
+    for (unsigned i = 0; i < attributeCount; i++) {
+        if (attributes[i].handle == handle) return &attributes[i];
+    }
+    return NULL;
+}
+
+ble_error_t GattServer::read(GattAttribute::Handle_t attributeHandle, uint8_t *buffer, uint16_t *lengthP) {
+    Attribute *attribute = findAttribute(attributeHandle);
+    if (!attribute) return BLE_ERROR_INVALID_PARAM;
+    if (*lengthP > attribute->length) *lengthP = attribute->length;
+    if (*lengthP) memcpy(buffer, &attribute->value[0], *lengthP);
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t GattServer::read(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle,
+                             uint8_t *buffer, uint16_t *lengthP) {
+    (void) connectionHandle;
+    return read(attributeHandle, buffer, lengthP);
+}
+
+ble_error_t GattServer::write(GattAttribute::Handle_t attributeHandle, const uint8_t *value, uint16_t size,
+                              bool localOnly) {
+    Attribute *attribute = findAttribute(attributeHandle);
+    if (!attribute) return BLE_ERROR_INVALID_PARAM;
+    if (size > attribute->maxLength) return BLE_ERROR_INVALID_PARAM;
+    if (size) memcpy(&attribute->value[0], value, size);
+    attribute->length = size;
+    if (localOnly) return BLE_ERROR_NONE;
+
+    ble_error_t result = BLE_ERROR_NONE;
+    for (Gap::Handle_t connection = 0; connection < BLESim::MAX_CONNECTIONS; connection++) {
+        ble_error_t error = BLESim::getInstance().notify(connection, attributeHandle, value, size);
+        if (error != BLE_ERROR_NONE) result = error;
+    }
+    return result;
+}
+
+ble_error_t GattServer::write(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle,
+                              const uint8_t *value, uint16_t size, bool localOnly) {
+    Attribute *attribute = findAttribute(attributeHandle);
+    if (!attribute) return BLE_ERROR_INVALID_PARAM;
+    if (size > attribute->maxLength) return BLE_ERROR_INVALID_PARAM;
+    if (size) memcpy(&attribute->value[0], value, size);
+    attribute->length = size;
+    if (localOnly) return BLE_ERROR_NONE;
+
+    return BLESim::getInstance().notify(connectionHandle, attributeHandle, value, size);
+}
+
+ble_error_t GattServer::areUpdatesEnabled(const GattCharacteristic &characteristic, bool *enabledP) {
+    *enabledP = false;
+    for (Gap::Handle_t connection = 0; connection < BLESim::MAX_CONNECTIONS && !*enabledP; connection++)
+        *enabledP = BLESim::getInstance().isSubscribed(connection, characteristic.getValueHandle());
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t GattServer::areUpdatesEnabled(Gap::Handle_t connectionHandle, const GattCharacteristic &characteristic,
+                                          bool *enabledP) {
+    *enabledP = BLESim::getInstance().isSubscribed(connectionHandle, characteristic.getValueHandle());
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t GattServer::reset() {
+    serviceCount = 0;
+    attributeCount = 0;
+    nextHandle = 1;
+    dataSentCallChain.clear();
+    dataWrittenCallChain.clear();
+    updatesEnabledCallback = NULL;
+    updatesDisabledCallback = NULL;
+    confirmationReceivedCallback = NULL;
+    eventHandler = NULL;
+    return BLE_ERROR_NONE;
+}
@@ -0,0 +1,129 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API entry point.
+ *
+ * Events raised by the simulated controller (see BLESim.h) are queued and
+ * announced through the onEventsToProcess() callback, exactly like the
+ * softdevice interrupt does on the target. They are only delivered to the
+ * Gap and GattServer callbacks when processEvents() is called.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_BLE_H
+#define UBIRCH_MBED_BLE_SIM_BLE_H
+
+#include "blecommon.h"
+#include "FunctionPointerWithContext.h"
+#include "Gap.h"
+#include "GattServer.h"
+#include "SecurityManager.h"
+
+class BLE {
+public:
+    typedef unsigned InstanceID_t;
+
+    static const InstanceID_t DEFAULT_INSTANCE = 0;
+    static const InstanceID_t NUM_INSTANCES = 1;
+
+    struct InitializationCompleteCallbackContext {
+        BLE &ble;
+        ble_error_t error;
+    };
+
+    struct OnEventsToProcessCallbackContext {
+        BLE &ble;
+    };
+
+    typedef FunctionPointerWithContext<InitializationCompleteCallbackContext *> InitializationCompleteCallback_t;
+    typedef FunctionPointerWithContext<OnEventsToProcessCallbackContext *> OnEventsToProcessCallback_t;
+
+    static BLE &Instance(InstanceID_t id = DEFAULT_INSTANCE);
+
+    InstanceID_t getInstanceID() const {
+        return instanceID;
+    }
+
+    ble_error_t init(InitializationCompleteCallback_t completionCallback = NULL);
+
+    template<typename T>
+    ble_error_t init(T *object, void (T::*completionCallback)(InitializationCompleteCallbackContext *context)) {
+        return init(InitializationCompleteCallback_t(object, completionCallback));
+    }
+
+    bool hasInitialized() const;
+
+    ble_error_t shutdown();
+
+    const char *getVersion();
+
+    Gap &gap();
+
+    const Gap &gap() const;
+
+    GattServer &gattServer();
+
+    const GattServer &gattServer() const;
+
+    SecurityManager &securityManager();
+
+    void onEventsToProcess(const OnEventsToProcessCallback_t &callback);
+
+    /**
+     * Deliver all pending stack events to the registered callbacks.
+     */
+    void processEvents();
+
+    /**
+     * Called by the simulated controller whenever new events are pending.
+     */
+    void signalEventsToProcess();
+
+    // deprecated mbed API still used by applications
+    Gap::GapState_t getGapState() const {
+        return gap().getState();
+    }
+
+    ble_error_t addService(GattService &service) {
+        return gattServer().addService(service);
+    }
+
+    ble_error_t purgeAllBondingState() {
+        return securityManager().purgeAllBondingState();
+    }
+
+private:
+    friend class BLESim;
+
+    explicit BLE(InstanceID_t instanceID);
+
+    BLE(const BLE &);
+
+    BLE &operator=(const BLE &);
+
+    InstanceID_t instanceID;
+    bool initialized;
+    Gap _gap;
+    GattServer _gattServer;
+    SecurityManager _securityManager;
+    OnEventsToProcessCallback_t whenEventsToProcess;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_BLE_H
@@ -0,0 +1,858 @@
+/*!
+ * @file
+ * @brief Simulated BLE controller and central for host builds.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#include <cerrno>
+#include <ctime>
+#include <cstdio>
+#include "BLESim.h"
+
+// default connection: 30ms interval, no latency, 4s supervision timeout
+static const Gap::ConnectionParams_t defaultConnectionParams = {24, 24, 0, 400};
+
+BLESim &BLESim::getInstance() {
+    static BLESim instance;
+    return instance;
+}
+
+BLESim::BLESim() : isAdvertising(false), advertisingTime(0), randomState(0x2545F491), centralMinInterval(6), centralDataLength(MAX_DATA_LENGTH), centralLe2M(true), txBuffers(DEFAULT_TX_BUFFERS), linkStalled(false), busyWrites(0), initDeferred(false), initPending(false), eventHead(0), eventTail(0), dataSent(0), processing(false), processor() {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond, &attr);
+    pthread_condattr_destroy(&attr);
+    memset(connections, 0, sizeof(connections));
+}
+
+ble_error_t BLESim::updateConnectionParams(Gap::Handle_t connection, const Gap::ConnectionParams_t *params) {
+    // the limits of the core specification, the supervision timeout must cover two (latent) intervals
+    if (params->minConnectionInterval < 6 || params->maxConnectionInterval > 3200 ||
+        params->minConnectionInterval > params->maxConnectionInterval || params->slaveLatency > 499 ||
+        params->connectionSupervisionTimeout < 10 || params->connectionSupervisionTimeout > 3200 ||
+        params->connectionSupervisionTimeout * 4u <= (1u + params->slaveLatency) * params->maxConnectionInterval)
+        return BLE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    if (!c) {
+        pthread_mutex_unlock(&mutex);
+        return BLE_ERROR_INVALID_STATE;
+    }
+    if (params->maxConnectionInterval >= centralMinInterval) {
+        c->params = *params;
+        c->params.minConnectionInterval = c->params.maxConnectionInterval =
+                params->minConnectionInterval > centralMinInterval ? params->minConnectionInterval : centralMinInterval;
+    }
+    pthread_mutex_unlock(&mutex);
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t BLESim::setPhy(Gap::Handle_t connection, uint8_t txPhys, uint8_t rxPhys) {
+    if (!txPhys || !rxPhys) return BLE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    if (!c) {
+        pthread_mutex_unlock(&mutex);
+        return BLE_ERROR_INVALID_STATE;
+    }
+    // both directions use the same PHY, the coded PHY is not simulated
+    Event event;
+    event.type = EVENT_PHY_UPDATE;
+    event.connection = connection;
+    event.status = BLE_ERROR_NONE;
+    if (!centralLe2M) {
+        // the central answers with LL_UNKNOWN_RSP, the connection stays on its PHY
+        event.status = BLE_ERROR_OPERATION_NOT_PERMITTED;
+    } else if ((txPhys & rxPhys & ble::phy_set_t::PHY_SET_2M)) {
+        c->phy = ble::phy_t::LE_2M;
+    } else if ((txPhys & rxPhys & ble::phy_set_t::PHY_SET_1M)) {
+        c->phy = ble::phy_t::LE_1M;
+    }
+    event.phy = c->phy;
+    pthread_mutex_unlock(&mutex);
+
+    post(event);
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t BLESim::updateDataLength(Gap::Handle_t connection, uint16_t txOctets) {
+    if (txOctets < DEFAULT_DATA_LENGTH || txOctets > MAX_DATA_LENGTH) return BLE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    if (!c) {
+        pthread_mutex_unlock(&mutex);
+        return BLE_ERROR_INVALID_STATE;
+    }
+    // the link uses what both sides support, a central without the extension keeps 27 octets
+    uint16_t length = txOctets < centralDataLength ? txOctets : centralDataLength;
+    bool changed = length != c->dataLength;
+    c->dataLength = length;
+    pthread_mutex_unlock(&mutex);
+
+    if (changed) {
+        Event event;
+        event.type = EVENT_DATA_LENGTH_CHANGE;
+        event.connection = connection;
+        event.len = length;
+        post(event);
+    }
+    return BLE_ERROR_NONE;
+}
+
+void BLESim::setCentralLinkFeatures(uint16_t maxDataLength, bool le2M) {
+    pthread_mutex_lock(&mutex);
+    centralDataLength = maxDataLength;
+    centralLe2M = le2M;
+    pthread_mutex_unlock(&mutex);
+}
+
+uint16_t BLESim::getDataLength(Gap::Handle_t connection) {
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    uint16_t length = c ? c->dataLength : static_cast<uint16_t>(0);
+    pthread_mutex_unlock(&mutex);
+    return length;
+}
+
+ble::phy_t BLESim::getPhy(Gap::Handle_t connection) {
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    ble::phy_t phy = c ? c->phy : ble::phy_t::NONE;
+    pthread_mutex_unlock(&mutex);
+    return phy;
+}
+
+Gap::ConnectionParams_t BLESim::getConnectionParams(Gap::Handle_t connection) {
+    Gap::ConnectionParams_t params;
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    if (c) params = c->params;
+    else memset(&params, 0, sizeof(params));
+    pthread_mutex_unlock(&mutex);
+    return params;
+}
+
+void BLESim::setCentralMinInterval(uint16_t interval) {
+    pthread_mutex_lock(&mutex);
+    centralMinInterval = interval;
+    pthread_mutex_unlock(&mutex);
+}
+
+uint32_t BLESim::nextRandom() {
+    // xorshift32, reproducible across runs
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 17;
+    randomState ^= randomState << 5;
+    return randomState;
+}
+
+// time on air of a link layer packet and the empty packet acknowledging it, in us
+static uint32_t packetAirTime(uint16_t payload, ble::phy_t::type phy) {
+    // preamble (1 octet on LE 1M, 2 on LE 2M), access address, header and CRC
+    uint32_t overhead = phy == ble::phy_t::LE_2M ? 11 : 10;
+    uint32_t usPerOctet = phy == ble::phy_t::LE_2M ? 4 : 8;
+    // both packets are followed by the inter frame space of 150us
+    return (overhead + payload) * usPerOctet + 150 + overhead * usPerOctet + 150;
+}
+
+BLESim::Connection *BLESim::find(Gap::Handle_t connection) {
+    if (connection >= MAX_CONNECTIONS || !connections[connection].active) return NULL;
+    return &connections[connection];
+}
+
+// == central side ==
+
+bool BLESim::discover(const char *deviceName) {
+    if (!advertising()) return false;
+
+    const Gap &gap = BLE::Instance().gap();
+    const uint8_t *field = gap.getAdvertisingPayload().findField(GapAdvertisingData::COMPLETE_LOCAL_NAME);
+    if (!field) field = gap.getScanResponsePayload().findField(GapAdvertisingData::COMPLETE_LOCAL_NAME);
+    if (!field) return false;
+
+    size_t len = static_cast<size_t>(field[0] - 1);
+    return strlen(deviceName) == len && !memcmp(deviceName, field + 2, len);
+}
+
+uint32_t BLESim::scan(const char *deviceName, uint16_t scanInterval, uint16_t scanWindow) {
+    if (!scanWindow || !discover(deviceName)) return NOT_FOUND;
+
+    const GapAdvertisingParams &advParams = BLE::Instance().gap().getAdvertisingParams();
+    // in microseconds, the advertising interval is a multiple of 0.625ms
+    uint32_t interval = advParams.getIntervalInADVUnits() * 625u;
+    uint32_t timeout = advParams.getTimeout() * 1000000u;
+    uint32_t scanIntervalUs = scanInterval * 1000u;
+    uint32_t scanWindowUs = scanWindow * 1000u;
+
+    pthread_mutex_lock(&mutex);
+    uint32_t elapsed = advertisingTime * 1000u;
+    uint32_t t = nextRandom() % interval;
+    uint32_t scanPhase = nextRandom() % scanIntervalUs;
+    uint32_t latency = NOT_FOUND;
+    for (unsigned event = 0; event < 100000; event++) {
+        if (timeout && elapsed + t >= timeout) break;
+        if ((scanPhase + t) % scanIntervalUs < scanWindowUs) {
+            latency = t / 1000;
+            break;
+        }
+        // advDelay keeps advertisers from colliding forever
+        t += interval + nextRandom() % 10000;
+    }
+    pthread_mutex_unlock(&mutex);
+    return latency;
+}
+
+void BLESim::elapse(uint32_t ms) {
+    uint16_t timeout = BLE::Instance().gap().getAdvertisingParams().getTimeout();
+
+    pthread_mutex_lock(&mutex);
+    bool expired = false;
+    if (isAdvertising) {
+        advertisingTime += ms;
+        if (timeout && advertisingTime >= timeout * 1000u) {
+            isAdvertising = false;
+            expired = true;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+
+    if (expired) {
+        Event event;
+        event.type = EVENT_TIMEOUT;
+        event.reason = Gap::TIMEOUT_SRC_ADVERTISING;
+        post(event);
+    }
+}
+
+Gap::Handle_t BLESim::connect(const Gap::ConnectionParams_t *params) {
+    const GapAdvertisingParams &advParams = BLE::Instance().gap().getAdvertisingParams();
+    if (advParams.getAdvertisingType() != GapAdvertisingParams::ADV_CONNECTABLE_UNDIRECTED &&
+        advParams.getAdvertisingType() != GapAdvertisingParams::ADV_CONNECTABLE_DIRECTED)
+        return INVALID_CONNECTION;
+
+    pthread_mutex_lock(&mutex);
+    Gap::Handle_t handle = INVALID_CONNECTION;
+    if (isAdvertising) {
+        for (Gap::Handle_t i = 0; i < MAX_CONNECTIONS; i++) {
+            if (!connections[i].active) {
+                handle = i;
+                break;
+            }
+        }
+    }
+    if (handle == INVALID_CONNECTION) {
+        pthread_mutex_unlock(&mutex);
+        return INVALID_CONNECTION;
+    }
+
+    Connection &c = connections[handle];
+    memset(&c, 0, sizeof(c));
+    c.active = true;
+    c.params = params ? *params : defaultConnectionParams;
+    c.mtu = DEFAULT_ATT_MTU;
+    c.dataLength = DEFAULT_DATA_LENGTH;
+    c.phy = ble::phy_t::LE_1M;
+    // a peripheral stops advertising when a central connects
+    isAdvertising = false;
+    pthread_mutex_unlock(&mutex);
+
+    Event event;
+    event.type = EVENT_CONNECTION;
+    event.connection = handle;
+    event.params = c.params;
+    post(event);
+    return handle;
+}
+
+ble_error_t BLESim::disconnect(Gap::Handle_t connection, Gap::DisconnectionReason_t reason) {
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    if (c) c->active = false;
+    pthread_mutex_unlock(&mutex);
+    if (!c) return BLE_ERROR_INVALID_PARAM;
+
+    Event event;
+    event.type = EVENT_DISCONNECTION;
+    event.connection = connection;
+    event.reason = static_cast<uint16_t>(reason);
+    post(event);
+    return BLE_ERROR_NONE;
+}
+
+bool BLESim::isConnected(Gap::Handle_t connection) {
+    pthread_mutex_lock(&mutex);
+    bool result = find(connection) != NULL;
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+uint16_t BLESim::exchangeMtu(Gap::Handle_t connection, uint16_t clientMtu) {
+    if (clientMtu < DEFAULT_ATT_MTU) clientMtu = DEFAULT_ATT_MTU;
+    uint16_t mtu = clientMtu < MAX_ATT_MTU ? clientMtu : MAX_ATT_MTU;
+
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    if (c) c->mtu = mtu;
+    pthread_mutex_unlock(&mutex);
+    if (!c) return 0;
+
+    Event event;
+    event.type = EVENT_ATT_MTU_CHANGE;
+    event.connection = connection;
+    event.mtu = mtu;
+    post(event);
+    return mtu;
+}
+
+uint16_t BLESim::getMtu(Gap::Handle_t connection) {
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    uint16_t mtu = c ? c->mtu : 0;
+    pthread_mutex_unlock(&mutex);
+    return mtu;
+}
+
+void BLESim::setTxBuffers(unsigned buffers) {
+    pthread_mutex_lock(&mutex);
+    txBuffers = buffers;
+    pthread_mutex_unlock(&mutex);
+}
+
+void BLESim::setLinkStalled(bool stalled) {
+    pthread_mutex_lock(&mutex);
+    linkStalled = stalled;
+    bool signal = !stalled && dataSent;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+    // the held back notifications go out now
+    if (signal) BLE::Instance().signalEventsToProcess();
+}
+
+void BLESim::setBusy(unsigned writes) {
+    pthread_mutex_lock(&mutex);
+    busyWrites = writes;
+    pthread_mutex_unlock(&mutex);
+}
+
+void BLESim::setInitDeferred(bool deferred) {
+    pthread_mutex_lock(&mutex);
+    initDeferred = deferred;
+    if (!deferred) initPending = false;
+    pthread_mutex_unlock(&mutex);
+}
+
+bool BLESim::deferInit(const BLE::InitializationCompleteCallback_t &callback) {
+    pthread_mutex_lock(&mutex);
+    bool deferred = initDeferred;
+    if (deferred) {
+        pendingInit = callback;
+        initPending = true;
+    }
+    pthread_mutex_unlock(&mutex);
+    return deferred;
+}
+
+bool BLESim::completeInit() {
+    pthread_mutex_lock(&mutex);
+    bool pending = initPending;
+    initPending = false;
+    BLE::InitializationCompleteCallback_t callback = pendingInit;
+    pthread_mutex_unlock(&mutex);
+    if (!pending) return false;
+
+    // the stack reports itself up, whatever happened in the meantime
+    BLE &ble = BLE::Instance();
+    ble.initialized = true;
+    BLE::InitializationCompleteCallbackContext context = {ble, BLE_ERROR_NONE};
+    callback.call(&context);
+    return true;
+}
+
+GattAttribute::Handle_t BLESim::findCharacteristic(const UUID &uuid, unsigned index) {
+    GattServer &server = BLE::Instance().gattServer();
+    for (unsigned i = 0; i < server.attributeCount; i++) {
+        if (server.attributes[i].characteristic->getValueAttribute().getUUID() == uuid && !index--)
+            return server.attributes[i].handle;
+    }
+    return GattAttribute::INVALID_HANDLE;
+}
+
+bool BLESim::hasService(const UUID &uuid) {
+    GattServer &server = BLE::Instance().gattServer();
+    for (unsigned i = 0; i < server.serviceCount; i++) {
+        if (server.services[i].uuid == uuid) return true;
+    }
+    return false;
+}
+
+ble_error_t BLESim::subscribe(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, bool enable) {
+    GattServer::Attribute *attribute = BLE::Instance().gattServer().findAttribute(valueHandle);
+    if (!attribute) return BLE_ERROR_INVALID_PARAM;
+    if (!(attribute->characteristic->getProperties() & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_NOTIFY |
+                                                        GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_INDICATE)))
+        return BLE_ERROR_OPERATION_NOT_PERMITTED;
+
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    if (!c) {
+        pthread_mutex_unlock(&mutex);
+        return BLE_ERROR_INVALID_STATE;
+    }
+    bool done = false;
+    for (unsigned i = 0; i < MAX_SUBSCRIPTIONS && !done; i++) {
+        if (enable && (c->subscriptions[i] == valueHandle || c->subscriptions[i] == GattAttribute::INVALID_HANDLE)) {
+            c->subscriptions[i] = valueHandle;
+            done = true;
+        } else if (!enable && c->subscriptions[i] == valueHandle) {
+            c->subscriptions[i] = GattAttribute::INVALID_HANDLE;
+            done = true;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    if (!done) return enable ? BLE_ERROR_NO_MEM : BLE_ERROR_NONE;
+
+    Event event;
+    event.type = enable ? EVENT_UPDATES_ENABLED : EVENT_UPDATES_DISABLED;
+    event.connection = connection;
+    event.handle = valueHandle;
+    post(event);
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t BLESim::write(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, const uint8_t *data,
+                          uint16_t len) {
+    GattServer::Attribute *attribute = BLE::Instance().gattServer().findAttribute(valueHandle);
+    if (!attribute) return BLE_ERROR_INVALID_PARAM;
+    if (!(attribute->characteristic->getProperties() & (GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE |
+                                                        GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_WRITE_WITHOUT_RESPONSE)))
+        return BLE_ERROR_OPERATION_NOT_PERMITTED;
+    if (len > attribute->maxLength) return BLE_ERROR_INVALID_PARAM;
+
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    uint16_t mtu = c ? c->mtu : 0;
+    pthread_mutex_unlock(&mutex);
+    if (!c) return BLE_ERROR_INVALID_STATE;
+    // a write command can not carry more than the ATT MTU allows
+    if (len > mtu - 3) return BLE_ERROR_PARAM_OUT_OF_RANGE;
+
+    Event event;
+    event.type = EVENT_DATA_WRITTEN;
+    event.connection = connection;
+    event.handle = valueHandle;
+    event.len = len;
+    memcpy(event.data, data, len);
+    post(event);
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t BLESim::read(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, uint8_t *buffer,
+                         uint16_t *length) {
+    GattServer::Attribute *attribute = BLE::Instance().gattServer().findAttribute(valueHandle);
+    if (!attribute) return BLE_ERROR_INVALID_PARAM;
+    if (!(attribute->characteristic->getProperties() & GattCharacteristic::BLE_GATT_CHAR_PROPERTIES_READ))
+        return BLE_ERROR_OPERATION_NOT_PERMITTED;
+
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    uint16_t mtu = c ? c->mtu : 0;
+    pthread_mutex_unlock(&mutex);
+    if (!c) return BLE_ERROR_INVALID_STATE;
+
+    // read, then read blob requests until a response is shorter than (ATT MTU - 1)
+    uint16_t n = 0;
+    for (;;) {
+        GattReadAuthCallbackParams auth;
+        auth.connHandle = connection;
+        auth.handle = valueHandle;
+        auth.offset = n;
+        auth.len = 0;
+        auth.data = NULL;
+        auth.authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+        if (attribute->characteristic->authorizeRead(&auth) != AUTH_CALLBACK_REPLY_SUCCESS)
+            return BLE_ERROR_OPERATION_NOT_PERMITTED;
+
+        // the application may answer with its own data instead of the stored value
+        const uint8_t *data = auth.data;
+        uint16_t available = auth.len;
+        if (!data) {
+            data = attribute->length > n ? &attribute->value[n] : NULL;
+            available = static_cast<uint16_t>(attribute->length > n ? attribute->length - n : 0);
+        }
+        uint16_t chunk = available < mtu - 1 ? available : static_cast<uint16_t>(mtu - 1);
+        if (chunk > *length - n) chunk = static_cast<uint16_t>(*length - n);
+        if (chunk) memcpy(buffer + n, data, chunk);
+        n = static_cast<uint16_t>(n + chunk);
+        if (chunk < mtu - 1 || n == *length) break;
+    }
+    *length = n;
+    return BLE_ERROR_NONE;
+}
+
+uint16_t BLESim::receive(Gap::Handle_t connection, uint8_t *buffer, uint16_t size) {
+    if (connection >= MAX_CONNECTIONS) return 0;
+    pthread_mutex_lock(&mutex);
+    Connection &c = connections[connection];
+    uint16_t n = 0;
+    while (n < size && c.rxTail != c.rxHead) {
+        buffer[n++] = c.rx[c.rxTail];
+        c.rxTail = static_cast<uint16_t>((c.rxTail + 1) % PEER_BUFFER_SIZE);
+    }
+    pthread_mutex_unlock(&mutex);
+    return n;
+}
+
+uint16_t BLESim::available(Gap::Handle_t connection) {
+    if (connection >= MAX_CONNECTIONS) return 0;
+    pthread_mutex_lock(&mutex);
+    Connection &c = connections[connection];
+    uint16_t n = static_cast<uint16_t>((c.rxHead + PEER_BUFFER_SIZE - c.rxTail) % PEER_BUFFER_SIZE);
+    pthread_mutex_unlock(&mutex);
+    return n;
+}
+
+BLESim::PeerStats BLESim::stats(Gap::Handle_t connection) {
+    PeerStats result;
+    memset(&result, 0, sizeof(result));
+    if (connection >= MAX_CONNECTIONS) return result;
+    pthread_mutex_lock(&mutex);
+    result = connections[connection].stats;
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+uint32_t BLESim::linkThroughput(Gap::Handle_t connection) {
+    PeerStats stats = this->stats(connection);
+    Gap::ConnectionParams_t params = getConnectionParams(connection);
+    if (!stats.notifications || !params.maxConnectionInterval) return 0;
+
+    pthread_mutex_lock(&mutex);
+    uint64_t perEvent = txBuffers;
+    pthread_mutex_unlock(&mutex);
+
+    uint64_t intervalUs = params.maxConnectionInterval * 1250u;
+    uint64_t fit = intervalUs * stats.notifications / stats.airTimeUs;
+    if (fit < perEvent) perEvent = fit ? fit : 1;
+    return static_cast<uint32_t>(perEvent * stats.bytes * 1000000u / stats.notifications / intervalUs);
+}
+
+bool BLESim::flush(uint32_t timeoutMs) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += timeoutMs / 1000;
+    ts.tv_nsec += (timeoutMs % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&mutex);
+    bool done = true;
+    while (eventHead != eventTail || (dataSent && !linkStalled) || processing) {
+        if (pthread_cond_timedwait(&cond, &mutex, &ts) == ETIMEDOUT) {
+            done = false;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&mutex);
+    return done;
+}
+
+void BLESim::onNotification(mbed::Callback<void(const Notification *)> listener) {
+    pthread_mutex_lock(&mutex);
+    notificationListener = listener;
+    pthread_mutex_unlock(&mutex);
+}
+
+void BLESim::reset() {
+    pthread_mutex_lock(&mutex);
+    // let the event thread finish the event it is dispatching, or it advances the cleared queue
+    while (processing) pthread_cond_wait(&cond, &mutex);
+    isAdvertising = false;
+    advertisingTime = 0;
+    randomState = 0x2545F491;
+    centralMinInterval = 6;
+    centralDataLength = MAX_DATA_LENGTH;
+    centralLe2M = true;
+    txBuffers = DEFAULT_TX_BUFFERS;
+    linkStalled = false;
+    busyWrites = 0;
+    // a held back completion stays pending, the stack may still deliver it after a shutdown
+    initDeferred = false;
+    notificationListener = NULL;
+    for (unsigned i = 0; i < MAX_CONNECTIONS; i++) connections[i].active = false;
+    eventHead = eventTail = 0;
+    dataSent = 0;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+}
+
+// == controller side ==
+
+bool BLESim::advertising() {
+    pthread_mutex_lock(&mutex);
+    bool result = isAdvertising;
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+bool BLESim::startAdvertising() {
+    pthread_mutex_lock(&mutex);
+    isAdvertising = true;
+    advertisingTime = 0;
+    pthread_mutex_unlock(&mutex);
+    return true;
+}
+
+void BLESim::stopAdvertising() {
+    pthread_mutex_lock(&mutex);
+    isAdvertising = false;
+    pthread_mutex_unlock(&mutex);
+}
+
+bool BLESim::connected() {
+    pthread_mutex_lock(&mutex);
+    bool result = false;
+    for (unsigned i = 0; i < MAX_CONNECTIONS && !result; i++) result = connections[i].active;
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+bool BLESim::isSubscribed(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle) {
+    pthread_mutex_lock(&mutex);
+    bool result = false;
+    Connection *c = find(connection);
+    for (unsigned i = 0; c && i < MAX_SUBSCRIPTIONS && !result; i++) result = c->subscriptions[i] == valueHandle;
+    pthread_mutex_unlock(&mutex);
+    return result;
+}
+
+ble_error_t BLESim::notify(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, const uint8_t *data,
+                           uint16_t len) {
+    pthread_mutex_lock(&mutex);
+    Connection *c = find(connection);
+    bool subscribed = false;
+    for (unsigned i = 0; c && i < MAX_SUBSCRIPTIONS && !subscribed; i++)
+        subscribed = c->subscriptions[i] == valueHandle;
+    if (!subscribed) {
+        pthread_mutex_unlock(&mutex);
+        return BLE_ERROR_NONE;
+    }
+
+    if (busyWrites) {
+        busyWrites--;
+        c->stats.busy++;
+        pthread_mutex_unlock(&mutex);
+        return BLE_STACK_BUSY;
+    }
+
+    // all notification buffers are waiting to be sent
+    if (c->txInFlight >= txBuffers) {
+        c->stats.noMemory++;
+        pthread_mutex_unlock(&mutex);
+        return BLE_ERROR_NO_MEM;
+    }
+    c->txInFlight++;
+    if (c->txInFlight > c->stats.maxInFlight) c->stats.maxInFlight = c->txInFlight;
+
+    // like the softdevice, notifications larger than the ATT MTU allows are truncated
+    if (len > c->mtu - 3) {
+        len = static_cast<uint16_t>(c->mtu - 3);
+        c->stats.truncated++;
+    }
+    for (uint16_t i = 0; i < len; i++) {
+        uint16_t next = static_cast<uint16_t>((c->rxHead + 1) % PEER_BUFFER_SIZE);
+        if (next == c->rxTail) {
+            c->stats.overflow += len - i;
+            break;
+        }
+        c->rx[c->rxHead] = data[i];
+        c->rxHead = next;
+    }
+    if (notificationListener) {
+        Notification notification = {connection, valueHandle, data, len};
+        notificationListener(&notification);
+    }
+    c->stats.notifications++;
+    c->stats.bytes += len;
+    // the L2CAP and ATT headers (7 octets) travel with the payload, fragmented into link layer packets
+    for (uint32_t pdu = len + 7u; pdu; ) {
+        uint16_t fragment = static_cast<uint16_t>(pdu < c->dataLength ? pdu : c->dataLength);
+        c->stats.packets++;
+        c->stats.airTimeUs += packetAirTime(fragment, c->phy);
+        pdu -= fragment;
+    }
+    if (len > c->stats.maxPayload) c->stats.maxPayload = len;
+
+    // the packet goes out with the next connection event (event processing), raise a TX complete event
+    bool signal = dataSent++ == 0;
+    pthread_mutex_unlock(&mutex);
+
+    if (signal) BLE::Instance().signalEventsToProcess();
+    return BLE_ERROR_NONE;
+}
+
+ble_error_t BLESim::hostDisconnect(Gap::Handle_t connection, Gap::DisconnectionReason_t reason) {
+    (void) reason;
+    return disconnect(connection, Gap::LOCAL_HOST_TERMINATED_CONNECTION);
+}
+
+void BLESim::post(const Event &event) {
+    pthread_mutex_lock(&mutex);
+    while (eventTail - eventHead >= MAX_EVENTS) {
+        if (processing && pthread_equal(processor, pthread_self())) {
+            // posting from a stack callback while the queue is full would dead lock
+            fprintf(stderr, "BLESim: event queue full, dropping event %d\r\n", event.type);
+            pthread_mutex_unlock(&mutex);
+            return;
+        }
+        pthread_cond_wait(&cond, &mutex);
+    }
+    events[eventTail % MAX_EVENTS] = event;
+    eventTail++;
+    pthread_mutex_unlock(&mutex);
+
+    BLE::Instance().signalEventsToProcess();
+}
+
+void BLESim::process(BLE &ble) {
+    pthread_mutex_lock(&mutex);
+    // a single thread processes events, like the BLE event thread on the target
+    if (processing) {
+        pthread_mutex_unlock(&mutex);
+        return;
+    }
+    processing = true;
+    processor = pthread_self();
+
+    for (;;) {
+        if (eventHead != eventTail) {
+            const Event &event = events[eventHead % MAX_EVENTS];
+            pthread_mutex_unlock(&mutex);
+            dispatch(ble, event);
+            pthread_mutex_lock(&mutex);
+            eventHead++;
+            pthread_cond_broadcast(&cond);
+        } else if (dataSent && !linkStalled) {
+            // the queued notifications went out, release their buffers
+            unsigned count = dataSent;
+            dataSent = 0;
+            for (unsigned i = 0; i < MAX_CONNECTIONS; i++) connections[i].txInFlight = 0;
+            pthread_mutex_unlock(&mutex);
+            ble.gattServer().dataSentCallChain.call(count);
+            pthread_mutex_lock(&mutex);
+        } else {
+            break;
+        }
+    }
+
+    processing = false;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+}
+
+void BLESim::dispatch(BLE &ble, const Event &event) {
+    switch (event.type) {
+        case EVENT_CONNECTION: {
+            Gap::ConnectionCallbackParams_t params;
+            memset(&params, 0, sizeof(params));
+            params.handle = event.connection;
+            params.role = Gap::PERIPHERAL;
+            params.peerAddrType = BLEProtocol::AddressType::RANDOM_STATIC;
+            params.peerAddr[0] = static_cast<uint8_t>(event.connection);
+            params.ownAddrType = BLEProtocol::AddressType::RANDOM_STATIC;
+            params.connectionParams = &event.params;
+            ble.gap().connectionCallChain.call(&params);
+            break;
+        }
+        case EVENT_TIMEOUT:
+            ble.gap().timeoutCallbackChain.call(static_cast<Gap::TimeoutSource_t>(event.reason));
+            break;
+        case EVENT_DISCONNECTION: {
+            Gap::DisconnectionCallbackParams_t params;
+            params.handle = event.connection;
+            params.reason = static_cast<Gap::DisconnectionReason_t>(event.reason);
+            ble.gap().disconnectionCallChain.call(&params);
+            break;
+        }
+        case EVENT_DATA_WRITTEN: {
+            GattServer &server = ble.gattServer();
+            GattServer::Attribute *attribute = server.findAttribute(event.handle);
+            if (!attribute) break;
+
+            GattWriteAuthCallbackParams auth;
+            auth.connHandle = event.connection;
+            auth.handle = event.handle;
+            auth.offset = 0;
+            auth.len = event.len;
+            auth.data = event.data;
+            auth.authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+            if (attribute->characteristic->authorizeWrite(&auth) != AUTH_CALLBACK_REPLY_SUCCESS) {
+                // the central gets an error response and the value stays unchanged
+                pthread_mutex_lock(&mutex);
+                Connection *c = find(event.connection);
+                if (c) c->stats.rejected++;
+                pthread_mutex_unlock(&mutex);
+                break;
+            }
+
+            if (event.len) memcpy(&attribute->value[0], event.data, event.len);
+            attribute->length = event.len;
+
+            GattWriteCallbackParams params;
+            params.connHandle = event.connection;
+            params.handle = event.handle;
+            params.writeOp = GattWriteCallbackParams::OP_WRITE_CMD;
+            params.offset = 0;
+            params.len = event.len;
+            params.data = event.data;
+            server.dataWrittenCallChain.call(&params);
+            break;
+        }
+        case EVENT_UPDATES_ENABLED:
+            ble.gattServer().updatesEnabledCallback.call(event.handle);
+            break;
+        case EVENT_UPDATES_DISABLED:
+            ble.gattServer().updatesDisabledCallback.call(event.handle);
+            break;
+        case EVENT_PHY_UPDATE:
+            if (ble.gap()._eventHandler)
+                ble.gap()._eventHandler->onPhyUpdateComplete(event.status, event.connection, event.phy, event.phy);
+            break;
+        case EVENT_DATA_LENGTH_CHANGE:
+            if (ble.gap()._eventHandler)
+                ble.gap()._eventHandler->onDataLengthChange(event.connection, event.len, event.len);
+            break;
+        case EVENT_ATT_MTU_CHANGE:
+            if (ble.gattServer().eventHandler)
+                ble.gattServer().eventHandler->onAttMtuChange(event.connection, event.mtu);
+            break;
+    }
+}
+
+ble_error_t bleUpdateDataLength(Gap::Handle_t connection, uint16_t txOctets) {
+    return BLESim::getInstance().updateDataLength(connection, txOctets);
+}
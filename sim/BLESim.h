@@ -0,0 +1,393 @@
+/*!
+ * @file
+ * @brief Simulated BLE controller and central for host builds.
+ *
+ * BLESim plays the role of the softdevice and of the remote central(s):
+ * tests and benchmarks use it to connect, discover, subscribe, write to
+ * characteristics and collect the notifications the library sends.
+ * Every peer action is turned into a stack event which is delivered on
+ * the thread calling BLE::processEvents(), like on the target.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_BLESIM_H
+#define UBIRCH_MBED_BLE_SIM_BLESIM_H
+
+#include <pthread.h>
+#include "BLE.h"
+#include "Callback.h"
+
+class BLESim {
+public:
+    static const unsigned MAX_CONNECTIONS = 8;
+    static const unsigned MAX_EVENTS = 64;
+    static const unsigned MAX_ATTRIBUTE_LEN = 512;
+    static const unsigned MAX_SUBSCRIPTIONS = 16;
+    static const unsigned PEER_BUFFER_SIZE = 16384;
+    static const Gap::Handle_t INVALID_CONNECTION = 0xFFFF;
+    /** The link layer payload of a data packet without the Data Length Extension. */
+    static const uint16_t DEFAULT_DATA_LENGTH = 27;
+    /** The largest link layer payload of a data packet with the Data Length Extension. */
+    static const uint16_t MAX_DATA_LENGTH = 251;
+    static const uint16_t DEFAULT_ATT_MTU = 23;
+    static const uint16_t MAX_ATT_MTU = 247;
+    static const unsigned DEFAULT_TX_BUFFERS = 6;
+    static const uint32_t NOT_FOUND = 0xFFFFFFFF;
+
+    /**
+     * What the simulated central observed on one connection.
+     */
+    struct PeerStats {
+        uint32_t notifications;
+        uint32_t bytes;
+        uint32_t truncated;
+        uint32_t overflow;
+        uint32_t noMemory;
+        // notifications refused with BLE_STACK_BUSY
+        uint32_t busy;
+        // writes the server rejected with an ATT error
+        uint32_t rejected;
+        uint16_t maxPayload;
+        uint16_t maxInFlight;
+        // link layer packets the notifications were fragmented into
+        uint32_t packets;
+        // time on air of the notifications in us, including the central's acknowledgements
+        uint32_t airTimeUs;
+    };
+
+    /**
+     * A notification as received by the simulated central.
+     */
+    struct Notification {
+        Gap::Handle_t connection;
+        GattAttribute::Handle_t handle;
+        const uint8_t *data;
+        uint16_t len;
+    };
+
+    static BLESim &getInstance();
+
+    /**
+     * Check whether the device advertises with the given local name.
+     */
+    bool discover(const char *deviceName);
+
+    /**
+     * Simulate a scanner looking for the device, in simulated time. The
+     * scanner starts at a random point of the advertising and of its own
+     * interval and listens for scanWindow milliseconds every scanInterval.
+     * The device advertises every interval plus a random advDelay of 0-10ms.
+     * Time does not pass for the device, use elapse() for that.
+     * @param deviceName the local name to look for
+     * @param scanInterval the scan interval in ms
+     * @param scanWindow the scan window in ms, the scanner listens continuously if equal to the interval
+     * @return the time until the first advertising packet was received in ms, NOT_FOUND
+     *         if the device does not advertise the name or stops advertising before
+     */
+    uint32_t scan(const char *deviceName, uint16_t scanInterval = 100, uint16_t scanWindow = 100);
+
+    /**
+     * Let simulated time pass for the advertiser. An advertising timeout
+     * expires like on the target: advertising stops and the timeout callback
+     * is called when the stack events are processed.
+     * @param ms the time that passes in milliseconds
+     */
+    void elapse(uint32_t ms);
+
+    /**
+     * Connect a central, the device must be advertising connectable.
+     * @param params connection parameters, NULL for the defaults (30ms interval)
+     * @return the connection handle or INVALID_CONNECTION
+     */
+    Gap::Handle_t connect(const Gap::ConnectionParams_t *params = NULL);
+
+    /**
+     * Disconnect a central.
+     */
+    ble_error_t disconnect(Gap::Handle_t connection,
+                           Gap::DisconnectionReason_t reason = Gap::REMOTE_USER_TERMINATED_CONNECTION);
+
+    bool isConnected(Gap::Handle_t connection);
+
+    /**
+     * Run an ATT MTU exchange, the result is the smaller of the client
+     * MTU and MAX_ATT_MTU (what the softdevice is configured for).
+     * @return the negotiated ATT MTU or 0 if not connected
+     */
+    uint16_t exchangeMtu(Gap::Handle_t connection, uint16_t clientMtu);
+
+    uint16_t getMtu(Gap::Handle_t connection);
+
+    /**
+     * Get the parameters currently used by a connection.
+     * @return the parameters, all 0 if not connected
+     */
+    Gap::ConnectionParams_t getConnectionParams(Gap::Handle_t connection);
+
+    /**
+     * Set the shortest connection interval the central supports (1.25ms
+     * units). Parameter update requests are applied with the shortest
+     * supported interval in the requested range and ignored if there is
+     * none, as a central does. The default is 6 (7.5ms).
+     */
+    void setCentralMinInterval(uint16_t interval);
+
+    /**
+     * Set what the central supports of the link layer features. Data length
+     * updates are answered with the smaller of the requested length and
+     * maxDataLength, 27 means the central does not support the Data Length
+     * Extension. PHY updates to LE 2M fail if le2M is false, like a central
+     * that does not know the PHY update procedure. The default is 251 and true.
+     */
+    void setCentralLinkFeatures(uint16_t maxDataLength, bool le2M);
+
+    /**
+     * Get the maximum link layer payload the device sends on a connection.
+     * @return the payload in octets, 0 if not connected
+     */
+    uint16_t getDataLength(Gap::Handle_t connection);
+
+    /**
+     * Get the PHY the device sends with on a connection.
+     * @return the PHY, NONE if not connected
+     */
+    ble::phy_t getPhy(Gap::Handle_t connection);
+
+    /**
+     * Set the number of notification buffers per connection. Writes fail
+     * with BLE_ERROR_NO_MEM while all buffers wait for the TX complete
+     * event, which is raised when the stack events are processed.
+     */
+    void setTxBuffers(unsigned buffers);
+
+    /**
+     * Stall the link, e.g. a central out of range: queued notifications stay
+     * in the buffers without TX complete until the link runs again, so
+     * writes fail with BLE_ERROR_NO_MEM once all buffers are taken.
+     */
+    void setLinkStalled(bool stalled);
+
+    /**
+     * Let the next notifications fail with BLE_STACK_BUSY, without any
+     * event telling when the stack accepts writes again.
+     * @param writes the number of writes to refuse
+     */
+    void setBusy(unsigned writes);
+
+    /**
+     * Hold back the completion of BLE::init(), like a stack that does not
+     * come up in time. completeInit() delivers it late.
+     */
+    void setInitDeferred(bool deferred);
+
+    /**
+     * Deliver a held back init completion, even if the stack has been shut
+     * down since, like a late callback of a slow stack.
+     * @return false if no completion was held back
+     */
+    bool completeInit();
+
+    /**
+     * Find the value handle of a characteristic (GATT discovery).
+     * @param uuid the characteristic UUID
+     * @param index which one to return if several services use the same UUID
+     * @return the value handle or GattAttribute::INVALID_HANDLE
+     */
+    GattAttribute::Handle_t findCharacteristic(const UUID &uuid, unsigned index = 0);
+
+    bool hasService(const UUID &uuid);
+
+    /**
+     * Enable or disable notifications for a characteristic (CCCD write).
+     */
+    ble_error_t subscribe(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, bool enable = true);
+
+    /**
+     * Write to a characteristic from the central (write command).
+     */
+    ble_error_t write(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, const uint8_t *data,
+                      uint16_t len);
+
+    /**
+     * Read a characteristic from the central, in (ATT MTU - 1) byte requests
+     * like a long read. The read authorization runs on the calling thread.
+     * @param length the buffer size, set to the number of bytes read
+     */
+    ble_error_t read(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, uint8_t *buffer,
+                     uint16_t *length);
+
+    /**
+     * Take notification payload bytes received by the central.
+     * @return the number of bytes copied into the buffer
+     */
+    uint16_t receive(Gap::Handle_t connection, uint8_t *buffer, uint16_t size);
+
+    /**
+     * @return number of received bytes not yet taken with receive()
+     */
+    uint16_t available(Gap::Handle_t connection);
+
+    PeerStats stats(Gap::Handle_t connection);
+
+    /**
+     * Estimate the notification throughput of a connection from the
+     * notifications sent so far. Every connection event carries as many
+     * notifications as the TX buffers hold and their time on air allows
+     * within the current connection interval.
+     * @return the payload throughput in bytes per second, 0 if nothing was sent
+     */
+    uint32_t linkThroughput(Gap::Handle_t connection);
+
+    /**
+     * Observe every notification the central receives, in order. The
+     * listener is called with the simulation locked and must not call it.
+     * @param listener the listener, NULL to remove it
+     */
+    void onNotification(mbed::Callback<void(const Notification *)> listener);
+
+    /**
+     * Block until all pending stack events have been processed.
+     * @return false if the events were not processed within the timeout
+     */
+    bool flush(uint32_t timeoutMs = 1000);
+
+    /**
+     * Drop all connections, events and peer data without raising events.
+     */
+    void reset();
+
+protected:
+    friend class BLE;
+    friend class Gap;
+    friend class GattServer;
+    friend ble_error_t bleUpdateDataLength(Gap::Handle_t connection, uint16_t txOctets);
+
+    enum EventType {
+        EVENT_CONNECTION,
+        EVENT_DISCONNECTION,
+        EVENT_DATA_WRITTEN,
+        EVENT_UPDATES_ENABLED,
+        EVENT_UPDATES_DISABLED,
+        EVENT_ATT_MTU_CHANGE,
+        EVENT_TIMEOUT,
+        EVENT_PHY_UPDATE,
+        EVENT_DATA_LENGTH_CHANGE
+    };
+
+    struct Event {
+        EventType type;
+        Gap::Handle_t connection;
+        GattAttribute::Handle_t handle;
+        uint16_t reason;
+        uint16_t mtu;
+        uint16_t len;
+        ble_error_t status;
+        ble::phy_t::type phy;
+        Gap::ConnectionParams_t params;
+        uint8_t data[MAX_ATTRIBUTE_LEN];
+    };
+
+    struct Connection {
+        bool active;
+        Gap::ConnectionParams_t params;
+        uint16_t mtu;
+        uint16_t dataLength;
+        ble::phy_t::type phy;
+        uint16_t txInFlight;
+        GattAttribute::Handle_t subscriptions[MAX_SUBSCRIPTIONS];
+        PeerStats stats;
+        uint8_t rx[PEER_BUFFER_SIZE];
+        uint16_t rxHead;
+        uint16_t rxTail;
+    };
+
+    BLESim();
+
+    // controller side, called by the host stand-ins
+    bool advertising();
+
+    bool startAdvertising();
+
+    /** Hold back an init completion if setInitDeferred() is set. */
+    bool deferInit(const BLE::InitializationCompleteCallback_t &callback);
+
+    void stopAdvertising();
+
+    bool connected();
+
+    bool isSubscribed(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle);
+
+    ble_error_t notify(Gap::Handle_t connection, GattAttribute::Handle_t valueHandle, const uint8_t *data,
+                       uint16_t len);
+
+    ble_error_t hostDisconnect(Gap::Handle_t connection, Gap::DisconnectionReason_t reason);
+
+    ble_error_t updateConnectionParams(Gap::Handle_t connection, const Gap::ConnectionParams_t *params);
+
+    ble_error_t setPhy(Gap::Handle_t connection, uint8_t txPhys, uint8_t rxPhys);
+
+    ble_error_t updateDataLength(Gap::Handle_t connection, uint16_t txOctets);
+
+    void process(BLE &ble);
+
+    void dispatch(BLE &ble, const Event &event);
+
+    void post(const Event &event);
+
+    Connection *find(Gap::Handle_t connection);
+
+    // called with the mutex held
+    uint32_t nextRandom();
+
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+
+    bool isAdvertising;
+    // simulated time since advertising started in ms
+    uint32_t advertisingTime;
+    uint32_t randomState;
+    uint16_t centralMinInterval;
+    uint16_t centralDataLength;
+    bool centralLe2M;
+    unsigned txBuffers;
+    bool linkStalled;
+    unsigned busyWrites;
+    bool initDeferred;
+    bool initPending;
+    BLE::InitializationCompleteCallback_t pendingInit;
+    Connection connections[MAX_CONNECTIONS];
+    mbed::Callback<void(const Notification *)> notificationListener;
+
+    Event events[MAX_EVENTS];
+    unsigned eventHead;
+    unsigned eventTail;
+    unsigned dataSent;
+    bool processing;
+    pthread_t processor;
+};
+
+/**
+ * The simulator's port of the library's data length hook, it stands in for
+ * the vendor call and answers like the simulated central.
+ */
+ble_error_t bleUpdateDataLength(Gap::Handle_t connection, uint16_t txOctets);
+
+#endif //UBIRCH_MBED_BLE_SIM_BLESIM_H
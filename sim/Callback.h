@@ -0,0 +1,291 @@
+/*!
+ * @file
+ * @brief Host stand-in for mbed::Callback.
+ *
+ * Only the parts of the mbed OS 5 callback API the library and its tests
+ * use are provided: free functions and (const) member functions with up to
+ * two arguments. The storage layout follows the mbed implementation so the
+ * size and copy semantics match the target.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_CALLBACK_H
+#define UBIRCH_MBED_BLE_SIM_CALLBACK_H
+
+#include <cstddef>
+#include <cstring>
+
+namespace mbed {
+
+namespace detail {
+struct _class;
+
+// raw storage for either a function pointer or a member function pointer
+union CallbackStorage {
+    void (*_staticfunc)();
+    void (_class::*_methodfunc)();
+};
+}
+
+template<typename F>
+class Callback;
+
+template<typename R>
+class Callback<R()> {
+public:
+    Callback(R (*func)() = 0) : _obj(0), _thunk(0) {
+        memset(&_func, 0, sizeof(_func));
+        if (func) {
+            memcpy(&_func, &func, sizeof(func));
+            _thunk = &function_thunk;
+        }
+    }
+
+    template<typename T, typename U>
+    Callback(U *obj, R (T::*method)()) : _thunk(&method_thunk<T, R (T::*)()>) {
+        memset(&_func, 0, sizeof(_func));
+        memcpy(&_func, &method, sizeof(method));
+        _obj = static_cast<void *>(static_cast<T *>(obj));
+    }
+
+    template<typename T, typename U>
+    Callback(const U *obj, R (T::*method)() const) : _thunk(&const_method_thunk<T, R (T::*)() const>) {
+        memset(&_func, 0, sizeof(_func));
+        memcpy(&_func, &method, sizeof(method));
+        _obj = const_cast<void *>(static_cast<const void *>(static_cast<const T *>(obj)));
+    }
+
+    R call() const {
+        return _thunk(_obj, &_func);
+    }
+
+    R operator()() const {
+        return call();
+    }
+
+    operator bool() const {
+        return _thunk != 0;
+    }
+
+    bool operator==(const Callback &other) const {
+        return _thunk == other._thunk && _obj == other._obj && !memcmp(&_func, &other._func, sizeof(_func));
+    }
+
+    bool operator!=(const Callback &other) const {
+        return !(*this == other);
+    }
+
+    static R thunk(void *func) {
+        return static_cast<Callback *>(func)->call();
+    }
+
+private:
+    static R function_thunk(void *, const void *func) {
+        R (*f)();
+        memcpy(&f, func, sizeof(f));
+        return f();
+    }
+
+    template<typename T, typename M>
+    static R method_thunk(void *obj, const void *func) {
+        M m;
+        memcpy(&m, func, sizeof(m));
+        return (static_cast<T *>(obj)->*m)();
+    }
+
+    template<typename T, typename M>
+    static R const_method_thunk(void *obj, const void *func) {
+        M m;
+        memcpy(&m, func, sizeof(m));
+        return (static_cast<const T *>(obj)->*m)();
+    }
+
+    detail::CallbackStorage _func;
+    void *_obj;
+    R (*_thunk)(void *, const void *);
+};
+
+template<typename R, typename A0>
+class Callback<R(A0)> {
+public:
+    Callback(R (*func)(A0) = 0) : _obj(0), _thunk(0) {
+        memset(&_func, 0, sizeof(_func));
+        if (func) {
+            memcpy(&_func, &func, sizeof(func));
+            _thunk = &function_thunk;
+        }
+    }
+
+    template<typename T, typename U>
+    Callback(U *obj, R (T::*method)(A0)) : _thunk(&method_thunk<T, R (T::*)(A0)>) {
+        memset(&_func, 0, sizeof(_func));
+        memcpy(&_func, &method, sizeof(method));
+        _obj = static_cast<void *>(static_cast<T *>(obj));
+    }
+
+    template<typename T, typename U>
+    Callback(const U *obj, R (T::*method)(A0) const) : _thunk(&const_method_thunk<T, R (T::*)(A0) const>) {
+        memset(&_func, 0, sizeof(_func));
+        memcpy(&_func, &method, sizeof(method));
+        _obj = const_cast<void *>(static_cast<const void *>(static_cast<const T *>(obj)));
+    }
+
+    R call(A0 a0) const {
+        return _thunk(_obj, &_func, a0);
+    }
+
+    R operator()(A0 a0) const {
+        return call(a0);
+    }
+
+    operator bool() const {
+        return _thunk != 0;
+    }
+
+    bool operator==(const Callback &other) const {
+        return _thunk == other._thunk && _obj == other._obj && !memcmp(&_func, &other._func, sizeof(_func));
+    }
+
+    bool operator!=(const Callback &other) const {
+        return !(*this == other);
+    }
+
+private:
+    static R function_thunk(void *, const void *func, A0 a0) {
+        R (*f)(A0);
+        memcpy(&f, func, sizeof(f));
+        return f(a0);
+    }
+
+    template<typename T, typename M>
+    static R method_thunk(void *obj, const void *func, A0 a0) {
+        M m;
+        memcpy(&m, func, sizeof(m));
+        return (static_cast<T *>(obj)->*m)(a0);
+    }
+
+    template<typename T, typename M>
+    static R const_method_thunk(void *obj, const void *func, A0 a0) {
+        M m;
+        memcpy(&m, func, sizeof(m));
+        return (static_cast<const T *>(obj)->*m)(a0);
+    }
+
+    detail::CallbackStorage _func;
+    void *_obj;
+    R (*_thunk)(void *, const void *, A0);
+};
+
+template<typename R, typename A0, typename A1>
+class Callback<R(A0, A1)> {
+public:
+    Callback(R (*func)(A0, A1) = 0) : _obj(0), _thunk(0) {
+        memset(&_func, 0, sizeof(_func));
+        if (func) {
+            memcpy(&_func, &func, sizeof(func));
+            _thunk = &function_thunk;
+        }
+    }
+
+    template<typename T, typename U>
+    Callback(U *obj, R (T::*method)(A0, A1)) : _thunk(&method_thunk<T, R (T::*)(A0, A1)>) {
+        memset(&_func, 0, sizeof(_func));
+        memcpy(&_func, &method, sizeof(method));
+        _obj = static_cast<void *>(static_cast<T *>(obj));
+    }
+
+    R call(A0 a0, A1 a1) const {
+        return _thunk(_obj, &_func, a0, a1);
+    }
+
+    R operator()(A0 a0, A1 a1) const {
+        return call(a0, a1);
+    }
+
+    operator bool() const {
+        return _thunk != 0;
+    }
+
+    bool operator==(const Callback &other) const {
+        return _thunk == other._thunk && _obj == other._obj && !memcmp(&_func, &other._func, sizeof(_func));
+    }
+
+    bool operator!=(const Callback &other) const {
+        return !(*this == other);
+    }
+
+private:
+    static R function_thunk(void *, const void *func, A0 a0, A1 a1) {
+        R (*f)(A0, A1);
+        memcpy(&f, func, sizeof(f));
+        return f(a0, a1);
+    }
+
+    template<typename T, typename M>
+    static R method_thunk(void *obj, const void *func, A0 a0, A1 a1) {
+        M m;
+        memcpy(&m, func, sizeof(m));
+        return (static_cast<T *>(obj)->*m)(a0, a1);
+    }
+
+    detail::CallbackStorage _func;
+    void *_obj;
+    R (*_thunk)(void *, const void *, A0, A1);
+};
+
+template<typename R>
+Callback<R()> callback(R (*func)() = 0) {
+    return Callback<R()>(func);
+}
+
+template<typename T, typename U, typename R>
+Callback<R()> callback(U *obj, R (T::*method)()) {
+    return Callback<R()>(obj, method);
+}
+
+template<typename T, typename U, typename R>
+Callback<R()> callback(const U *obj, R (T::*method)() const) {
+    return Callback<R()>(obj, method);
+}
+
+template<typename R, typename A0>
+Callback<R(A0)> callback(R (*func)(A0)) {
+    return Callback<R(A0)>(func);
+}
+
+template<typename T, typename U, typename R, typename A0>
+Callback<R(A0)> callback(U *obj, R (T::*method)(A0)) {
+    return Callback<R(A0)>(obj, method);
+}
+
+template<typename R, typename A0, typename A1>
+Callback<R(A0, A1)> callback(R (*func)(A0, A1)) {
+    return Callback<R(A0, A1)>(func);
+}
+
+template<typename T, typename U, typename R, typename A0, typename A1>
+Callback<R(A0, A1)> callback(U *obj, R (T::*method)(A0, A1)) {
+    return Callback<R(A0, A1)>(obj, method);
+}
+
+} // namespace mbed
+
+#endif //UBIRCH_MBED_BLE_SIM_CALLBACK_H
@@ -0,0 +1,122 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed OS 5 FileHandle.
+ *
+ * The interface retargeted stdio streams are implemented with, with the
+ * same default implementations. The host uses the POSIX error and poll
+ * constants, which have the same values as the mbed ones.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_FILEHANDLE_H
+#define UBIRCH_MBED_BLE_SIM_FILEHANDLE_H
+
+#include <cerrno>
+#include <cstdio>
+#include <poll.h>
+#include <sys/types.h>
+#include "Callback.h"
+
+namespace mbed {
+
+class FileHandle {
+public:
+    virtual ~FileHandle() {}
+
+    /**
+     * Read up to size bytes.
+     * @return the number of bytes read, 0 at end of file, a negative error code on failure
+     */
+    virtual ssize_t read(void *buffer, size_t size) = 0;
+
+    /**
+     * Write up to size bytes.
+     * @return the number of bytes written, a negative error code on failure
+     */
+    virtual ssize_t write(const void *buffer, size_t size) = 0;
+
+    virtual off_t seek(off_t offset, int whence = SEEK_SET) = 0;
+
+    virtual int close() = 0;
+
+    /**
+     * Flush buffered data.
+     * @return 0 on success, a negative error code on failure
+     */
+    virtual int sync() {
+        return 0;
+    }
+
+    virtual int isatty() {
+        return false;
+    }
+
+    virtual off_t tell() {
+        return seek(0, SEEK_CUR);
+    }
+
+    virtual void rewind() {
+        seek(0, SEEK_SET);
+    }
+
+    virtual off_t size() {
+        off_t off = seek(0, SEEK_CUR);
+        if (off < 0) return off;
+        off_t size = seek(0, SEEK_END);
+        seek(off, SEEK_SET);
+        return size;
+    }
+
+    /**
+     * Choose whether read() and write() block.
+     * @return 0 on success, -ENOTTY if not supported
+     */
+    virtual int set_blocking(bool blocking) {
+        return blocking ? 0 : -ENOTTY;
+    }
+
+    virtual bool is_blocking() const {
+        return true;
+    }
+
+    /**
+     * @param events the events of interest, e.g. POLLIN | POLLOUT
+     * @return the events that occurred
+     */
+    virtual short poll(short events) const {
+        return POLLIN | POLLOUT;
+    }
+
+    bool writable() const {
+        return poll(POLLOUT) & POLLOUT;
+    }
+
+    bool readable() const {
+        return poll(POLLIN) & POLLIN;
+    }
+
+    virtual void sigio(Callback<void()> func) {
+    }
+};
+
+} // namespace mbed
+
+#endif //UBIRCH_MBED_BLE_SIM_FILEHANDLE_H
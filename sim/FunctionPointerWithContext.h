@@ -0,0 +1,112 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API function pointers and call chains.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_FUNCTIONPOINTERWITHCONTEXT_H
+#define UBIRCH_MBED_BLE_SIM_FUNCTIONPOINTERWITHCONTEXT_H
+
+#include "Callback.h"
+
+template<typename ContextType>
+class FunctionPointerWithContext {
+public:
+    typedef void (*pvoidfcontext_t)(ContextType context);
+
+    FunctionPointerWithContext(void (*function)(ContextType context) = NULL) : _callback(function) {}
+
+    template<typename T>
+    FunctionPointerWithContext(T *object, void (T::*member)(ContextType context)) : _callback(object, member) {}
+
+    void call(ContextType context) const {
+        if (_callback) _callback(context);
+    }
+
+    void operator()(ContextType context) const {
+        call(context);
+    }
+
+    operator bool() const {
+        return _callback;
+    }
+
+    bool operator==(const FunctionPointerWithContext &other) const {
+        return _callback == other._callback;
+    }
+
+private:
+    mbed::Callback<void(ContextType)> _callback;
+};
+
+/**
+ * A fixed size chain of callbacks. The target stacks use a linked list,
+ * the simulation keeps a small array so dispatching never allocates.
+ */
+template<typename ContextType>
+class CallChainOfFunctionPointersWithContext {
+public:
+    static const unsigned MAX_CALLBACKS = 16;
+
+    CallChainOfFunctionPointersWithContext() : _count(0) {}
+
+    void add(const FunctionPointerWithContext<ContextType> &function) {
+        if (_count < MAX_CALLBACKS) _chain[_count++] = function;
+    }
+
+    template<typename T>
+    void add(T *object, void (T::*member)(ContextType context)) {
+        add(FunctionPointerWithContext<ContextType>(object, member));
+    }
+
+    bool detach(const FunctionPointerWithContext<ContextType> &function) {
+        for (unsigned i = 0; i < _count; i++) {
+            if (_chain[i] == function) {
+                for (unsigned j = i + 1; j < _count; j++) _chain[j - 1] = _chain[j];
+                _count--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void clear() {
+        _count = 0;
+    }
+
+    bool hasCallbacksAttached() const {
+        return _count > 0;
+    }
+
+    void call(ContextType context) const {
+        for (unsigned i = 0; i < _count; i++) _chain[i].call(context);
+    }
+
+    void operator()(ContextType context) const {
+        call(context);
+    }
+
+private:
+    FunctionPointerWithContext<ContextType> _chain[MAX_CALLBACKS];
+    unsigned _count;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_FUNCTIONPOINTERWITHCONTEXT_H
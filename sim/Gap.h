@@ -0,0 +1,300 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API Gap.
+ *
+ * The link layer state (connections, advertising) is owned by the
+ * simulated controller in BLESim, Gap only keeps the host side
+ * configuration and the registered callbacks.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GAP_H
+#define UBIRCH_MBED_BLE_SIM_GAP_H
+
+#include "blecommon.h"
+#include "FunctionPointerWithContext.h"
+#include "GapAdvertisingData.h"
+#include "GapAdvertisingParams.h"
+
+namespace BLEProtocol {
+struct AddressType {
+    enum Type {
+        PUBLIC = 0,
+        RANDOM_STATIC,
+        RANDOM_PRIVATE_RESOLVABLE,
+        RANDOM_PRIVATE_NON_RESOLVABLE
+    };
+};
+typedef AddressType::Type AddressType_t;
+
+static const unsigned ADDR_LEN = 6;
+typedef uint8_t AddressBytes_t[ADDR_LEN];
+}
+
+class BLESim;
+
+class Gap {
+public:
+    typedef ble::connection_handle_t Handle_t;
+    typedef ble::phy_t Phy_t;
+    typedef ble::phy_set_t PhySet_t;
+    typedef ble::coded_symbol_per_bit_t::type CodedSymbolPerBit_t;
+
+    static const unsigned DEVICE_NAME_MAX_LENGTH = 32;
+
+    enum Role_t {
+        PERIPHERAL = 0x1,
+        CENTRAL = 0x2
+    };
+
+    enum DisconnectionReason_t {
+        CONNECTION_TIMEOUT = 0x08,
+        REMOTE_USER_TERMINATED_CONNECTION = 0x13,
+        REMOTE_DEV_TERMINATION_DUE_TO_LOW_RESOURCES = 0x14,
+        REMOTE_DEV_TERMINATION_DUE_TO_POWER_OFF = 0x15,
+        LOCAL_HOST_TERMINATED_CONNECTION = 0x16,
+        CONN_INTERVAL_UNACCEPTABLE = 0x3B
+    };
+
+    enum TimeoutSource_t {
+        TIMEOUT_SRC_ADVERTISING = 0x00,
+        TIMEOUT_SRC_SECURITY_REQUEST = 0x01,
+        TIMEOUT_SRC_SCAN = 0x02,
+        TIMEOUT_SRC_CONN = 0x03
+    };
+
+    struct GapState_t {
+        unsigned advertising : 1;
+        unsigned connected : 1;
+    };
+
+    /**
+     * Connection parameters, intervals in 1.25ms units, timeout in 10ms units.
+     */
+    struct ConnectionParams_t {
+        uint16_t minConnectionInterval;
+        uint16_t maxConnectionInterval;
+        uint16_t slaveLatency;
+        uint16_t connectionSupervisionTimeout;
+    };
+
+    struct ConnectionCallbackParams_t {
+        Handle_t handle;
+        Role_t role;
+        BLEProtocol::AddressType_t peerAddrType;
+        BLEProtocol::AddressBytes_t peerAddr;
+        BLEProtocol::AddressType_t ownAddrType;
+        BLEProtocol::AddressBytes_t ownAddr;
+        const ConnectionParams_t *connectionParams;
+    };
+
+    struct DisconnectionCallbackParams_t {
+        Handle_t handle;
+        DisconnectionReason_t reason;
+    };
+
+    /**
+     * Definition of the general handler of Gap related events.
+     */
+    struct EventHandler {
+        /**
+         * Called when a PHY update procedure of a connection has finished.
+         * @param status BLE_ERROR_NONE if the PHYs were negotiated, else the
+         *        connection keeps its PHYs (e.g. the peer does not support the update)
+         * @param connectionHandle the connection
+         * @param txPhy the PHY used to send
+         * @param rxPhy the PHY used to receive
+         */
+        virtual void onPhyUpdateComplete(ble_error_t status, Handle_t connectionHandle, Phy_t txPhy, Phy_t rxPhy) {
+            (void) status;
+            (void) connectionHandle;
+            (void) txPhy;
+            (void) rxPhy;
+        }
+
+        /**
+         * Called when the maximum link layer payload of a connection changed.
+         * @param connectionHandle the connection
+         * @param txSize the maximum payload sent in octets
+         * @param rxSize the maximum payload received in octets
+         */
+        virtual void onDataLengthChange(Handle_t connectionHandle, uint16_t txSize, uint16_t rxSize) {
+            (void) connectionHandle;
+            (void) txSize;
+            (void) rxSize;
+        }
+
+    protected:
+        ~EventHandler() {}
+    };
+
+    typedef FunctionPointerWithContext<TimeoutSource_t> TimeoutEventCallback_t;
+    typedef CallChainOfFunctionPointersWithContext<TimeoutSource_t> TimeoutEventCallbackChain_t;
+    typedef FunctionPointerWithContext<const ConnectionCallbackParams_t *> ConnectionEventCallback_t;
+    typedef CallChainOfFunctionPointersWithContext<const ConnectionCallbackParams_t *> ConnectionEventCallbackChain_t;
+    typedef FunctionPointerWithContext<const DisconnectionCallbackParams_t *> DisconnectionEventCallback_t;
+    typedef CallChainOfFunctionPointersWithContext<const DisconnectionCallbackParams_t *>
+            DisconnectionEventCallbackChain_t;
+
+    static uint16_t MSEC_TO_GAP_DURATION_UNITS(uint32_t durationInMillis) {
+        return static_cast<uint16_t>((durationInMillis * 1000) / 1250);
+    }
+
+    Gap();
+
+    ble_error_t setDeviceName(const uint8_t *deviceName);
+
+    ble_error_t getDeviceName(uint8_t *deviceName, unsigned *lengthP);
+
+    void setAdvertisingType(GapAdvertisingParams::AdvertisingType_t advType);
+
+    /**
+     * Set the advertising interval in milliseconds. 0 stops advertising, values
+     * below the minimum are raised to the minimum.
+     */
+    void setAdvertisingInterval(uint16_t interval);
+
+    uint16_t getMinAdvertisingInterval() const;
+
+    uint16_t getMinNonConnectableAdvertisingInterval() const;
+
+    uint16_t getMaxAdvertisingInterval() const;
+
+    void setAdvertisingTimeout(uint16_t timeout);
+
+    void setAdvertisingParams(const GapAdvertisingParams &newParams);
+
+    GapAdvertisingParams &getAdvertisingParams();
+
+    const GapAdvertisingParams &getAdvertisingParams() const;
+
+    ble_error_t startAdvertising();
+
+    ble_error_t stopAdvertising();
+
+    ble_error_t accumulateAdvertisingPayload(uint8_t flags);
+
+    ble_error_t accumulateAdvertisingPayload(GapAdvertisingData::Appearance app);
+
+    ble_error_t accumulateAdvertisingPayloadTxPower(int8_t power);
+
+    ble_error_t accumulateAdvertisingPayload(GapAdvertisingData::DataType type, const uint8_t *data, uint8_t len);
+
+    ble_error_t updateAdvertisingPayload(GapAdvertisingData::DataType type, const uint8_t *data, uint8_t len);
+
+    ble_error_t setAdvertisingPayload(const GapAdvertisingData &payload);
+
+    const GapAdvertisingData &getAdvertisingPayload() const;
+
+    void clearAdvertisingPayload();
+
+    ble_error_t accumulateScanResponse(GapAdvertisingData::DataType type, const uint8_t *data, uint8_t len);
+
+    void clearScanResponse();
+
+    const GapAdvertisingData &getScanResponsePayload() const;
+
+    GapState_t getState() const;
+
+    ble_error_t disconnect(Handle_t connectionHandle, DisconnectionReason_t reason);
+
+    ble_error_t getPreferredConnectionParams(ConnectionParams_t *params);
+
+    ble_error_t setPreferredConnectionParams(const ConnectionParams_t *params);
+
+    ble_error_t updateConnectionParams(Handle_t handle, const ConnectionParams_t *params);
+
+    /**
+     * Assign the event handler, only one handler can be set at a time.
+     */
+    void setEventHandler(EventHandler *handler) {
+        _eventHandler = handler;
+    }
+
+    /**
+     * Set the PHYs the controller prefers when a peer starts a PHY update.
+     */
+    ble_error_t setPreferredPhys(const PhySet_t *txPhys, const PhySet_t *rxPhys);
+
+    /**
+     * Start a PHY update of a connection, the result is reported to
+     * EventHandler::onPhyUpdateComplete().
+     */
+    ble_error_t setPhy(Handle_t connection, const PhySet_t *txPhys, const PhySet_t *rxPhys,
+                       CodedSymbolPerBit_t codedSymbol);
+
+    void onTimeout(TimeoutEventCallback_t callback) {
+        timeoutCallbackChain.add(callback);
+    }
+
+    TimeoutEventCallbackChain_t &onTimeout() {
+        return timeoutCallbackChain;
+    }
+
+    void onConnection(ConnectionEventCallback_t callback) {
+        connectionCallChain.add(callback);
+    }
+
+    template<typename T>
+    void onConnection(T *tptr, void (T::*mptr)(const ConnectionCallbackParams_t *)) {
+        connectionCallChain.add(tptr, mptr);
+    }
+
+    ConnectionEventCallbackChain_t &onConnection() {
+        return connectionCallChain;
+    }
+
+    void onDisconnection(DisconnectionEventCallback_t callback) {
+        disconnectionCallChain.add(callback);
+    }
+
+    template<typename T>
+    void onDisconnection(T *tptr, void (T::*mptr)(const DisconnectionCallbackParams_t *)) {
+        disconnectionCallChain.add(tptr, mptr);
+    }
+
+    DisconnectionEventCallbackChain_t &onDisconnection() {
+        return disconnectionCallChain;
+    }
+
+    /**
+     * Clear all state and callbacks (called on BLE shutdown).
+     */
+    ble_error_t reset();
+
+private:
+    friend class BLESim;
+
+    uint8_t deviceName[DEVICE_NAME_MAX_LENGTH + 1];
+    GapAdvertisingParams _advParams;
+    GapAdvertisingData _advPayload;
+    GapAdvertisingData _scanResponse;
+    ConnectionParams_t _preferredConnectionParams;
+    PhySet_t _preferredTxPhys;
+    PhySet_t _preferredRxPhys;
+    EventHandler *_eventHandler;
+
+    TimeoutEventCallbackChain_t timeoutCallbackChain;
+    ConnectionEventCallbackChain_t connectionCallChain;
+    DisconnectionEventCallbackChain_t disconnectionCallChain;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GAP_H
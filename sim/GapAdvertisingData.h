@@ -0,0 +1,176 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API advertising payload.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GAPADVERTISINGDATA_H
+#define UBIRCH_MBED_BLE_SIM_GAPADVERTISINGDATA_H
+
+#include <string.h>
+#include "blecommon.h"
+
+#define GAP_ADVERTISING_DATA_MAX_PAYLOAD (31)
+
+class GapAdvertisingData {
+public:
+    enum DataType_t {
+        FLAGS = 0x01,
+        INCOMPLETE_LIST_16BIT_SERVICE_IDS = 0x02,
+        COMPLETE_LIST_16BIT_SERVICE_IDS = 0x03,
+        INCOMPLETE_LIST_32BIT_SERVICE_IDS = 0x04,
+        COMPLETE_LIST_32BIT_SERVICE_IDS = 0x05,
+        INCOMPLETE_LIST_128BIT_SERVICE_IDS = 0x06,
+        COMPLETE_LIST_128BIT_SERVICE_IDS = 0x07,
+        SHORTENED_LOCAL_NAME = 0x08,
+        COMPLETE_LOCAL_NAME = 0x09,
+        TX_POWER_LEVEL = 0x0A,
+        DEVICE_ID = 0x10,
+        SLAVE_CONNECTION_INTERVAL_RANGE = 0x12,
+        LIST_128BIT_SOLICITATION_IDS = 0x15,
+        SERVICE_DATA = 0x16,
+        APPEARANCE = 0x19,
+        ADVERTISING_INTERVAL = 0x1A,
+        MANUFACTURER_SPECIFIC_DATA = 0xFF
+    };
+    typedef enum DataType_t DataType;
+
+    enum Flags_t {
+        LE_LIMITED_DISCOVERABLE = 0x01,
+        LE_GENERAL_DISCOVERABLE = 0x02,
+        BREDR_NOT_SUPPORTED = 0x04,
+        SIMULTANEOUS_LE_BREDR_C = 0x08,
+        SIMULTANEOUS_LE_BREDR_H = 0x10
+    };
+    typedef enum Flags_t Flags;
+
+    enum Appearance_t {
+        UNKNOWN = 0,
+        GENERIC_TAG = 512
+    };
+    typedef enum Appearance_t Appearance;
+
+    GapAdvertisingData() : _payloadLen(0), _appearance(UNKNOWN) {
+        memset(_payload, 0, sizeof(_payload));
+    }
+
+    ble_error_t addData(DataType_t advDataType, const uint8_t *payload, uint8_t len) {
+        uint8_t *field = findField(advDataType);
+        if (field) {
+            switch (advDataType) {
+                case INCOMPLETE_LIST_16BIT_SERVICE_IDS:
+                case COMPLETE_LIST_16BIT_SERVICE_IDS:
+                case INCOMPLETE_LIST_32BIT_SERVICE_IDS:
+                case COMPLETE_LIST_32BIT_SERVICE_IDS:
+                case INCOMPLETE_LIST_128BIT_SERVICE_IDS:
+                case COMPLETE_LIST_128BIT_SERVICE_IDS:
+                case LIST_128BIT_SOLICITATION_IDS:
+                    return appendToField(field, payload, len);
+                default:
+                    removeField(field);
+                    break;
+            }
+        }
+        if (_payloadLen + len + 2 > GAP_ADVERTISING_DATA_MAX_PAYLOAD) return BLE_ERROR_BUFFER_OVERFLOW;
+        _payload[_payloadLen++] = static_cast<uint8_t>(len + 1);
+        _payload[_payloadLen++] = static_cast<uint8_t>(advDataType);
+        memcpy(&_payload[_payloadLen], payload, len);
+        _payloadLen = static_cast<uint8_t>(_payloadLen + len);
+        return BLE_ERROR_NONE;
+    }
+
+    ble_error_t updateData(DataType_t advDataType, const uint8_t *payload, uint8_t len) {
+        uint8_t *field = findField(advDataType);
+        if (!field) return BLE_ERROR_UNSPECIFIED;
+        removeField(field);
+        return addData(advDataType, payload, len);
+    }
+
+    ble_error_t addAppearance(Appearance appearance = GENERIC_TAG) {
+        _appearance = appearance;
+        uint16_t value = static_cast<uint16_t>(appearance);
+        return addData(APPEARANCE, reinterpret_cast<const uint8_t *>(&value), 2);
+    }
+
+    ble_error_t addFlags(uint8_t flags = LE_GENERAL_DISCOVERABLE) {
+        return addData(FLAGS, &flags, 1);
+    }
+
+    ble_error_t addTxPower(int8_t txPower) {
+        return addData(TX_POWER_LEVEL, reinterpret_cast<const uint8_t *>(&txPower), 1);
+    }
+
+    void clear() {
+        memset(_payload, 0, sizeof(_payload));
+        _payloadLen = 0;
+    }
+
+    const uint8_t *getPayload() const {
+        return _payload;
+    }
+
+    uint8_t getPayloadLen() const {
+        return _payloadLen;
+    }
+
+    uint16_t getAppearance() const {
+        return static_cast<uint16_t>(_appearance);
+    }
+
+    /**
+     * Find a field in the payload.
+     * @return a pointer to the field length byte or NULL
+     */
+    const uint8_t *findField(DataType_t type) const {
+        for (uint8_t idx = 0; idx < _payloadLen; idx = static_cast<uint8_t>(idx + _payload[idx] + 1)) {
+            if (_payload[idx] == 0) break;
+            if (_payload[idx + 1] == type) return &_payload[idx];
+        }
+        return NULL;
+    }
+
+private:
+    uint8_t *findField(DataType_t type) {
+        return const_cast<uint8_t *>(static_cast<const GapAdvertisingData *>(this)->findField(type));
+    }
+
+    ble_error_t appendToField(uint8_t *field, const uint8_t *payload, uint8_t len) {
+        if (_payloadLen + len > GAP_ADVERTISING_DATA_MAX_PAYLOAD) return BLE_ERROR_BUFFER_OVERFLOW;
+        uint8_t *end = field + field[0] + 1;
+        memmove(end + len, end, static_cast<size_t>(&_payload[_payloadLen] - end));
+        memcpy(end, payload, len);
+        field[0] = static_cast<uint8_t>(field[0] + len);
+        _payloadLen = static_cast<uint8_t>(_payloadLen + len);
+        return BLE_ERROR_NONE;
+    }
+
+    void removeField(uint8_t *field) {
+        uint8_t size = static_cast<uint8_t>(field[0] + 1);
+        memmove(field, field + size, static_cast<size_t>(&_payload[_payloadLen] - (field + size)));
+        _payloadLen = static_cast<uint8_t>(_payloadLen - size);
+    }
+
+    uint8_t _payload[GAP_ADVERTISING_DATA_MAX_PAYLOAD];
+    uint8_t _payloadLen;
+    Appearance_t _appearance;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GAPADVERTISINGDATA_H
@@ -0,0 +1,97 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API advertising parameters.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GAPADVERTISINGPARAMS_H
+#define UBIRCH_MBED_BLE_SIM_GAPADVERTISINGPARAMS_H
+
+#include "blecommon.h"
+
+class GapAdvertisingParams {
+public:
+    static const unsigned GAP_ADV_PARAMS_INTERVAL_MIN = 0x0020;
+    static const unsigned GAP_ADV_PARAMS_INTERVAL_MIN_NONCON = 0x00A0;
+    static const unsigned GAP_ADV_PARAMS_INTERVAL_MAX = 0x4000;
+    static const unsigned GAP_ADV_PARAMS_TIMEOUT_MAX = 0x3FFF;
+
+    enum AdvertisingType_t {
+        ADV_CONNECTABLE_UNDIRECTED,
+        ADV_CONNECTABLE_DIRECTED,
+        ADV_SCANNABLE_UNDIRECTED,
+        ADV_NON_CONNECTABLE_UNDIRECTED
+    };
+    typedef enum AdvertisingType_t AdvertisingType;
+
+    GapAdvertisingParams(AdvertisingType_t advType = ADV_CONNECTABLE_UNDIRECTED,
+                         uint16_t interval = GAP_ADV_PARAMS_INTERVAL_MIN_NONCON, uint16_t timeout = 0)
+            : _advType(advType), _interval(interval), _timeout(timeout) {}
+
+    static uint16_t MSEC_TO_ADVERTISEMENT_DURATION_UNITS(uint32_t durationInMillis) {
+        return static_cast<uint16_t>((durationInMillis * 1000) / 625);
+    }
+
+    static uint16_t ADVERTISEMENT_DURATION_UNITS_TO_MS(uint16_t gapUnits) {
+        return static_cast<uint16_t>((gapUnits * 625) / 1000);
+    }
+
+    AdvertisingType_t getAdvertisingType() const {
+        return _advType;
+    }
+
+    /**
+     * @return the advertising interval in milliseconds
+     */
+    uint16_t getInterval() const {
+        return ADVERTISEMENT_DURATION_UNITS_TO_MS(_interval);
+    }
+
+    uint16_t getIntervalInADVUnits() const {
+        return _interval;
+    }
+
+    uint16_t getTimeout() const {
+        return _timeout;
+    }
+
+    void setAdvertisingType(AdvertisingType_t newAdvType) {
+        _advType = newAdvType;
+    }
+
+    /**
+     * @param newInterval the advertising interval in milliseconds
+     */
+    void setInterval(uint16_t newInterval) {
+        _interval = MSEC_TO_ADVERTISEMENT_DURATION_UNITS(newInterval);
+    }
+
+    void setTimeout(uint16_t newTimeout) {
+        _timeout = newTimeout;
+    }
+
+private:
+    AdvertisingType_t _advType;
+    uint16_t _interval;
+    uint16_t _timeout;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GAPADVERTISINGPARAMS_H
@@ -0,0 +1,82 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API GATT attribute.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GATTATTRIBUTE_H
+#define UBIRCH_MBED_BLE_SIM_GATTATTRIBUTE_H
+
+#include "UUID.h"
+
+class GattAttribute {
+public:
+    typedef ble::attribute_handle_t Handle_t;
+
+    static const Handle_t INVALID_HANDLE = 0x0000;
+
+    GattAttribute(const UUID &uuid, uint8_t *valuePtr = NULL, uint16_t len = 0, uint16_t maxLen = 0,
+                  bool hasVariableLen = true)
+            : _uuid(uuid), _valuePtr(valuePtr), _lenMax(maxLen), _len(len), _hasVariableLen(hasVariableLen),
+              _handle(INVALID_HANDLE) {}
+
+    Handle_t getHandle() const {
+        return _handle;
+    }
+
+    void setHandle(Handle_t id) {
+        _handle = id;
+    }
+
+    const UUID &getUUID() const {
+        return _uuid;
+    }
+
+    uint16_t getLength() const {
+        return _len;
+    }
+
+    uint16_t getMaxLength() const {
+        return _lenMax;
+    }
+
+    uint16_t *getLengthPtr() {
+        return &_len;
+    }
+
+    uint8_t *getValuePtr() {
+        return _valuePtr;
+    }
+
+    bool hasVariableLength() const {
+        return _hasVariableLen;
+    }
+
+private:
+    UUID _uuid;
+    uint8_t *_valuePtr;
+    uint16_t _lenMax;
+    uint16_t _len;
+    bool _hasVariableLen;
+    Handle_t _handle;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GATTATTRIBUTE_H
@@ -0,0 +1,88 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API GATT callback parameters.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GATTCALLBACKPARAMTYPES_H
+#define UBIRCH_MBED_BLE_SIM_GATTCALLBACKPARAMTYPES_H
+
+#include "GattAttribute.h"
+
+struct GattWriteCallbackParams {
+    enum WriteOp_t {
+        OP_INVALID = 0x00,
+        OP_WRITE_REQ = 0x01,
+        OP_WRITE_CMD = 0x02,
+        OP_SIGN_WRITE_CMD = 0x03,
+        OP_PREP_WRITE_REQ = 0x04,
+        OP_EXEC_WRITE_REQ_CANCEL = 0x05,
+        OP_EXEC_WRITE_REQ_NOW = 0x06
+    };
+
+    ble::connection_handle_t connHandle;
+    GattAttribute::Handle_t handle;
+    WriteOp_t writeOp;
+    uint16_t offset;
+    uint16_t len;
+    const uint8_t *data;
+};
+
+enum GattAuthCallbackReply_t {
+    AUTH_CALLBACK_REPLY_SUCCESS = 0x00,
+    AUTH_CALLBACK_REPLY_ATTERR_INVALID_HANDLE = 0x0101,
+    AUTH_CALLBACK_REPLY_ATTERR_READ_NOT_PERMITTED = 0x0102,
+    AUTH_CALLBACK_REPLY_ATTERR_WRITE_NOT_PERMITTED = 0x0103,
+    AUTH_CALLBACK_REPLY_ATTERR_INVALID_PDU = 0x0104,
+    AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_AUTHENTICATION = 0x0105,
+    AUTH_CALLBACK_REPLY_ATTERR_REQUEST_NOT_SUPPORTED = 0x0106,
+    AUTH_CALLBACK_REPLY_ATTERR_INVALID_OFFSET = 0x0107,
+    AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_AUTHORIZATION = 0x0108,
+    AUTH_CALLBACK_REPLY_ATTERR_PREPARE_QUEUE_FULL = 0x0109,
+    AUTH_CALLBACK_REPLY_ATTERR_ATTRIBUTE_NOT_FOUND = 0x010A,
+    AUTH_CALLBACK_REPLY_ATTERR_ATTRIBUTE_NOT_LONG = 0x010B,
+    AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_ENCRYPTION_KEY_SIZE = 0x010C,
+    AUTH_CALLBACK_REPLY_ATTERR_INVALID_ATT_VAL_LENGTH = 0x010D,
+    AUTH_CALLBACK_REPLY_ATTERR_UNLIKELY_ERROR = 0x010E,
+    AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_ENCRYPTION = 0x010F,
+    AUTH_CALLBACK_REPLY_ATTERR_UNSUPPORTED_GROUP_TYPE = 0x0110,
+    AUTH_CALLBACK_REPLY_ATTERR_INSUFFICIENT_RESOURCES = 0x0111
+};
+
+struct GattWriteAuthCallbackParams {
+    ble::connection_handle_t connHandle;
+    GattAttribute::Handle_t handle;
+    uint16_t offset;
+    uint16_t len;
+    const uint8_t *data;
+    GattAuthCallbackReply_t authorizationReply;
+};
+
+struct GattReadAuthCallbackParams {
+    ble::connection_handle_t connHandle;
+    GattAttribute::Handle_t handle;
+    uint16_t offset;
+    uint16_t len;
+    uint8_t *data;
+    GattAuthCallbackReply_t authorizationReply;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GATTCALLBACKPARAMTYPES_H
@@ -0,0 +1,147 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API GATT characteristic.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GATTCHARACTERISTIC_H
+#define UBIRCH_MBED_BLE_SIM_GATTCHARACTERISTIC_H
+
+#include "FunctionPointerWithContext.h"
+#include "GattAttribute.h"
+#include "GattCallbackParamTypes.h"
+#include "SecurityManager.h"
+
+class GattCharacteristic {
+public:
+    enum Properties_t {
+        BLE_GATT_CHAR_PROPERTIES_NONE = 0x00,
+        BLE_GATT_CHAR_PROPERTIES_BROADCAST = 0x01,
+        BLE_GATT_CHAR_PROPERTIES_READ = 0x02,
+        BLE_GATT_CHAR_PROPERTIES_WRITE_WITHOUT_RESPONSE = 0x04,
+        BLE_GATT_CHAR_PROPERTIES_WRITE = 0x08,
+        BLE_GATT_CHAR_PROPERTIES_NOTIFY = 0x10,
+        BLE_GATT_CHAR_PROPERTIES_INDICATE = 0x20,
+        BLE_GATT_CHAR_PROPERTIES_AUTHENTICATED_SIGNED_WRITES = 0x40,
+        BLE_GATT_CHAR_PROPERTIES_EXTENDED_PROPERTIES = 0x80
+    };
+
+    GattCharacteristic(const UUID &uuid, uint8_t *valuePtr = NULL, uint16_t len = 0, uint16_t maxLen = 0,
+                       uint8_t props = BLE_GATT_CHAR_PROPERTIES_NONE, GattAttribute *descriptors[] = NULL,
+                       unsigned numDescriptors = 0, bool hasVariableLen = true)
+            : _valueAttribute(uuid, valuePtr, len, maxLen, hasVariableLen), _properties(props),
+              _requiredSecurity(SecurityManager::SECURITY_MODE_ENCRYPTION_OPEN_LINK), _descriptors(descriptors),
+              _descriptorCount(numDescriptors), _enabledReadAuthorization(false), _enabledWriteAuthorization(false) {}
+
+    void requireSecurity(SecurityManager::SecurityMode_t securityMode) {
+        _requiredSecurity = securityMode;
+    }
+
+    SecurityManager::SecurityMode_t getRequiredSecurity() const {
+        return _requiredSecurity;
+    }
+
+    void setWriteAuthorizationCallback(void (*callback)(GattWriteAuthCallbackParams *)) {
+        _writeAuthorizationCallback = callback;
+        _enabledWriteAuthorization = true;
+    }
+
+    template<typename T>
+    void setWriteAuthorizationCallback(T *object, void (T::*member)(GattWriteAuthCallbackParams *)) {
+        _writeAuthorizationCallback = FunctionPointerWithContext<GattWriteAuthCallbackParams *>(object, member);
+        _enabledWriteAuthorization = true;
+    }
+
+    void setReadAuthorizationCallback(void (*callback)(GattReadAuthCallbackParams *)) {
+        _readAuthorizationCallback = callback;
+        _enabledReadAuthorization = true;
+    }
+
+    template<typename T>
+    void setReadAuthorizationCallback(T *object, void (T::*member)(GattReadAuthCallbackParams *)) {
+        _readAuthorizationCallback = FunctionPointerWithContext<GattReadAuthCallbackParams *>(object, member);
+        _enabledReadAuthorization = true;
+    }
+
+    GattAuthCallbackReply_t authorizeWrite(GattWriteAuthCallbackParams *params) {
+        if (!isWriteAuthorizationEnabled()) return AUTH_CALLBACK_REPLY_SUCCESS;
+        params->authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+        _writeAuthorizationCallback.call(params);
+        return params->authorizationReply;
+    }
+
+    GattAuthCallbackReply_t authorizeRead(GattReadAuthCallbackParams *params) {
+        if (!isReadAuthorizationEnabled()) return AUTH_CALLBACK_REPLY_SUCCESS;
+        params->authorizationReply = AUTH_CALLBACK_REPLY_SUCCESS;
+        _readAuthorizationCallback.call(params);
+        return params->authorizationReply;
+    }
+
+    GattAttribute &getValueAttribute() {
+        return _valueAttribute;
+    }
+
+    const GattAttribute &getValueAttribute() const {
+        return _valueAttribute;
+    }
+
+    GattAttribute::Handle_t getValueHandle() const {
+        return getValueAttribute().getHandle();
+    }
+
+    uint8_t getProperties() const {
+        return _properties;
+    }
+
+    bool isReadAuthorizationEnabled() const {
+        return _enabledReadAuthorization;
+    }
+
+    bool isWriteAuthorizationEnabled() const {
+        return _enabledWriteAuthorization;
+    }
+
+    uint8_t getDescriptorCount() const {
+        return static_cast<uint8_t>(_descriptorCount);
+    }
+
+    GattAttribute *getDescriptor(uint8_t index) {
+        return index < _descriptorCount ? _descriptors[index] : NULL;
+    }
+
+private:
+    GattAttribute _valueAttribute;
+    uint8_t _properties;
+    SecurityManager::SecurityMode_t _requiredSecurity;
+    GattAttribute **_descriptors;
+    unsigned _descriptorCount;
+    bool _enabledReadAuthorization;
+    bool _enabledWriteAuthorization;
+    FunctionPointerWithContext<GattReadAuthCallbackParams *> _readAuthorizationCallback;
+    FunctionPointerWithContext<GattWriteAuthCallbackParams *> _writeAuthorizationCallback;
+
+    // characteristics are registered by address, copying them is not supported
+    GattCharacteristic(const GattCharacteristic &);
+
+    GattCharacteristic &operator=(const GattCharacteristic &);
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GATTCHARACTERISTIC_H
@@ -0,0 +1,180 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API GattServer.
+ *
+ * Attribute values live in the simulated controller like they live in the
+ * softdevice on the target: the value pointer handed over when creating a
+ * characteristic is only used to initialize the attribute.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GATTSERVER_H
+#define UBIRCH_MBED_BLE_SIM_GATTSERVER_H
+
+#include "blecommon.h"
+#include "Gap.h"
+#include "GattService.h"
+#include "GattCallbackParamTypes.h"
+
+class BLESim;
+
+class GattServer {
+public:
+    /** Services and characteristic values the GATT table holds. */
+    static const unsigned MAX_SERVICES = 16;
+    static const unsigned MAX_ATTRIBUTES = 64;
+    /** The longest attribute value ATT allows. */
+    static const uint16_t MAX_VALUE_LENGTH = 512;
+
+    /**
+     * Definition of the general handler of GattServer related events.
+     */
+    struct EventHandler {
+        /**
+         * Called when the ATT MTU of a connection changed (after an MTU exchange).
+         * @param connectionHandle the connection whose MTU changed
+         * @param attMtuSize the new ATT MTU size
+         */
+        virtual void onAttMtuChange(ble::connection_handle_t connectionHandle, uint16_t attMtuSize) {
+            (void) connectionHandle;
+            (void) attMtuSize;
+        }
+
+    protected:
+        ~EventHandler() {}
+    };
+
+    typedef FunctionPointerWithContext<unsigned> DataSentCallback_t;
+    typedef CallChainOfFunctionPointersWithContext<unsigned> DataSentCallbackChain_t;
+    typedef FunctionPointerWithContext<const GattWriteCallbackParams *> DataWrittenCallback_t;
+    typedef CallChainOfFunctionPointersWithContext<const GattWriteCallbackParams *> DataWrittenCallbackChain_t;
+    typedef FunctionPointerWithContext<GattAttribute::Handle_t> EventCallback_t;
+
+    GattServer();
+
+    /**
+     * Assign the event handler, only one handler can be set at a time.
+     */
+    void setEventHandler(EventHandler *handler) {
+        eventHandler = handler;
+    }
+
+    ble_error_t addService(GattService &service);
+
+    ble_error_t read(GattAttribute::Handle_t attributeHandle, uint8_t *buffer, uint16_t *lengthP);
+
+    ble_error_t read(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, uint8_t *buffer,
+                     uint16_t *lengthP);
+
+    /**
+     * Update the value of an attribute and notify/indicate all subscribed peers.
+     */
+    ble_error_t write(GattAttribute::Handle_t attributeHandle, const uint8_t *value, uint16_t size,
+                      bool localOnly = false);
+
+    /**
+     * Update the value of an attribute and notify/indicate a single peer.
+     */
+    ble_error_t write(Gap::Handle_t connectionHandle, GattAttribute::Handle_t attributeHandle, const uint8_t *value,
+                      uint16_t size, bool localOnly = false);
+
+    ble_error_t areUpdatesEnabled(const GattCharacteristic &characteristic, bool *enabledP);
+
+    ble_error_t areUpdatesEnabled(Gap::Handle_t connectionHandle, const GattCharacteristic &characteristic,
+                                  bool *enabledP);
+
+    void onDataSent(const DataSentCallback_t &callback) {
+        dataSentCallChain.add(callback);
+    }
+
+    template<typename T>
+    void onDataSent(T *objPtr, void (T::*memberPtr)(unsigned count)) {
+        dataSentCallChain.add(objPtr, memberPtr);
+    }
+
+    DataSentCallbackChain_t &onDataSent() {
+        return dataSentCallChain;
+    }
+
+    void onDataWritten(const DataWrittenCallback_t &callback) {
+        dataWrittenCallChain.add(callback);
+    }
+
+    template<typename T>
+    void onDataWritten(T *objPtr, void (T::*memberPtr)(const GattWriteCallbackParams *context)) {
+        dataWrittenCallChain.add(objPtr, memberPtr);
+    }
+
+    DataWrittenCallbackChain_t &onDataWritten() {
+        return dataWrittenCallChain;
+    }
+
+    void onUpdatesEnabled(EventCallback_t callback) {
+        updatesEnabledCallback = callback;
+    }
+
+    void onUpdatesDisabled(EventCallback_t callback) {
+        updatesDisabledCallback = callback;
+    }
+
+    void onConfirmationReceived(EventCallback_t callback) {
+        confirmationReceivedCallback = callback;
+    }
+
+    /**
+     * Clear all services and callbacks (called on BLE shutdown).
+     */
+    ble_error_t reset();
+
+private:
+    friend class BLESim;
+
+    struct Attribute {
+        GattAttribute::Handle_t handle;
+        GattCharacteristic *characteristic;
+        uint8_t value[MAX_VALUE_LENGTH];
+        uint16_t maxLength;
+        uint16_t length;
+    };
+
+    struct Service {
+        UUID uuid;
+        GattAttribute::Handle_t handle;
+    };
+
+    Attribute *findAttribute(GattAttribute::Handle_t handle);
+
+    // a fixed table like the attribute table of the SoftDevice, so the stack never allocates
+    Service services[MAX_SERVICES];
+    unsigned serviceCount;
+    Attribute attributes[MAX_ATTRIBUTES];
+    unsigned attributeCount;
+    GattAttribute::Handle_t nextHandle;
+
+    DataSentCallbackChain_t dataSentCallChain;
+    DataWrittenCallbackChain_t dataWrittenCallChain;
+    EventCallback_t updatesEnabledCallback;
+    EventCallback_t updatesDisabledCallback;
+    EventCallback_t confirmationReceivedCallback;
+    EventHandler *eventHandler;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GATTSERVER_H
@@ -0,0 +1,63 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API GATT service.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_GATTSERVICE_H
+#define UBIRCH_MBED_BLE_SIM_GATTSERVICE_H
+
+#include "GattCharacteristic.h"
+
+class GattService {
+public:
+    GattService(const UUID &uuid, GattCharacteristic *characteristics[], unsigned numCharacteristics)
+            : _primaryServiceID(uuid), _characteristicCount(numCharacteristics), _characteristics(characteristics),
+              _handle(0) {}
+
+    const UUID &getUUID() const {
+        return _primaryServiceID;
+    }
+
+    uint16_t getHandle() const {
+        return _handle;
+    }
+
+    void setHandle(uint16_t handle) {
+        _handle = handle;
+    }
+
+    uint8_t getCharacteristicCount() const {
+        return static_cast<uint8_t>(_characteristicCount);
+    }
+
+    GattCharacteristic *getCharacteristic(uint8_t index) {
+        return index < _characteristicCount ? _characteristics[index] : NULL;
+    }
+
+private:
+    UUID _primaryServiceID;
+    unsigned _characteristicCount;
+    GattCharacteristic **_characteristics;
+    uint16_t _handle;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_GATTSERVICE_H
@@ -0,0 +1,69 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API security manager.
+ *
+ * The simulation does not model pairing, it only keeps the types and
+ * accepts the configuration calls.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_SECURITYMANAGER_H
+#define UBIRCH_MBED_BLE_SIM_SECURITYMANAGER_H
+
+#include "blecommon.h"
+
+class SecurityManager {
+public:
+    enum SecurityMode_t {
+        SECURITY_MODE_NO_ACCESS,
+        SECURITY_MODE_ENCRYPTION_OPEN_LINK,
+        SECURITY_MODE_ENCRYPTION_NO_MITM,
+        SECURITY_MODE_ENCRYPTION_WITH_MITM,
+        SECURITY_MODE_SIGNED_NO_MITM,
+        SECURITY_MODE_SIGNED_WITH_MITM
+    };
+
+    enum SecurityIOCapabilities_t {
+        IO_CAPS_DISPLAY_ONLY = 0x00,
+        IO_CAPS_DISPLAY_YESNO = 0x01,
+        IO_CAPS_KEYBOARD_ONLY = 0x02,
+        IO_CAPS_NONE = 0x03,
+        IO_CAPS_KEYBOARD_DISPLAY = 0x04
+    };
+
+    static const unsigned PASSKEY_LEN = 6;
+    typedef uint8_t Passkey_t[PASSKEY_LEN];
+
+    ble_error_t init(bool enableBonding = true, bool requireMITM = true,
+                     SecurityIOCapabilities_t iocaps = IO_CAPS_NONE, const Passkey_t passkey = NULL) {
+        (void) enableBonding;
+        (void) requireMITM;
+        (void) iocaps;
+        (void) passkey;
+        return BLE_ERROR_NONE;
+    }
+
+    ble_error_t purgeAllBondingState() {
+        return BLE_ERROR_NONE;
+    }
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_SECURITYMANAGER_H
@@ -0,0 +1,52 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API UART service definitions.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#include "UARTService.h"
+
+const uint8_t UARTServiceBaseUUID[UUID::LENGTH_OF_LONG_UUID] = {
+        0x6E, 0x40, 0x00, 0x00, 0xB5, 0xA3, 0xF3, 0x93,
+        0xE0, 0xA9, 0xE5, 0x0E, 0x24, 0xDC, 0xCA, 0x9E,
+};
+const uint16_t UARTServiceShortUUID = 0x0001;
+const uint16_t UARTServiceTXCharacteristicShortUUID = 0x0002;
+const uint16_t UARTServiceRXCharacteristicShortUUID = 0x0003;
+
+const uint8_t UARTServiceUUID[UUID::LENGTH_OF_LONG_UUID] = {
+        0x6E, 0x40, (uint8_t) (UARTServiceShortUUID >> 8), (uint8_t) (UARTServiceShortUUID & 0xFF), 0xB5, 0xA3,
+        0xF3, 0x93, 0xE0, 0xA9, 0xE5, 0x0E, 0x24, 0xDC, 0xCA, 0x9E,
+};
+const uint8_t UARTServiceUUID_reversed[UUID::LENGTH_OF_LONG_UUID] = {
+        0x9E, 0xCA, 0xDC, 0x24, 0x0E, 0xE5, 0xA9, 0xE0, 0x93, 0xF3, 0xA3, 0xB5,
+        (uint8_t) (UARTServiceShortUUID & 0xFF), (uint8_t) (UARTServiceShortUUID >> 8), 0x40, 0x6E
+};
+const uint8_t UARTServiceTXCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID] = {
+        0x6E, 0x40, (uint8_t) (UARTServiceTXCharacteristicShortUUID >> 8),
+        (uint8_t) (UARTServiceTXCharacteristicShortUUID & 0xFF), 0xB5, 0xA3,
+        0xF3, 0x93, 0xE0, 0xA9, 0xE5, 0x0E, 0x24, 0xDC, 0xCA, 0x9E,
+};
+const uint8_t UARTServiceRXCharacteristicUUID[UUID::LENGTH_OF_LONG_UUID] = {
+        0x6E, 0x40, (uint8_t) (UARTServiceRXCharacteristicShortUUID >> 8),
+        (uint8_t) (UARTServiceRXCharacteristicShortUUID & 0xFF), 0xB5, 0xA3,
+        0xF3, 0x93, 0xE0, 0xA9, 0xE5, 0x0E, 0x24, 0xDC, 0xCA, 0x9E,
+};
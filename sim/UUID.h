@@ -0,0 +1,142 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API UUID.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_UUID_H
+#define UBIRCH_MBED_BLE_SIM_UUID_H
+
+#include <cstdio>
+#include "blecommon.h"
+
+class UUID {
+public:
+    enum UUID_Type_t {
+        UUID_TYPE_SHORT = 0,
+        UUID_TYPE_LONG = 1
+    };
+
+    enum ByteOrder_t {
+        MSB,
+        LSB
+    };
+
+    typedef uint16_t ShortUUIDBytes_t;
+
+    static const unsigned LENGTH_OF_LONG_UUID = 16;
+    typedef uint8_t LongUUIDBytes_t[LENGTH_OF_LONG_UUID];
+
+    UUID() : type(UUID_TYPE_SHORT), shortUUID(0) {
+        memset(baseUUID, 0, sizeof(baseUUID));
+    }
+
+    UUID(ShortUUIDBytes_t _shortUUID) : type(UUID_TYPE_SHORT), shortUUID(_shortUUID) {
+        memset(baseUUID, 0, sizeof(baseUUID));
+    }
+
+    UUID(const LongUUIDBytes_t longUUID, ByteOrder_t order = MSB) : type(UUID_TYPE_LONG), shortUUID(0) {
+        setupLong(longUUID, order);
+    }
+
+    /**
+     * Parse a string representation (e.g. 6E400001-B5A3-F393-E0A9-E50E24DCCA9E).
+     */
+    UUID(const char *stringUUID) : type(UUID_TYPE_LONG), shortUUID(0) {
+        LongUUIDBytes_t bytes = {0};
+        unsigned index = 0;
+        int nibble = -1;
+        for (const char *p = stringUUID; *p && index < LENGTH_OF_LONG_UUID; p++) {
+            int v;
+            if (*p >= '0' && *p <= '9') v = *p - '0';
+            else if (*p >= 'a' && *p <= 'f') v = *p - 'a' + 10;
+            else if (*p >= 'A' && *p <= 'F') v = *p - 'A' + 10;
+            else continue;
+            if (nibble < 0) nibble = v;
+            else {
+                bytes[index++] = static_cast<uint8_t>((nibble << 4) | v);
+                nibble = -1;
+            }
+        }
+        setupLong(bytes, MSB);
+    }
+
+    void setupLong(const LongUUIDBytes_t longUUID, ByteOrder_t order = MSB) {
+        type = UUID_TYPE_LONG;
+        // like the mbed stack, long UUIDs are stored in little endian order
+        if (order == MSB) {
+            for (unsigned i = 0; i < LENGTH_OF_LONG_UUID; i++) baseUUID[i] = longUUID[LENGTH_OF_LONG_UUID - 1 - i];
+        } else {
+            memcpy(baseUUID, longUUID, LENGTH_OF_LONG_UUID);
+        }
+        shortUUID = static_cast<uint16_t>((baseUUID[13] << 8) | baseUUID[12]);
+    }
+
+    UUID_Type_t shortOrLong() const {
+        return type;
+    }
+
+    const uint8_t *getBaseUUID() const {
+        return type == UUID_TYPE_SHORT ? reinterpret_cast<const uint8_t *>(&shortUUID) : baseUUID;
+    }
+
+    ShortUUIDBytes_t getShortUUID() const {
+        return shortUUID;
+    }
+
+    uint8_t getLen() const {
+        return static_cast<uint8_t>(type == UUID_TYPE_SHORT ? sizeof(ShortUUIDBytes_t) : LENGTH_OF_LONG_UUID);
+    }
+
+    /**
+     * Format the UUID as string, the buffer needs to hold at least 37 bytes.
+     */
+    const char *toString(char *buffer) const {
+        if (type == UUID_TYPE_SHORT) {
+            sprintf(buffer, "%04X", shortUUID);
+        } else {
+            char *p = buffer;
+            for (int i = LENGTH_OF_LONG_UUID - 1; i >= 0; i--) {
+                p += sprintf(p, "%02X", baseUUID[i]);
+                if (i == 12 || i == 10 || i == 8 || i == 6) *p++ = '-';
+            }
+            *p = '\0';
+        }
+        return buffer;
+    }
+
+    bool operator==(const UUID &other) const {
+        if (type != other.type) return false;
+        if (type == UUID_TYPE_SHORT) return shortUUID == other.shortUUID;
+        return !memcmp(baseUUID, other.baseUUID, LENGTH_OF_LONG_UUID);
+    }
+
+    bool operator!=(const UUID &other) const {
+        return !(*this == other);
+    }
+
+private:
+    UUID_Type_t type;
+    LongUUIDBytes_t baseUUID;
+    ShortUUIDBytes_t shortUUID;
+};
+
+#endif //UBIRCH_MBED_BLE_SIM_UUID_H
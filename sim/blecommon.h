@@ -0,0 +1,140 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed BLE API common definitions.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_BLECOMMON_H
+#define UBIRCH_MBED_BLE_SIM_BLECOMMON_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+
+enum ble_error_t {
+    BLE_ERROR_NONE = 0,
+    BLE_ERROR_BUFFER_OVERFLOW = 1,
+    BLE_ERROR_NOT_IMPLEMENTED = 2,
+    BLE_ERROR_PARAM_OUT_OF_RANGE = 3,
+    BLE_ERROR_INVALID_PARAM = 4,
+    BLE_STACK_BUSY = 5,
+    BLE_ERROR_INVALID_STATE = 6,
+    BLE_ERROR_NO_MEM = 7,
+    BLE_ERROR_OPERATION_NOT_PERMITTED = 8,
+    BLE_ERROR_INITIALIZATION_INCOMPLETE = 9,
+    BLE_ERROR_ALREADY_INITIALIZED = 10,
+    BLE_ERROR_UNSPECIFIED = 11,
+    BLE_ERROR_INTERNAL_STACK_FAILURE = 12
+};
+
+namespace ble {
+typedef uint16_t connection_handle_t;
+typedef uint16_t attribute_handle_t;
+
+/**
+ * A physical layer (PHY) of a connection.
+ */
+struct phy_t {
+    enum type {
+        NONE = 0,
+        LE_1M = 1,
+        LE_2M = 2,
+        LE_CODED = 3
+    };
+
+    phy_t(type value = NONE) : _value(value) {}
+
+    type value() const {
+        return _value;
+    }
+
+private:
+    type _value;
+};
+
+/**
+ * A set of PHYs, used to tell the controller which ones to prefer.
+ */
+class phy_set_t {
+public:
+    static const uint8_t PHY_SET_1M = 0x01;
+    static const uint8_t PHY_SET_2M = 0x02;
+    static const uint8_t PHY_SET_CODED = 0x04;
+
+    phy_set_t() : _value(0) {}
+
+    phy_set_t(uint8_t value) : _value(value) {}
+
+    phy_set_t(bool phy_1m, bool phy_2m, bool phy_coded) : _value(0) {
+        set_1m(phy_1m);
+        set_2m(phy_2m);
+        set_coded(phy_coded);
+    }
+
+    void set_1m(bool enabled = true) {
+        set(PHY_SET_1M, enabled);
+    }
+
+    void set_2m(bool enabled = true) {
+        set(PHY_SET_2M, enabled);
+    }
+
+    void set_coded(bool enabled = true) {
+        set(PHY_SET_CODED, enabled);
+    }
+
+    bool get_1m() const {
+        return (_value & PHY_SET_1M) != 0;
+    }
+
+    bool get_2m() const {
+        return (_value & PHY_SET_2M) != 0;
+    }
+
+    bool get_coded() const {
+        return (_value & PHY_SET_CODED) != 0;
+    }
+
+    uint8_t value() const {
+        return _value;
+    }
+
+private:
+    void set(uint8_t phy, bool enabled) {
+        _value = static_cast<uint8_t>(enabled ? _value | phy : _value & ~phy);
+    }
+
+    uint8_t _value;
+};
+
+/**
+ * The coding of the LE coded PHY.
+ */
+struct coded_symbol_per_bit_t {
+    enum type {
+        UNDEFINED,
+        S2,
+        S8
+    };
+};
+}
+
+#endif //UBIRCH_MBED_BLE_SIM_BLECOMMON_H
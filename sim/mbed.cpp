@@ -0,0 +1,109 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed OS 5 wait and timer functions.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#include <ctime>
+#include <cerrno>
+#include "mbed.h"
+
+static uint64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint32_t us_ticker_read() {
+    return (uint32_t) now_us();
+}
+
+void wait_us(int us) {
+    struct timespec ts;
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000L;
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
+}
+
+void wait_ms(int ms) {
+    wait_us(ms * 1000);
+}
+
+void wait(float s) {
+    wait_us((int) (s * 1000000.0f));
+}
+
+namespace mbed {
+
+Timer::Timer() : _start(0), _time(0), _running(false) {}
+
+void Timer::start() {
+    if (!_running) {
+        _start = now_us();
+        _running = true;
+    }
+}
+
+void Timer::stop() {
+    _time += slicetime();
+    _running = false;
+}
+
+void Timer::reset() {
+    _start = now_us();
+    _time = 0;
+}
+
+float Timer::read() {
+    return (float) read_high_resolution_us() / 1000000.0f;
+}
+
+int Timer::read_ms() {
+    return (int) (read_high_resolution_us() / 1000);
+}
+
+int Timer::read_us() {
+    return (int) read_high_resolution_us();
+}
+
+uint64_t Timer::read_high_resolution_us() {
+    return _time + slicetime();
+}
+
+uint64_t Timer::slicetime() {
+    return _running ? now_us() - _start : 0;
+}
+
+events::EventQueue *mbed_event_queue() {
+    static events::EventQueue *queue;
+    static pthread_once_t once = PTHREAD_ONCE_INIT;
+    struct Shared {
+        static void create() {
+            queue = new events::EventQueue();
+            rtos::Thread *thread = new rtos::Thread(osPriorityNormal);
+            thread->start(callback(queue, &events::EventQueue::dispatch_forever));
+        }
+    };
+    pthread_once(&once, Shared::create);
+    return queue;
+}
+
+} // namespace mbed
@@ -0,0 +1,94 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed OS 5 umbrella header.
+ *
+ * Provides the subset of mbed used by the library: callbacks, RTOS
+ * primitives, the event queue, wait functions, timers and file handles.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_MBED_H
+#define UBIRCH_MBED_BLE_SIM_MBED_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+#include "Callback.h"
+#include "rtos.h"
+#include "mbed_events.h"
+#include "FileHandle.h"
+
+/** A definition a target port may replace, as in mbed_toolchain.h. */
+#define MBED_WEAK __attribute__((weak))
+
+/**
+ * Free running microsecond counter (wraps like the target ticker).
+ */
+uint32_t us_ticker_read();
+
+void wait(float s);
+
+void wait_ms(int ms);
+
+void wait_us(int us);
+
+namespace mbed {
+
+class Timer {
+public:
+    Timer();
+
+    void start();
+
+    void stop();
+
+    void reset();
+
+    float read();
+
+    int read_ms();
+
+    int read_us();
+
+    uint64_t read_high_resolution_us();
+
+private:
+    uint64_t slicetime();
+
+    uint64_t _start;
+    uint64_t _time;
+    bool _running;
+};
+
+/**
+ * The shared event queue, dispatched by its own thread like on the target
+ * (events.shared-dispatch-from-application = false).
+ */
+events::EventQueue *mbed_event_queue();
+
+} // namespace mbed
+
+using namespace mbed;
+using namespace std;
+
+#endif //UBIRCH_MBED_BLE_SIM_MBED_H
@@ -0,0 +1,212 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed OS 5 EventQueue.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#include <ctime>
+#include <cerrno>
+#include <cstdlib>
+#include "mbed_events.h"
+
+namespace events {
+
+enum SlotState {
+    SLOT_FREE = 0,
+    SLOT_ALLOCATED,
+    SLOT_PENDING,
+    SLOT_RUNNING,
+    SLOT_CANCELLED
+};
+
+struct EventQueue::Slot {
+    uint64_t target;
+    int32_t period;
+    uint32_t generation;
+    uint32_t state;
+    uint32_t sequence;
+    uint32_t reserved[2];
+    union {
+        uint64_t align;
+        unsigned char data[EVENTS_EVENT_PAYLOAD];
+    } payload;
+};
+
+static uint64_t now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000L;
+}
+
+EventQueue::EventQueue(unsigned size, unsigned char *buffer)
+        : _slots(NULL), _count(size / EVENTS_EVENT_SIZE), _owned(buffer == NULL), _break(false), _start(now_ms()),
+          _sequence(0) {
+    // the slot layout defines EVENTS_EVENT_SIZE, fail to compile if they drift apart
+    typedef char slot_size_matches_event_size[sizeof(Slot) == EVENTS_EVENT_SIZE ? 1 : -1];
+    (void) sizeof(slot_size_matches_event_size);
+
+    _slots = reinterpret_cast<Slot *>(_owned ? calloc(_count ? _count : 1, sizeof(Slot)) : buffer);
+    if (!_owned) memset(_slots, 0, _count * sizeof(Slot));
+
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&_cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+EventQueue::~EventQueue() {
+    for (unsigned i = 0; i < _count; i++) {
+        if (_slots[i].state != SLOT_FREE)
+            reinterpret_cast<Runnable *>(_slots[i].payload.data)->~Runnable();
+    }
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+    if (_owned) free(_slots);
+}
+
+EventQueue::Slot *EventQueue::alloc() {
+    Slot *slot = NULL;
+    pthread_mutex_lock(&_mutex);
+    for (unsigned i = 0; i < _count; i++) {
+        if (_slots[i].state == SLOT_FREE) {
+            slot = &_slots[i];
+            slot->state = SLOT_ALLOCATED;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&_mutex);
+    return slot;
+}
+
+void *EventQueue::payload(Slot *slot) {
+    return slot->payload.data;
+}
+
+int EventQueue::schedule(Slot *slot, int delay, int period) {
+    pthread_mutex_lock(&_mutex);
+    slot->target = now_ms() + (delay > 0 ? delay : 0);
+    slot->period = period;
+    slot->generation++;
+    slot->sequence = _sequence++;
+    slot->state = SLOT_PENDING;
+    int id = (int) ((slot->generation & 0x7fff) * _count + (slot - _slots)) + 1;
+    pthread_cond_broadcast(&_cond);
+    pthread_mutex_unlock(&_mutex);
+    return id;
+}
+
+void EventQueue::cancel(int id) {
+    if (id <= 0 || !_count) return;
+    unsigned index = (unsigned) (id - 1) % _count;
+    uint32_t generation = (uint32_t) (id - 1) / _count;
+
+    pthread_mutex_lock(&_mutex);
+    Slot &slot = _slots[index];
+    if ((slot.generation & 0x7fff) == generation) {
+        if (slot.state == SLOT_PENDING) {
+            reinterpret_cast<Runnable *>(slot.payload.data)->~Runnable();
+            slot.state = SLOT_FREE;
+        } else if (slot.state == SLOT_RUNNING) {
+            slot.state = SLOT_CANCELLED;
+        }
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+void EventQueue::break_dispatch() {
+    pthread_mutex_lock(&_mutex);
+    _break = true;
+    pthread_cond_broadcast(&_cond);
+    pthread_mutex_unlock(&_mutex);
+}
+
+unsigned EventQueue::tick() {
+    return (unsigned) (now_ms() - _start);
+}
+
+// a thread cancelled while waiting owns the mutex again, release it for the destructor
+static void unlock_on_cancel(void *mutex) {
+    pthread_mutex_unlock(static_cast<pthread_mutex_t *>(mutex));
+}
+
+void EventQueue::dispatch(int ms) {
+    const uint64_t deadline = ms < 0 ? UINT64_MAX : now_ms() + ms;
+
+    pthread_mutex_lock(&_mutex);
+    for (;;) {
+        if (_break) {
+            _break = false;
+            break;
+        }
+
+        // find the next due event, earliest target first, FIFO within the same target
+        Slot *next = NULL;
+        for (unsigned i = 0; i < _count; i++) {
+            Slot *s = &_slots[i];
+            if (s->state != SLOT_PENDING) continue;
+            if (!next || s->target < next->target ||
+                (s->target == next->target && (int32_t) (s->sequence - next->sequence) < 0))
+                next = s;
+        }
+
+        uint64_t now = now_ms();
+        if (next && next->target <= now) {
+            next->state = SLOT_RUNNING;
+            pthread_mutex_unlock(&_mutex);
+            reinterpret_cast<Runnable *>(next->payload.data)->run();
+            pthread_mutex_lock(&_mutex);
+            if (next->state == SLOT_RUNNING && next->period >= 0) {
+                next->target = now_ms() + next->period;
+                next->sequence = _sequence++;
+                next->state = SLOT_PENDING;
+            } else {
+                reinterpret_cast<Runnable *>(next->payload.data)->~Runnable();
+                next->state = SLOT_FREE;
+            }
+            continue;
+        }
+
+        if (now >= deadline) break;
+
+        uint64_t wakeup = next && next->target < deadline ? next->target : deadline;
+        pthread_cleanup_push(unlock_on_cancel, &_mutex);
+        if (wakeup == UINT64_MAX) {
+            pthread_cond_wait(&_cond, &_mutex);
+        } else {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            uint64_t delta = wakeup - now;
+            ts.tv_sec += delta / 1000;
+            ts.tv_nsec += (delta % 1000) * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec++;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&_cond, &_mutex, &ts);
+        }
+        pthread_cleanup_pop(0);
+    }
+    pthread_mutex_unlock(&_mutex);
+}
+
+} // namespace events
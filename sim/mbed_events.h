@@ -0,0 +1,175 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed OS 5 EventQueue.
+ *
+ * Like the mbed equeue, the queue works on a fixed buffer handed over (or
+ * allocated once) at construction. Each posted event takes one slot of
+ * EVENTS_EVENT_SIZE bytes, so posting fails the same way as on the target
+ * if the queue is sized too small.
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_MBED_EVENTS_H
+#define UBIRCH_MBED_BLE_SIM_MBED_EVENTS_H
+
+#include <new>
+#include <stdint.h>
+#include <pthread.h>
+#include "Callback.h"
+
+// size of the functor storage in one event slot
+#define EVENTS_EVENT_PAYLOAD 64
+// bytes one event takes in the queue buffer (slot header + payload)
+#define EVENTS_EVENT_SIZE (EVENTS_EVENT_PAYLOAD + 32)
+#define EVENTS_QUEUE_SIZE (32 * EVENTS_EVENT_SIZE)
+
+namespace events {
+
+class EventQueue {
+public:
+    explicit EventQueue(unsigned size = EVENTS_QUEUE_SIZE, unsigned char *buffer = NULL);
+
+    ~EventQueue();
+
+    /**
+     * Dispatch events for the given time, or forever if ms is negative.
+     */
+    void dispatch(int ms = -1);
+
+    void dispatch_forever() {
+        dispatch();
+    }
+
+    void break_dispatch();
+
+    /**
+     * Cancel a pending event. Has no effect if the event is already running.
+     */
+    void cancel(int id);
+
+    /**
+     * @return milliseconds since the queue was created
+     */
+    unsigned tick();
+
+    template<typename F>
+    int call(F f) {
+        return post(0, -1, f);
+    }
+
+    template<typename F, typename A0>
+    int call(F f, A0 a0) {
+        return post(0, -1, Bind1<F, A0>(f, a0));
+    }
+
+    template<typename T, typename R>
+    int call(T *obj, R (T::*method)()) {
+        return call(mbed::callback(obj, method));
+    }
+
+    template<typename T, typename R, typename A0>
+    int call(T *obj, R (T::*method)(A0), A0 a0) {
+        return call(mbed::callback(obj, method), a0);
+    }
+
+    template<typename F>
+    int call_in(int ms, F f) {
+        return post(ms, -1, f);
+    }
+
+    template<typename F, typename A0>
+    int call_in(int ms, F f, A0 a0) {
+        return post(ms, -1, Bind1<F, A0>(f, a0));
+    }
+
+    template<typename T, typename R>
+    int call_in(int ms, T *obj, R (T::*method)()) {
+        return call_in(ms, mbed::callback(obj, method));
+    }
+
+    template<typename F>
+    int call_every(int ms, F f) {
+        return post(ms, ms, f);
+    }
+
+    template<typename T, typename R>
+    int call_every(int ms, T *obj, R (T::*method)()) {
+        return call_every(ms, mbed::callback(obj, method));
+    }
+
+private:
+    struct Runnable {
+        virtual ~Runnable() {}
+
+        virtual void run() = 0;
+    };
+
+    template<typename F>
+    struct Functor : Runnable {
+        F f;
+
+        explicit Functor(const F &_f) : f(_f) {}
+
+        void run() { f(); }
+    };
+
+    template<typename F, typename A0>
+    struct Bind1 {
+        F f;
+        A0 a0;
+
+        Bind1(const F &_f, const A0 &_a0) : f(_f), a0(_a0) {}
+
+        void operator()() { f(a0); }
+    };
+
+    struct Slot;
+
+    template<typename F>
+    int post(int delay, int period, const F &f) {
+        if (sizeof(Functor<F>) > EVENTS_EVENT_PAYLOAD) return 0;
+        Slot *slot = alloc();
+        if (!slot) return 0;
+        new(payload(slot)) Functor<F>(f);
+        return schedule(slot, delay, period);
+    }
+
+    Slot *alloc();
+
+    void *payload(Slot *slot);
+
+    int schedule(Slot *slot, int delay, int period);
+
+    Slot *_slots;
+    unsigned _count;
+    bool _owned;
+    bool _break;
+    uint64_t _start;
+    uint32_t _sequence;
+    pthread_mutex_t _mutex;
+    pthread_cond_t _cond;
+};
+
+} // namespace events
+
+using namespace events;
+
+#endif //UBIRCH_MBED_BLE_SIM_MBED_EVENTS_H
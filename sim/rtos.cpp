@@ -0,0 +1,278 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed OS 5 RTOS API (backed by pthreads).
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#include <climits>
+#include <ctime>
+#include <cerrno>
+#include <sched.h>
+#include <unistd.h>
+#include "rtos.h"
+
+// calculate an absolute CLOCK_MONOTONIC deadline for condition waits
+static struct timespec deadline(uint32_t millisec) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += millisec / 1000;
+    ts.tv_nsec += (millisec % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+static void initMonotonicCond(pthread_cond_t *cond) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+namespace rtos {
+
+Mutex::Mutex() {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+Mutex::~Mutex() {
+    pthread_mutex_destroy(&_mutex);
+}
+
+osStatus Mutex::lock(uint32_t millisec) {
+    if (millisec == osWaitForever) return pthread_mutex_lock(&_mutex) ? osError : osOK;
+    struct timespec ts = deadline(millisec);
+    // pthread_mutex_timedlock uses CLOCK_REALTIME, poll instead to stay monotonic
+    while (pthread_mutex_trylock(&_mutex) == EBUSY) {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > ts.tv_sec || (now.tv_sec == ts.tv_sec && now.tv_nsec >= ts.tv_nsec))
+            return osErrorTimeout;
+        sched_yield();
+    }
+    return osOK;
+}
+
+bool Mutex::trylock() {
+    return pthread_mutex_trylock(&_mutex) == 0;
+}
+
+osStatus Mutex::unlock() {
+    return pthread_mutex_unlock(&_mutex) ? osError : osOK;
+}
+
+Semaphore::Semaphore(int32_t count, uint16_t max_count) : _count(count), _max(max_count) {
+    pthread_mutex_init(&_mutex, NULL);
+    initMonotonicCond(&_cond);
+}
+
+Semaphore::~Semaphore() {
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+}
+
+int32_t Semaphore::wait(uint32_t millisec) {
+    struct timespec ts = deadline(millisec == osWaitForever ? 0 : millisec);
+    pthread_mutex_lock(&_mutex);
+    while (_count == 0) {
+        if (millisec == 0) break;
+        if (millisec == osWaitForever) pthread_cond_wait(&_cond, &_mutex);
+        else if (pthread_cond_timedwait(&_cond, &_mutex, &ts) == ETIMEDOUT) break;
+    }
+    int32_t available = _count;
+    if (_count > 0) _count--;
+    pthread_mutex_unlock(&_mutex);
+    return available;
+}
+
+osStatus Semaphore::release() {
+    osStatus status = osOK;
+    pthread_mutex_lock(&_mutex);
+    if (_count < _max) {
+        _count++;
+        pthread_cond_signal(&_cond);
+    } else {
+        status = osErrorResource;
+    }
+    pthread_mutex_unlock(&_mutex);
+    return status;
+}
+
+EventFlags::EventFlags() : _flags(0) {
+    pthread_mutex_init(&_mutex, NULL);
+    initMonotonicCond(&_cond);
+}
+
+EventFlags::~EventFlags() {
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+}
+
+uint32_t EventFlags::set(uint32_t flags) {
+    pthread_mutex_lock(&_mutex);
+    _flags |= flags;
+    uint32_t result = _flags;
+    pthread_cond_broadcast(&_cond);
+    pthread_mutex_unlock(&_mutex);
+    return result;
+}
+
+uint32_t EventFlags::clear(uint32_t flags) {
+    pthread_mutex_lock(&_mutex);
+    uint32_t result = _flags;
+    _flags &= ~flags;
+    pthread_mutex_unlock(&_mutex);
+    return result;
+}
+
+uint32_t EventFlags::get() const {
+    pthread_mutex_lock(&_mutex);
+    uint32_t result = _flags;
+    pthread_mutex_unlock(&_mutex);
+    return result;
+}
+
+uint32_t EventFlags::wait_all(uint32_t flags, uint32_t millisec, bool clear) {
+    return wait(flags, millisec, clear, true);
+}
+
+uint32_t EventFlags::wait_any(uint32_t flags, uint32_t millisec, bool clear) {
+    return wait(flags, millisec, clear, false);
+}
+
+uint32_t EventFlags::wait(uint32_t flags, uint32_t millisec, bool clear, bool all) {
+    struct timespec ts = deadline(millisec == osWaitForever ? 0 : millisec);
+    pthread_mutex_lock(&_mutex);
+    for (;;) {
+        bool done = all ? ((_flags & flags) == flags) : ((_flags & flags) != 0);
+        if (done) break;
+        if (millisec == 0 ||
+            (millisec != osWaitForever && pthread_cond_timedwait(&_cond, &_mutex, &ts) == ETIMEDOUT)) {
+            pthread_mutex_unlock(&_mutex);
+            return osFlagsErrorTimeout;
+        }
+        if (millisec == osWaitForever) pthread_cond_wait(&_cond, &_mutex);
+    }
+    uint32_t result = _flags;
+    if (clear) _flags &= ~flags;
+    pthread_mutex_unlock(&_mutex);
+    return result;
+}
+
+Thread::Thread(osPriority priority, uint32_t stack_size, unsigned char *stack_mem, const char *name)
+        : _thread(), _started(false), _finished(false), _priority(priority), _stack_size(stack_size),
+          _name(name) {
+    (void) stack_mem;
+}
+
+Thread::~Thread() {
+    terminate();
+}
+
+void *Thread::_thunk(void *thread) {
+    Thread *t = static_cast<Thread *>(thread);
+    t->_task.call();
+    t->_finished = true;
+    return NULL;
+}
+
+osStatus Thread::start(mbed::Callback<void()> task) {
+    if (_started) return osErrorParameter;
+    _task = task;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    // host threads need more stack than the target, never go below the system minimum
+    size_t stack = _stack_size < (size_t) PTHREAD_STACK_MIN ? (size_t) PTHREAD_STACK_MIN : _stack_size;
+    pthread_attr_setstacksize(&attr, stack * 4);
+    int result = pthread_create(&_thread, &attr, &Thread::_thunk, this);
+    pthread_attr_destroy(&attr);
+    if (result) return osErrorNoMemory;
+
+    _started = true;
+    return osOK;
+}
+
+osStatus Thread::join() {
+    if (!_started) return osOK;
+    if (pthread_equal(_thread, pthread_self())) return osErrorResource;
+    pthread_join(_thread, NULL);
+    _started = false;
+    return osOK;
+}
+
+osStatus Thread::terminate() {
+    if (!_started) return osOK;
+    if (!_finished) pthread_cancel(_thread);
+    return join();
+}
+
+osPriority Thread::get_priority() {
+    return _priority;
+}
+
+osStatus Thread::set_priority(osPriority priority) {
+    _priority = priority;
+    return osOK;
+}
+
+uint32_t Thread::stack_size() {
+    return _stack_size;
+}
+
+const char *Thread::get_name() {
+    return _name;
+}
+
+osStatus Thread::wait(uint32_t millisec) {
+    struct timespec ts;
+    ts.tv_sec = millisec / 1000;
+    ts.tv_nsec = (millisec % 1000) * 1000000L;
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
+    return osOK;
+}
+
+osStatus Thread::yield() {
+    sched_yield();
+    return osOK;
+}
+
+namespace Kernel {
+static uint64_t monotonic_ms() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000 + now.tv_nsec / 1000000L;
+}
+
+uint64_t get_ms_count() {
+    static const uint64_t boot = monotonic_ms();
+    return monotonic_ms() - boot;
+}
+}
+
+} // namespace rtos
@@ -0,0 +1,177 @@
+/*!
+ * @file
+ * @brief Host stand-in for the mbed OS 5 RTOS API (backed by pthreads).
+ *
+ * @author ubirch GmbH
+ * @date   2026-10-17
+ *
+ * @copyright &copy; 2026 ubirch GmbH (https://ubirch.com)
+ *
+ * @section LICENSE
+ * ```
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ * ```
+ */
+#ifndef UBIRCH_MBED_BLE_SIM_RTOS_H
+#define UBIRCH_MBED_BLE_SIM_RTOS_H
+
+#include <stdint.h>
+#include <pthread.h>
+#include "Callback.h"
+
+typedef enum {
+    osOK = 0,
+    osError = -1,
+    osErrorTimeout = -2,
+    osErrorResource = -3,
+    osErrorParameter = -4,
+    osErrorNoMemory = -5
+} osStatus;
+
+typedef enum {
+    osPriorityNone = 0,
+    osPriorityIdle = 1,
+    osPriorityLow = 8,
+    osPriorityBelowNormal = 16,
+    osPriorityNormal = 24,
+    osPriorityAboveNormal = 32,
+    osPriorityHigh = 40,
+    osPriorityRealtime = 48,
+    osPriorityISR = 56
+} osPriority;
+
+#define osWaitForever 0xFFFFFFFFU
+
+#ifndef OS_STACK_SIZE
+#define OS_STACK_SIZE 4096
+#endif
+
+namespace rtos {
+
+class Mutex {
+public:
+    Mutex();
+
+    ~Mutex();
+
+    osStatus lock(uint32_t millisec = osWaitForever);
+
+    bool trylock();
+
+    osStatus unlock();
+
+private:
+    pthread_mutex_t _mutex;
+};
+
+class Semaphore {
+public:
+    explicit Semaphore(int32_t count = 0, uint16_t max_count = 0xffff);
+
+    ~Semaphore();
+
+    /**
+     * Wait until a token is available.
+     * @return the number of tokens available before taking one, 0 on timeout
+     */
+    int32_t wait(uint32_t millisec = osWaitForever);
+
+    osStatus release();
+
+private:
+    pthread_mutex_t _mutex;
+    pthread_cond_t _cond;
+    int32_t _count;
+    uint16_t _max;
+};
+
+class EventFlags {
+public:
+    EventFlags();
+
+    ~EventFlags();
+
+    uint32_t set(uint32_t flags);
+
+    uint32_t clear(uint32_t flags = 0x7fffffff);
+
+    uint32_t get() const;
+
+    /**
+     * Wait for all/any of the flags.
+     * @return the flags before clearing, or osFlagsErrorTimeout
+     */
+    uint32_t wait_all(uint32_t flags = 0, uint32_t millisec = osWaitForever, bool clear = true);
+
+    uint32_t wait_any(uint32_t flags = 0, uint32_t millisec = osWaitForever, bool clear = true);
+
+private:
+    uint32_t wait(uint32_t flags, uint32_t millisec, bool clear, bool all);
+
+    mutable pthread_mutex_t _mutex;
+    pthread_cond_t _cond;
+    uint32_t _flags;
+};
+
+class Thread {
+public:
+    explicit Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = OS_STACK_SIZE,
+                    unsigned char *stack_mem = NULL, const char *name = NULL);
+
+    ~Thread();
+
+    osStatus start(mbed::Callback<void()> task);
+
+    osStatus join();
+
+    osStatus terminate();
+
+    osPriority get_priority();
+
+    osStatus set_priority(osPriority priority);
+
+    uint32_t stack_size();
+
+    const char *get_name();
+
+    static osStatus wait(uint32_t millisec);
+
+    static osStatus yield();
+
+private:
+    static void *_thunk(void *thread);
+
+    mbed::Callback<void()> _task;
+    pthread_t _thread;
+    bool _started;
+    bool _finished;
+    osPriority _priority;
+    uint32_t _stack_size;
+    const char *_name;
+};
+
+namespace Kernel {
+/**
+ * Milliseconds since the simulated kernel started.
+ */
+uint64_t get_ms_count();
+}
+
+} // namespace rtos
+
+#define osFlagsError          0x80000000U
+#define osFlagsErrorTimeout   0xFFFFFFFEU
+
+using namespace rtos;
+
+#endif //UBIRCH_MBED_BLE_SIM_RTOS_H